@@ -216,6 +216,7 @@ AnalogAudioView::AnalogAudioView(
                   &options_modulation,
                   &field_volume,
                   &text_ctcss,
+                  &text_rds,
                   &record_view,
                   &waterfall});
 
@@ -360,10 +361,11 @@ void AnalogAudioView::on_baseband_bandwidth_changed(uint32_t bandwidth_hz) {
 }
 
 void AnalogAudioView::on_modulation_changed(ReceiverModel::Mode modulation) {
-    baseband::spectrum_streaming_stop();
+    // The new image needs the palette again, and the old one's rows are gone.
+    waterfall.stop();
     update_modulation(modulation);
     on_show_options_modulation();
-    baseband::spectrum_streaming_start();
+    waterfall.start();
 }
 
 void AnalogAudioView::remove_options_widget() {
@@ -421,36 +423,45 @@ void AnalogAudioView::on_show_options_modulation() {
             widget = std::make_unique<AMOptionsView>(this, options_view_rect, Theme::getInstance()->option_active);
             waterfall.show_audio_spectrum_view(false);
             text_ctcss.hidden(true);
+            text_rds.hidden(true);
             break;
 
         case ReceiverModel::Mode::NarrowbandFMAudio:
             widget = std::make_unique<NBFMOptionsView>(nbfm_view_rect, Theme::getInstance()->option_active);
             waterfall.show_audio_spectrum_view(false);
             text_ctcss.hidden(false);
+            text_rds.hidden(true);
             break;
 
         case ReceiverModel::Mode::WidebandFMAudio:
-            widget = std::make_unique<WFMOptionsView>(options_view_rect, Theme::getInstance()->option_active);
+            widget = std::make_unique<WFMOptionsView>(wfm_view_rect, Theme::getInstance()->option_active);
             waterfall.show_audio_spectrum_view(true);
             text_ctcss.hidden(true);
+            text_rds.hidden(false);
+            stereo = false;
+            ps_name.reset();
+            update_rds();
             break;
 
         case ReceiverModel::Mode::WFMAudioAMApt:
             widget = std::make_unique<WFMAMAptOptionsView>(options_view_rect, Theme::getInstance()->option_active);
             waterfall.show_audio_spectrum_view(true);
             text_ctcss.hidden(true);
+            text_rds.hidden(true);
             break;
 
         case ReceiverModel::Mode::AMAudioFMApt:
             widget = std::make_unique<AMFMAptOptionsView>(this, options_view_rect, Theme::getInstance()->option_active);
             waterfall.show_audio_spectrum_view(false);
             text_ctcss.hidden(true);
+            text_rds.hidden(true);
             break;
 
         case ReceiverModel::Mode::SpectrumAnalysis:
             widget = std::make_unique<SPECOptionsView>(this, nbfm_view_rect, Theme::getInstance()->option_active);
             waterfall.show_audio_spectrum_view(false);
             text_ctcss.hidden(true);
+            text_rds.hidden(true);
             break;
 
         default:
@@ -546,8 +557,15 @@ void AnalogAudioView::update_modulation(ReceiverModel::Mode modulation) {
     }
 }
 
-void AnalogAudioView::handle_coded_squelch(uint32_t value) {
-    text_ctcss.set(tone_key_string_by_value(value, text_ctcss.parent_rect().width() / 8));
+void AnalogAudioView::handle_coded_squelch(const CodedSquelchMessage& message) {
+    text_ctcss.set(coded_squelch_string(message, text_ctcss.parent_rect().width() / 8));
+}
+
+void AnalogAudioView::update_rds() {
+    std::string s = stereo ? "ST " : "   ";
+    if (ps_name.pi_code() != 0)
+        s += to_string_hex(ps_name.pi_code(), 4) + " " + ps_name.name();
+    text_rds.set(s);
 }
 
 void AnalogAudioView::on_freqchg(int64_t freq) {
@@ -32,6 +32,7 @@
 #include "app_settings.hpp"
 #include "radio_state.hpp"
 #include "tone_key.hpp"
+#include "rds.hpp"
 
 namespace ui {
 
@@ -246,6 +247,7 @@ class AnalogAudioView : public View {
 
     const Rect options_view_rect{0 * 8, 1 * 16, screen_width, 1 * 16};
     const Rect nbfm_view_rect{0 * 8, 1 * 16, 18 * 8, 1 * 16};
+    const Rect wfm_view_rect{0 * 8, 1 * 16, 8 * 8, 1 * 16};
 
     size_t spec_bw_index = 0;
     uint32_t spec_bw = 20000000;
@@ -289,6 +291,14 @@ class AnalogAudioView : public View {
         {16 * 8, 1 * 16, 14 * 8, 1 * 16},
         ""};
 
+    // Stereo indicator, PI code and programme service name in WFM.
+    Text text_rds{
+        {9 * 8, 1 * 16, 17 * 8, 1 * 16},
+        ""};
+
+    bool stereo{false};
+    rds::PSNameDecoder ps_name{};
+
     std::unique_ptr<Widget> options_widget{};
 
     RecordView record_view{
@@ -314,7 +324,8 @@ class AnalogAudioView : public View {
 
     void update_modulation(ReceiverModel::Mode modulation);
 
-    void handle_coded_squelch(uint32_t value);
+    void handle_coded_squelch(const CodedSquelchMessage& message);
+    void update_rds();
 
     void on_freqchg(int64_t freq);
 
@@ -322,7 +333,21 @@ class AnalogAudioView : public View {
         Message::ID::CodedSquelch,
         [this](const Message* p) {
             const auto message = *reinterpret_cast<const CodedSquelchMessage*>(p);
-            this->handle_coded_squelch(message.value);
+            this->handle_coded_squelch(message);
+        }};
+
+    MessageHandlerRegistration message_handler_stereo_pilot{
+        Message::ID::StereoPilot,
+        [this](const Message* p) {
+            this->stereo = reinterpret_cast<const StereoPilotMessage*>(p)->locked;
+            this->update_rds();
+        }};
+
+    MessageHandlerRegistration message_handler_rds_group{
+        Message::ID::RDSGroup,
+        [this](const Message* p) {
+            if (this->ps_name.feed(*reinterpret_cast<const RDSGroupMessage*>(p)))
+                this->update_rds();
         }};
 
     MessageHandlerRegistration message_handler_freqchg{
@@ -53,26 +53,27 @@ void RecentEntriesTable<AircraftRecentEntries>::draw(
     Painter& painter,
     const Style& style) {
     Color target_color;
-    std::string entry_string;
+    FixedString<40> entry_string;
 
     switch (entry.state) {
         case ADSBAgeState::Invalid:
         case ADSBAgeState::Current:
-            entry_string = "";
             target_color = Theme::getInstance()->fg_green->foreground;
             break;
         case ADSBAgeState::Recent:
-            entry_string = STR_COLOR_LIGHT_GREY;
+            entry_string.append(STR_COLOR_LIGHT_GREY);
             target_color = Theme::getInstance()->fg_light->foreground;
             break;
         default:
-            entry_string = STR_COLOR_DARK_GREY;
+            entry_string.append(STR_COLOR_DARK_GREY);
             target_color = Theme::getInstance()->fg_medium->foreground;
     };
 
-    entry_string +=
-        (entry.callsign.empty() ? entry.icao_str + "   " : entry.callsign + " ") +
-        to_string_dec_uint((unsigned int)(entry.pos.altitude / 100), 4);
+    if (entry.callsign.empty())
+        entry_string.append(entry.icao_str).append("   ");
+    else
+        entry_string.append(entry.callsign).append(' ');
+    entry_string.append_dec_uint((unsigned int)(entry.pos.altitude / 100), 4);
 
     if (entry.velo.type == SPD_IAS && entry.pos.alt_valid) {  // IAS can be converted to TAS
         // It is generally accepted that for every thousand feet of altitude,
@@ -81,23 +82,22 @@ void RecentEntriesTable<AircraftRecentEntries>::draw(
         // tas = entry.velo.speed + (float)entry.pos.altitude / 1000.0 * 0.02 * entry.velo.speed;
         unsigned int tas = entry.velo.speed + entry.pos.altitude * 2 * entry.velo.speed / 100000;
 
-        entry_string +=
-            to_string_dec_uint(tas, 4) + '*' +
-            to_string_dec_uint((unsigned int)(entry.amp >> 9), 3);
+        entry_string.append_dec_uint(tas, 4).append('*').append_dec_uint((unsigned int)(entry.amp >> 9), 3);
     } else {
-        entry_string +=
-            to_string_dec_uint((unsigned int)entry.velo.speed, 4) +
-            to_string_dec_uint((unsigned int)(entry.amp >> 9), 4);
+        entry_string.append_dec_uint((unsigned int)entry.velo.speed, 4).append_dec_uint((unsigned int)(entry.amp >> 9), 4);
     }
 
-    entry_string += " " +
-                    (entry.hits <= 999 ? to_string_dec_uint(entry.hits, 3) + " " : "1k+ ") +
-                    to_string_dec_uint(entry.age, 4);
+    entry_string.append(' ');
+    if (entry.hits <= 999)
+        entry_string.append_dec_uint(entry.hits, 3).append(' ');
+    else
+        entry_string.append("1k+ ");
+    entry_string.append_dec_uint(entry.age, 4);
 
     painter.draw_string(
         target_rect.location(),
         style,
-        entry_string);
+        entry_string.view());
 
     if (entry.pos.pos_valid)
         painter.draw_bitmap(target_rect.location() + Point(8 * 8, 0),
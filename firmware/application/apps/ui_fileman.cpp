@@ -62,22 +62,6 @@ std::string truncate(const fs::path& path, size_t max_length) {
     return ::truncate(path.string(), max_length);
 }
 
-// Inserts the entry into the entry list sorted directories first then by file name.
-void insert_sorted(std::list<fileman_entry>& entries, fileman_entry&& entry) {
-    auto it = std::lower_bound(
-        std::begin(entries), std::end(entries), entry,
-        [](const fileman_entry& lhs, const fileman_entry& rhs) {
-            if (lhs.is_directory && !rhs.is_directory)
-                return true;
-            else if (!lhs.is_directory && rhs.is_directory)
-                return false;
-            else
-                return lhs.path < rhs.path;
-        });
-
-    entries.insert(it, std::move(entry));
-}
-
 // Returns the partner file path or an empty path if no partner is found.
 fs::path get_partner_file(fs::path path) {
     if (fs::is_directory(path))
@@ -147,108 +131,138 @@ namespace ui {
 
 /* FileManBaseView ***********************************************************/
 
-void FileManBaseView::load_directory_contents_unordered(const fs::path& dir_path, size_t file_cnt) {
-    current_path = dir_path;
-    entry_list.clear();
-    menu_view.clear();
-    auto filtering = !extension_filter.empty();
-    bool cxx_file = path_iequal(cxx_ext, extension_filter);
+bool FileManBaseView::listing_accepts(const fs::directory_entry& entry) const {
+    // Hide files starting with '.' (hidden / tmp).
+    if (!show_hidden_files && is_hidden_file(entry.path()))
+        return false;
 
-    text_current.set(dir_path.empty() ? "(sd root)" : truncate(dir_path, 24));
+    // Too long for a listing record, leave it out of the count as well.
+    if (entry.path().string().size() > FileListing::max_name_length)
+        return false;
 
-    nb_pages = 1 + (file_cnt / items_per_page);
-    size_t start = pagination * items_per_page;
-    size_t stop = start + items_per_page;
-    if (file_cnt < stop) stop = file_cnt;
-    if (start > file_cnt) start = 0;  // shouldn't hapen but check against it won't hurt
+    if (fs::is_regular_file(entry.status())) {
+        if (extension_filter.empty())
+            return true;
+        return path_iequal(entry.path().extension(), extension_filter) ||
+               (path_iequal(cxx_ext, extension_filter) && is_cxx_capture_file(entry.path()));
+    }
 
-    size_t curr = 0;
+    return fs::is_directory(entry.status());
+}
 
-    for (const auto& entry : fs::directory_iterator(dir_path, u"*")) {
-        if (entry_list.size() >= items_per_page) {
-            break;
-        }
-        // Hide files starting with '.' (hidden / tmp).
-        if (!show_hidden_files && is_hidden_file(entry.path()))
+FileManBaseView::listing_cache_t& FileManBaseView::get_listing(const fs::path& dir_path) {
+    const auto stamp = dir_path.empty() ? FATTimestamp{} : file_created_date(dir_path);
+    auto& cache = listing_cache;
+
+    if (cache.valid &&
+        cache.path == dir_path &&
+        cache.filter == extension_filter &&
+        cache.show_hidden == show_hidden_files &&
+        cache.stamp.FAT_date == stamp.FAT_date &&
+        cache.stamp.FAT_time == stamp.FAT_time)
+        return cache;
+
+    cache.path = dir_path;
+    cache.filter = extension_filter;
+    cache.show_hidden = show_hidden_files;
+    cache.stamp = stamp;
+    build_listing(cache);
+    return cache;
+}
+
+// Enumerates the directory once: the entries are kept and sorted if they
+// fit, otherwise only counted.
+void FileManBaseView::build_listing(listing_cache_t& cache) {
+    cache.listing.clear();
+    cache.page_starts.clear();
+    cache.last_page_start = 0;
+    cache.paged = false;
+    cache.count = 0;
+
+    for (const auto& entry : fs::directory_iterator(cache.path, u"*")) {
+        if (!listing_accepts(entry))
             continue;
 
-        if (fs::is_regular_file(entry.status())) {
-            if (!filtering || path_iequal(entry.path().extension(), extension_filter) || (cxx_file && is_cxx_capture_file(entry.path()))) {
-                curr++;
-                if (curr >= start) insert_sorted(entry_list, {entry.path().string(), (uint32_t)entry.size(), false});
+        if (!cache.paged) {
+            auto is_directory = fs::is_directory(entry.status());
+            if (!cache.listing.add(entry.path().string(), is_directory ? 0 : (uint32_t)entry.size(), is_directory) &&
+                cache.listing.overflowed()) {
+                cache.paged = true;
+                cache.listing.clear();
             }
-
-        } else if (fs::is_directory(entry.status())) {
-            curr++;
-            if (curr >= start) insert_sorted(entry_list, {entry.path().string(), 0, true});
         }
-    }
-
-    // Add "parent" directory if not at the root.
-    if (!dir_path.empty() && pagination == 0)
-        entry_list.insert(entry_list.begin(), {parent_dir_path.string(), 0, true});
 
-    // add next page
-    if (file_cnt > start + items_per_page) {
-        entry_list.push_back({str_next, (uint32_t)pagination + 1, true});
+        cache.count++;
     }
 
-    // add prev page
-    if (pagination > 0) {
-        entry_list.insert(entry_list.begin(), {str_back, (uint32_t)pagination - 1, true});
-    }
+    if (cache.paged)
+        cache.listing.clear();
+    else
+        cache.listing.sort();
+
+    cache.valid = true;
 }
 
-int FileManBaseView::file_count_filtered(const fs::path& directory) {
-    int count{0};
-    auto filtering = !extension_filter.empty();
-    bool cxx_file = path_iequal(cxx_ext, extension_filter);
+// Selects one page of a directory too big to list, one pass over the
+// directory per page from the nearest page whose start is known.
+void FileManBaseView::load_paged_entries(listing_cache_t& cache, size_t page) {
+    const auto start = cache.page_starts.nearest(page);
+    ListingKey after = start.second ? *start.second : ListingKey{};
 
-    for (auto& entry : std::filesystem::directory_iterator(directory, (const TCHAR*)u"*")) {
-        if (fs::is_regular_file(entry.status())) {
-            if (!filtering || path_iequal(entry.path().extension(), extension_filter) || (cxx_file && is_cxx_capture_file(entry.path())))
-                ++count;
-        } else
-            ++count;
+    for (size_t p = start.first;; p++) {
+        PageSelector selector{items_per_page, p ? &after : nullptr};
+        for (const auto& entry : fs::directory_iterator(cache.path, u"*")) {
+            if (!listing_accepts(entry))
+                continue;
+            auto is_directory = fs::is_directory(entry.status());
+            selector.offer(entry.path().string(), is_directory ? 0 : (uint32_t)entry.size(), is_directory);
+        }
+
+        const bool last = !selector.full();
+
+        // Came up short: the directory changed behind our back.
+        if (last && (p + 1) * items_per_page < cache.count)
+            cache.valid = false;
+
+        if (!last && p + 1 > cache.last_page_start) {
+            cache.page_starts.record(p + 1, selector.last_key());
+            cache.last_page_start = p + 1;
+        }
+
+        if (p == page) {
+            for (const auto& item : selector.items())
+                entry_list.push_back({item.name, item.size, item.is_directory});
+            return;
+        }
+
+        if (last)
+            return;
+        after = selector.last_key();
     }
-    return count;
+}
+
+void FileManBaseView::invalidate_listings() {
+    listing_cache.valid = false;
+    listing_cache.listing.clear();
+    listing_cache.page_starts.clear();
 }
 
 void FileManBaseView::load_directory_contents(const fs::path& dir_path) {
-    size_t file_cnt = file_count_filtered(dir_path);
-    if (file_cnt >= max_items_loaded) {
-        load_directory_contents_unordered(dir_path, file_cnt);
-        return;
-    }
     current_path = dir_path;
     entry_list.clear();
     menu_view.clear();
-    auto filtering = !extension_filter.empty();
-    bool cxx_file = path_iequal(cxx_ext, extension_filter);
 
     text_current.set(dir_path.empty() ? "(sd root)" : truncate(dir_path, 24));
 
-    // Collect all entries first
-    std::list<fileman_entry> all_entries;
-    for (const auto& entry : fs::directory_iterator(dir_path, u"*")) {
-        // Hide files starting with '.' (hidden / tmp).
-        if (!show_hidden_files && is_hidden_file(entry.path()))
-            continue;
-
-        if (fs::is_regular_file(entry.status())) {
-            if (!filtering || path_iequal(entry.path().extension(), extension_filter) || (cxx_file && is_cxx_capture_file(entry.path())))
-                insert_sorted(all_entries, {entry.path().string(), (uint32_t)entry.size(), false});
-        } else if (fs::is_directory(entry.status())) {
-            insert_sorted(all_entries, {entry.path().string(), 0, true});
-        }
-    }
+    auto& cache = get_listing(dir_path);
 
     // Calculate pagination
-    nb_pages = (all_entries.size() + items_per_page - 1) / items_per_page;
-    if (nb_pages == 0) nb_pages = 1;
+    nb_pages = std::max<size_t>(1, (cache.count + items_per_page - 1) / items_per_page);
+    if (pagination >= nb_pages)
+        pagination = nb_pages - 1;
 
     size_t start_idx = pagination * items_per_page;
-    size_t end_idx = std::min(start_idx + items_per_page, all_entries.size());
+    size_t end_idx = std::min(start_idx + items_per_page, cache.count);
 
     // Add "parent" directory if not at the root and on first page
     if (!dir_path.empty() && pagination == 0) {
@@ -261,15 +275,17 @@ void FileManBaseView::load_directory_contents(const fs::path& dir_path) {
     }
 
     // Add entries for current page
-    auto it = all_entries.begin();
-    std::advance(it, start_idx);
-
-    for (size_t i = start_idx; i < end_idx && it != all_entries.end(); i++, ++it) {
-        entry_list.push_back(*it);
+    if (cache.paged) {
+        load_paged_entries(cache, pagination);
+    } else {
+        for (size_t i = start_idx; i < end_idx; i++) {
+            const auto& entry = cache.listing[i];
+            entry_list.push_back({std::string{cache.listing.name(entry)}, entry.size, entry.is_directory});
+        }
     }
 
     // Add next page navigation if not on last page
-    if (end_idx < all_entries.size()) {
+    if (end_idx < cache.count) {
         entry_list.push_back({str_next, (uint32_t)pagination + 1, true});
     }
 }
@@ -321,6 +337,11 @@ FileManBaseView::FileManBaseView(
 }
 
 void FileManBaseView::focus() {
+    // Views pushed from here may have changed the directory.
+    if (focused_once)
+        invalidate_listings();
+    focused_once = true;
+
     if (empty_ != EmptyReason::NotEmpty) {
         button_exit.focus();
     } else {
@@ -563,11 +584,14 @@ void FileManagerView::on_rename(std::string_view hint) {
                         auto new_name = renamed_path.replace_extension(partner.extension());
                         rename_file(partner, current_path / new_name);
                     }
+                    invalidate_listings();
                     reload_current(false);
                 });
 
-            if (!has_partner)
+            if (!has_partner) {
+                invalidate_listings();
                 reload_current(false);
+            }
         });
 }
 
@@ -589,11 +613,14 @@ void FileManagerView::on_delete() {
                     [this](const fs::path& partner, bool should_delete) {
                         if (should_delete)
                             delete_file(partner);
+                        invalidate_listings();
                         reload_current(true);
                     });
 
-                if (!has_partner)
+                if (!has_partner) {
+                    invalidate_listings();
                     reload_current(true);
+                }
             }
         });
 }
@@ -618,6 +645,7 @@ void FileManagerView::on_clean() {
                     std::filesystem::path current_full_path = path_name / file_name;
                     delete_file(current_full_path);
                 }
+                invalidate_listings();
                 reload_current(true);
             }
         });
@@ -627,6 +655,7 @@ void FileManagerView::on_new_dir() {
     name_buffer = "";
     text_prompt(nav_, name_buffer, max_filename_length, ENTER_KEYBOARD_MODE_ALPHA, [this](std::string& dir_name) {
         make_new_directory(current_path / dir_name);
+        invalidate_listings();
         reload_current(true);
     });
 }
@@ -651,6 +680,7 @@ void FileManagerView::on_paste() {
     clipboard_path = fs::path{};
     clipboard_mode = ClipboardMode::None;
     menu_view.focus();
+    invalidate_listings();
     reload_current(true);
 }
 
@@ -658,6 +688,7 @@ void FileManagerView::on_new_file() {
     name_buffer = "";
     text_prompt(nav_, name_buffer, max_filename_length, ENTER_KEYBOARD_MODE_ALPHA, [this](std::string& file_name) {
         make_new_file(current_path / file_name);
+        invalidate_listings();
         reload_current(true);
     });
 }
@@ -735,22 +766,17 @@ FileManagerView::FileManagerView(
     });
 
     menu_view.on_highlight = [this]() {
-        if (menu_view.highlighted_index() >= max_items_loaded - 1) {  // todo check this if correct
-            text_date.set_style(Theme::getInstance()->fg_red);
-            text_date.set("Too many files!");
-        } else {
-            text_date.set_style(Theme::getInstance()->fg_medium);
-            if (selected_is_valid()) {
-                if (get_selected_entry().path == str_back) {
-                    text_date.set("Go page " + std::to_string(pagination + 1 - 1));  // for better explain, pagination start with 0 AKA real page - 1
-                } else if (get_selected_entry().path == str_next) {
-                    text_date.set("Go page " + std::to_string(pagination + 1 + 1));  // when show this, it should display current AKA (pagination + 1) + 1 AKA next page
-                } else {
-                    text_date.set((is_directory(get_selected_full_path()) ? "Created " : "Modified ") + to_string_FAT_timestamp(file_created_date(get_selected_full_path())));
-                }
+        text_date.set_style(Theme::getInstance()->fg_medium);
+        if (selected_is_valid()) {
+            if (get_selected_entry().path == str_back) {
+                text_date.set("Go page " + std::to_string(pagination + 1 - 1));  // for better explain, pagination start with 0 AKA real page - 1
+            } else if (get_selected_entry().path == str_next) {
+                text_date.set("Go page " + std::to_string(pagination + 1 + 1));  // when show this, it should display current AKA (pagination + 1) + 1 AKA next page
             } else {
-                text_date.set("");
+                text_date.set((is_directory(get_selected_full_path()) ? "Created " : "Modified ") + to_string_FAT_timestamp(file_created_date(get_selected_full_path())));
             }
+        } else {
+            text_date.set("");
         }
     };
 
@@ -25,6 +25,7 @@
 #include "ui_painter.hpp"
 #include "ui_menu.hpp"
 #include "file.hpp"
+#include "file_listing.hpp"
 #include "ui_navigation.hpp"
 #include "ui_textentry.hpp"
 
@@ -66,8 +67,9 @@ class FileManBaseView : public View {
     uint8_t nb_pages = 1;
     bool restoring_navigation = false;
     static constexpr size_t max_filename_length = 20;
-    static constexpr size_t max_items_loaded = 75;  // too memory hungry, so won't sort it
     static constexpr size_t items_per_page = 20;
+    static constexpr size_t max_listing_bytes = 8 * 1024;  // Bigger directories are sorted a page at a time.
+    static constexpr size_t max_page_starts = 32;
 
     struct file_assoc_t {
         std::filesystem::path extension;
@@ -90,12 +92,34 @@ class FileManBaseView : public View {
     std::filesystem::path get_selected_full_path() const;
     const fileman_entry& get_selected_entry() const;
 
-    int file_count_filtered(const std::filesystem::path& directory);
+    /* The current directory's listing for one filter, reused across
+     * pagination until the directory's timestamp changes or
+     * invalidate_listings() is called. Directories that don't fit in
+     * max_listing_bytes are only counted; each page is then selected in
+     * sorted order with a pass over the directory, remembering the entry
+     * the visited pages start after. */
+    struct listing_cache_t {
+        std::filesystem::path path{};
+        std::filesystem::path filter{};
+        bool show_hidden{false};
+        FATTimestamp stamp{};
+        bool valid{false};
+        bool paged{false};
+        size_t count{0};
+        FileListing listing{max_listing_bytes};
+        PageBookmarks<ListingKey> page_starts{max_page_starts};
+        size_t last_page_start{0};
+    };
+
+    bool listing_accepts(const std::filesystem::directory_entry& entry) const;
+    listing_cache_t& get_listing(const std::filesystem::path& dir_path);
+    void build_listing(listing_cache_t& cache);
+    void load_paged_entries(listing_cache_t& cache, size_t page);
+    void invalidate_listings();
     void pop_dir();
     void refresh_list();
     void reload_current(bool reset_pagination = false);
     void load_directory_contents(const std::filesystem::path& dir_path);
-    void load_directory_contents_unordered(const std::filesystem::path& dir_path, size_t file_cnt);
     const file_assoc_t& get_assoc(const std::filesystem::path& ext) const;
     std::string get_extension(const std::string& t) const;
     void copy_waterfall(std::filesystem::path path);
@@ -115,6 +139,8 @@ class FileManBaseView : public View {
 
     std::list<fileman_entry> entry_list{};
     std::vector<uint32_t> saved_index_stack{};
+    listing_cache_t listing_cache{};
+    bool focused_once{false};
 
     bool show_hidden_files{false};
 
@@ -111,8 +111,8 @@ void GlassView::retune() {
     // Start a new sweep.
     // Tune rx for this new slice directly because the model
     // saves to persistent memory which is slower.
+    // The baseband drops samples until the front end settled on the new frequency.
     radio::set_tuning_frequency(f_center);
-    chThdSleepMilliseconds(5);             // stabilize freq
     baseband::spectrum_streaming_start();  // Do the RX
 }
 
@@ -159,7 +159,8 @@ void GlassView::add_spectrum_pixel(uint8_t power) {
             }
             if (last_max_freq != max_freq_hold) {
                 last_max_freq = max_freq_hold;
-                freq_stats.set("MAX HOLD: " + to_string_short_freq(max_freq_hold));
+                FixedString<20> stats;
+                freq_stats.set(stats.append("MAX HOLD: ").append_short_freq(max_freq_hold).view());
             }
             plot_marker(marker_pixel_index);
         } else {
@@ -31,6 +31,7 @@
 #include "string_format.hpp"
 #include "ui_fileman.hpp"
 #include "io_file.hpp"
+#include "portapack_shared_memory.hpp"
 #include "io_convert.hpp"
 #include "oversample.hpp"
 #include "baseband_api.hpp"
@@ -50,7 +51,7 @@ namespace ui {
 void ReconView::reload_restart_recon() {
     // force reload of current
     change_mode(field_mode.selected_index_value());
-    uint8_t previous_index = current_index;
+    int32_t previous_index = current_index;
     reset_indexes();
     frequency_file_load();
     current_index = previous_index;
@@ -97,8 +98,8 @@ bool ReconView::current_is_valid() {
     return (unsigned)current_index < frequency_list.size();
 }
 
-freqman_entry& ReconView::current_entry() {
-    return *frequency_list[current_index];
+const freqman_compact_entry& ReconView::current_entry() {
+    return frequency_list[current_index];
 }
 
 void ReconView::set_loop_config(bool v) {
@@ -131,8 +132,7 @@ void ReconView::clear_freqlist_for_ui_action() {
         audio::output::stop();
     // flag to detect and reload frequency_list
     if (!manual_mode) {
-        // Clear doesn't actually free, re-assign so destructor runs on previous instance.
-        frequency_list = freqman_db{};
+        frequency_list.clear();
     } else
         frequency_list.shrink_to_fit();
     freqlist_cleared_for_ui_action = true;
@@ -146,7 +146,7 @@ void ReconView::reset_indexes() {
 }
 
 void ReconView::update_description() {
-    if (frequency_list.empty() || current_entry().description.empty()) {
+    if (frequency_list.empty() || frequency_list.description(current_index).empty()) {
         description = "...no description...";
     } else {
         switch (current_entry().type) {
@@ -162,7 +162,7 @@ void ReconView::update_description() {
             default:
                 description = "S: ";
         }
-        description += current_entry().description;
+        description += frequency_list.description(current_index);
     }
     desc_cycle.set(description);
 }
@@ -198,7 +198,7 @@ bool ReconView::recon_save_freq(const fs::path& path, size_t freq_index, bool wa
     if (!freq_db.open(path, /*create*/ true))
         return false;
 
-    freqman_entry entry = *frequency_list[freq_index];  // Makes a copy.
+    freqman_entry entry = frequency_list.entry(freq_index);
 
     // For ranges, save the current frequency instead.
     if (entry.type == freqman_type::Range) {
@@ -569,22 +569,22 @@ ReconView::ReconView(NavigationView& nav)
             if (field_mode.selected_index_value() != SPEC_MODULATION)
                 audio::output::stop();
 
-            // Clear doesn't actually free, re-assign so destructor runs on previous instance.
-            frequency_list = freqman_db{};
+            frequency_list.clear();
             current_index = 0;
-            frequency_list.push_back(std::make_unique<freqman_entry>());
 
             def_step = step_mode.selected_index();
-            current_entry().type = freqman_type::Range;
-            current_entry().description =
-                to_string_short_freq(frequency_range.min).erase(0, 1) + ">" +  // euquiq: lame kludge to reduce spacing in step freq
-                to_string_short_freq(frequency_range.max).erase(0, 1) + " S:" +
-                freqman_entry_get_step_string_short(def_step);
-            current_entry().frequency_a = frequency_range.min;
-            current_entry().frequency_b = frequency_range.max;
-            current_entry().modulation = freqman_invalid_index;
-            current_entry().bandwidth = freqman_invalid_index;
-            current_entry().step = def_step;
+            frequency_list.push_back(freqman_entry{
+                .frequency_a = frequency_range.min,
+                .frequency_b = frequency_range.max,
+                .description =
+                    to_string_short_freq(frequency_range.min).erase(0, 1) + ">" +  // euquiq: lame kludge to reduce spacing in step freq
+                    to_string_short_freq(frequency_range.max).erase(0, 1) + " S:" +
+                    freqman_entry_get_step_string_short(def_step),
+                .type = freqman_type::Range,
+                .modulation = freqman_invalid_index,
+                .bandwidth = freqman_invalid_index,
+                .step = def_step,
+            });
 
             big_display.set_style(Theme::getInstance()->bg_darkest);  // Back to white color
 
@@ -781,11 +781,12 @@ void ReconView::frequency_file_load() {
     file_name.set(file_input + "=>" + output_file);
 
     freqman_load_options options{
+        .max_entries = freqman_list_max_entries,
         .load_freqs = load_freqs,
         .load_ranges = load_ranges,
         .load_hamradios = load_hamradios,
         .load_repeaters = load_repeaters};
-    if (!load_freqman_file(file_input, frequency_list, options) || frequency_list.empty()) {
+    if (!load_freqman_list(get_freqman_path(file_input), frequency_list, options) || frequency_list.empty()) {
         file_name.set_style(Theme::getInstance()->fg_red);
         desc_cycle.set("...empty file...");
         frequency_list.clear();
@@ -825,6 +826,11 @@ void ReconView::on_statistics_update(const ChannelStatistics& statistics) {
     if (is_repeat_active())
         return;
 
+    // Only act on measurements of the current frequency; the first settled one
+    // arrives right after a retune instead of after a fixed delay.
+    if (!statistics.settled || (statistics.retune_epoch != shared_memory.retune_epoch))
+        return;
+
     chrono_end = chTimeNow();
     systime_t time_interval = chrono_end - chrono_start;
     chrono_start = chrono_end;
@@ -911,7 +917,8 @@ void ReconView::on_statistics_update(const ChannelStatistics& statistics) {
     }
     if (last_timer != timer) {
         last_timer = timer;
-        text_timer.set("TIMER: " + to_string_dec_int(timer));
+        FixedString<20> timer_str;
+        text_timer.set(timer_str.append("TIMER: ").append_dec_int(timer).view());
     }
 
     if (timer != 0) {
@@ -1273,9 +1280,9 @@ size_t ReconView::change_mode(freqman_index_t new_mod) {
     return freqman_entry_get_step_value(def_step);
 }
 
-void ReconView::handle_coded_squelch(const uint32_t value) {
+void ReconView::handle_coded_squelch(const CodedSquelchMessage& message) {
     if (field_mode.selected_index() == NFM_MODULATION)
-        text_ctcss.set(tone_key_string_by_value(value, text_ctcss.parent_rect().width() / 8));
+        text_ctcss.set(coded_squelch_string(message, text_ctcss.parent_rect().width() / 8));
     else
         text_ctcss.set("        ");
 }
@@ -1284,12 +1291,12 @@ void ReconView::handle_remove_current_item() {
     if (frequency_list.empty() || !current_is_valid())
         return;
 
-    auto entry = current_entry();  // Copy the current entry.
+    auto entry = frequency_list.entry(current_index);  // Copy the current entry.
 
     // In Scanner or Recon modes, remove from the in-memory list.
     if (mode() != recon_mode::Manual) {
         if (current_is_valid()) {
-            frequency_list.erase(frequency_list.begin() + current_index);
+            frequency_list.erase(current_index);
         }
     }
 
@@ -1306,8 +1313,7 @@ void ReconView::handle_remove_current_item() {
     if (frequency_list.size() > 0) {
         current_index = clip<int32_t>(current_index, 0u, frequency_list.size() - 1);
         text_cycle.set_text(to_string_dec_uint(current_index + 1, 3));
-        entry = current_entry();
-        freq = entry.frequency_a;
+        freq = current_entry().frequency_a;
     } else {
         current_index = 0;
         text_cycle.set_text(" ");
@@ -102,7 +102,7 @@ class ReconView : public View {
     void colorize_waits();
     void recon_redraw();
     void handle_retune();
-    void handle_coded_squelch(const uint32_t value);
+    void handle_coded_squelch(const CodedSquelchMessage& message);
     void handle_remove_current_item();
     void load_persisted_settings();
     bool recon_save_freq(const std::filesystem::path& path, size_t index, bool warn_if_exists);
@@ -111,7 +111,7 @@ class ReconView : public View {
 
     // Returns true if 'current_index' is in bounds of frequency_list.
     bool current_is_valid();
-    freqman_entry& current_entry();
+    const freqman_compact_entry& current_entry();
 
     // TODO: consolidate mode bools and use recon_mode.
     recon_mode mode() const {
@@ -125,7 +125,7 @@ class ReconView : public View {
     int32_t db{0};
     int32_t timer{0};
     int32_t wait{RECON_DEF_WAIT_DURATION};  // in msec. if > 0 wait duration after a lock, if < 0 duration is set to 'wait' unless there is no more activity
-    freqman_db frequency_list{};
+    FreqmanList frequency_list{};
     int32_t current_index{0};
     bool continuous_lock{false};
     bool freqlist_cleared_for_ui_action{false};  // flag positioned by ui widgets to manage freqlist unload/load
@@ -401,7 +401,7 @@ class ReconView : public View {
         Message::ID::CodedSquelch,
         [this](const Message* const p) {
             const auto message = *reinterpret_cast<const CodedSquelchMessage*>(p);
-            handle_coded_squelch(message.value);
+            handle_coded_squelch(message);
         }};
 
     MessageHandlerRegistration message_handler_stats{
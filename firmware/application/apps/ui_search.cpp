@@ -78,6 +78,7 @@ SearchView::SearchView(
                   &recent_entries_view});
 
     baseband::set_spectrum(SEARCH_SLICE_WIDTH, 31);
+    update_detector();
 
     recent_entries_view.set_parent_rect({0, 28 * 8, screen_width, 12 * 8});
     recent_entries_view.on_select = [this, &nav](const SearchRecentEntry& entry) {
@@ -100,7 +101,9 @@ SearchView::SearchView(
         on_range_changed();
     });
 
-    bind(field_threshold, settings_.power_threshold);
+    bind(field_threshold, settings_.power_threshold, [this](auto) {
+        update_detector();
+    });
     bind(check_snap, settings_.snap_search);
     bind(options_snap, settings_.snap_step);
 
@@ -127,11 +130,30 @@ void SearchView::focus() {
     field_frequency_min.focus();
 }
 
+void SearchView::update_detector() {
+    baseband::set_spectrum_detector(
+        settings_.power_threshold,
+        SEARCH_CFAR_GUARD_BINS,
+        SEARCH_CFAR_TRAINING_BINS,
+        SEARCH_CFAR_EDGE_BINS,
+        SEARCH_CFAR_DC_BINS);
+}
+
+rf::Frequency SearchView::bin_frequency(const rf::Frequency center_frequency, const int16_t bin) {
+    rf::Frequency frequency = center_frequency + (SEARCH_BIN_WIDTH * (bin - 128));
+
+    if (check_snap.value()) {
+        uint32_t snap_value = options_snap.selected_index_value();
+        frequency = round(frequency / snap_value) * snap_value;
+    }
+
+    return frequency;
+}
+
 void SearchView::do_detection() {
     uint8_t power_max = 0;
     int32_t bin_max = -1;
     uint32_t slice_max = 0;
-    uint32_t snap_value;
     uint8_t power;
     rtc::RTC datetime;
     std::string str_approx, str_timestamp;
@@ -143,23 +165,25 @@ void SearchView::do_detection() {
         {{0, 88}, {(Dim)spectrum_row.size(), 1}},
         spectrum_row);
 
-    mean_power = mean_acc / (SEARCH_BIN_NB_NO_DC * slices_nb);
-    mean_acc = 0;
-
+    uint32_t noise_acc = 0;
     overall_power_max = 0;
 
-    // Find max power over threshold for all slices
+    // Strongest detection over all slices, the M4 detector already applied the threshold.
+    // The VU meter shows the strongest bin, so it moves without a detection too.
     for (size_t slice = 0; slice < slices_nb; slice++) {
+        noise_acc += slices[slice].noise_floor;
+        if (slices[slice].peak_power > overall_power_max)
+            overall_power_max = slices[slice].peak_power;
+
         power = slices[slice].max_power;
-        if (power > overall_power_max)
-            overall_power_max = power;
 
-        if ((power >= mean_power + settings_.power_threshold) && (power > power_max)) {
+        if (power > power_max) {
             power_max = power;
             bin_max = slices[slice].max_index;
             slice_max = slice;
         }
     }
+    mean_power = noise_acc / slices_nb;
 
     // Lock / release
     if ((bin_max >= last_bin - 2) && (bin_max <= last_bin + 2) && (bin_max > -1) && (slice_max == last_slice)) {
@@ -167,12 +191,7 @@ void SearchView::do_detection() {
         if (detect_timer >= DETECT_DELAY) {
             if ((bin_max != locked_bin) || (!locked)) {
                 if (!locked) {
-                    resolved_frequency = slices[slice_max].center_frequency + (SEARCH_BIN_WIDTH * (bin_max - 128));
-
-                    if (check_snap.value()) {
-                        snap_value = options_snap.selected_index_value();
-                        resolved_frequency = round(resolved_frequency / snap_value) * snap_value;
-                    }
+                    resolved_frequency = bin_frequency(slices[slice_max].center_frequency, bin_max);
 
                     // Check range
                     if ((resolved_frequency >= settings_.freq_min) && (resolved_frequency <= settings_.freq_max)) {
@@ -274,16 +293,16 @@ void SearchView::do_timers() {
 }
 
 void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
-    uint8_t max_power = 0;
-    int16_t max_bin = 0;
     uint8_t power;
     size_t bin;
 
     baseband::spectrum_streaming_stop();
 
-    // Add pixels to spectrum display and find max power for this slice
+    // Add pixels to spectrum display
     // Center 12 bins are ignored (DC spike is blanked)
     // Leftmost and rightmost 2 bins are ignored
+    auto& slice = slices[slice_counter];
+    slice.peak_power = 0;
     for (bin = 0; bin < 256; bin++) {
         if ((bin < 2) || (bin > 253) || ((bin >= 122) && (bin < 134))) {
             power = 0;
@@ -294,17 +313,24 @@ void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
                 power = spectrum.db[bin - 128];
         }
 
+        if (power > slice.peak_power)
+            slice.peak_power = power;
+
         add_spectrum_pixel(gradient.lut[power]);
+    }
 
-        mean_acc += power;
-        if (power > max_power) {
-            max_power = power;
-            max_bin = bin;
+    // Detections and noise floor come from the CFAR detector on the M4
+    slice.noise_floor = (slice.noise_floor * 3 + spectrum.noise_floor) / 4;
+    slice.max_power = 0;
+    slice.max_index = 0;
+    for (size_t n = 0; n < spectrum.detection_count; n++) {
+        const auto& detection = spectrum.detections[n];
+        if (detection.power > slice.max_power) {
+            slice.max_power = detection.power;
+            slice.max_index = detection.bin;
         }
     }
-
-    slices[slice_counter].max_power = max_power;
-    slices[slice_counter].max_index = max_bin;
+    log_detections(spectrum, slice.center_frequency);
 
     if (slices_nb > 1) {
         // Slice sequence
@@ -323,6 +349,73 @@ void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
     baseband::spectrum_streaming_start();
 }
 
+// Every emitter found in the sweeps gets an entry, not only the one being locked on
+void SearchView::log_detections(const ChannelSpectrum& spectrum, const rf::Frequency center_frequency) {
+    std::string str_timestamp{};
+
+    for (size_t n = 0; n < spectrum.detection_count; n++) {
+        const auto frequency = bin_frequency(center_frequency, spectrum.detections[n].bin);
+
+        if ((frequency < settings_.freq_min) || (frequency > settings_.freq_max))
+            continue;
+
+        auto candidate = std::find_if(candidates.begin(), candidates.begin() + candidates_nb, [frequency](const candidate_t& c) {
+            return std::abs(c.frequency - frequency) <= SEARCH_LOG_TOLERANCE;
+        });
+        if (candidate == candidates.begin() + candidates_nb) {
+            if (candidates_nb == candidates.size())
+                continue;
+            candidates[candidates_nb++] = {frequency, center_frequency, 0, false};
+        }
+
+        // Once per sweep, however many bins of it the emitter covers.
+        if (!candidate->seen) {
+            candidate->seen = true;
+            candidate->sweeps++;
+        }
+    }
+
+    // Candidates of this slice that weren't seen again are dropped, those
+    // that have persisted long enough are logged.
+    size_t kept = 0;
+    for (size_t n = 0; n < candidates_nb; n++) {
+        auto& candidate = candidates[n];
+        if (candidate.slice_frequency != center_frequency) {
+            candidates[kept++] = candidate;
+            continue;
+        }
+        if (!candidate.seen)
+            continue;
+        candidate.seen = false;
+
+        if (candidate.sweeps < SEARCH_LOG_SWEEPS) {
+            candidates[kept++] = candidate;
+            continue;
+        }
+        if (is_logged(candidate.frequency))
+            continue;
+
+        if (str_timestamp.empty()) {
+            rtc::RTC datetime;
+            rtcGetTime(&RTCD1, &datetime);
+            str_timestamp = to_string_dec_uint(datetime.hour(), 2, '0') + ":" +
+                            to_string_dec_uint(datetime.minute(), 2, '0') + ":" +
+                            to_string_dec_uint(datetime.second(), 2, '0');
+        }
+
+        auto& entry = ::on_packet(recent, candidate.frequency);
+        entry.set_time(str_timestamp);
+        recent_entries_view.set_dirty();
+    }
+    candidates_nb = kept;
+}
+
+bool SearchView::is_logged(const rf::Frequency frequency) const {
+    return std::any_of(recent.begin(), recent.end(), [frequency](const SearchRecentEntry& entry) {
+        return std::abs(entry.frequency - frequency) <= SEARCH_LOG_TOLERANCE;
+    });
+}
+
 void SearchView::on_range_changed() {
     rf::Frequency slices_span;
     rf::Frequency center_frequency;
@@ -364,6 +457,7 @@ void SearchView::on_range_changed() {
     bin_skip_frac = 0xF000 / slices_nb;
 
     slice_counter = 0;
+    candidates_nb = 0;
 }
 
 void SearchView::add_spectrum_pixel(Color color) {
@@ -34,6 +34,18 @@ namespace ui {
 #define SEARCH_BIN_NB_NO_DC (SEARCH_BIN_NB - 16)  // Bins after trimming
 #define SEARCH_BIN_WIDTH (SEARCH_SLICE_WIDTH / SEARCH_BIN_NB)
 
+// CFAR detector run on the M4, see cfar_detector.hpp
+#define SEARCH_CFAR_GUARD_BINS 2
+#define SEARCH_CFAR_TRAINING_BINS 8
+#define SEARCH_CFAR_EDGE_BINS 2
+#define SEARCH_CFAR_DC_BINS 6
+
+// Detections are only logged once seen in consecutive sweeps, and hits
+// closer than the tolerance count as the same emitter.
+#define SEARCH_LOG_SWEEPS 3
+#define SEARCH_LOG_TOLERANCE (2 * SEARCH_BIN_WIDTH)
+#define SEARCH_LOG_CANDIDATES 32
+
 #define DETECT_DELAY 5  // In 100ms units
 #define RELEASE_DELAY 6
 
@@ -117,12 +129,21 @@ class SearchView : public View {
 
     struct slice_t {
         rf::Frequency center_frequency;
-        uint8_t max_power;
+        uint8_t max_power;  // Strongest detection
+        uint8_t peak_power;  // Strongest bin, detected or not
         int16_t max_index;
-        uint8_t power;
-        int16_t index;
+        uint8_t noise_floor;
     } slices[32];
 
+    struct candidate_t {
+        rf::Frequency frequency;
+        rf::Frequency slice_frequency;  // Center of the slice it was found in
+        uint8_t sweeps;  // Consecutive sweeps it was seen in
+        bool seen;       // In the current pass over its slice
+    };
+    std::array<candidate_t, SEARCH_LOG_CANDIDATES> candidates{};
+    size_t candidates_nb = 0;
+
     uint32_t bin_skip_acc = 0;
     uint32_t bin_skip_frac = 0;
     uint32_t pixel_index = 0;
@@ -134,7 +155,6 @@ class SearchView : public View {
     uint8_t timing_div = 0;
     uint8_t overall_power_max{0};
     uint32_t mean_power = 0;
-    uint32_t mean_acc = 0;
     uint32_t duration = 0;
 
     rf::Frequency slice_start = 0;
@@ -152,7 +172,11 @@ class SearchView : public View {
     void do_detection();
     void do_timers();
     void on_channel_spectrum(const ChannelSpectrum& spectrum);
+    void log_detections(const ChannelSpectrum& spectrum, const rf::Frequency center_frequency);
+    bool is_logged(const rf::Frequency frequency) const;
+    rf::Frequency bin_frequency(const rf::Frequency center_frequency, const int16_t bin);
     void on_range_changed();
+    void update_detector();
     void add_spectrum_pixel(Color color);
 
     const RecentEntriesColumns columns{{{"Frequency", 9},
@@ -40,6 +40,7 @@ using namespace lpc43xx;
 
 #include "audio.hpp"
 #include "portapack.hpp"
+#include "radio.hpp"
 using namespace portapack;
 
 #include "file.hpp"
@@ -417,10 +418,12 @@ SetSDCardView::SetSDCardView(NavigationView& nav) {
                   &checkbox_sdcard_speed,
                   &button_test_sdcard_high_speed,
                   &text_sdcard_test_status,
+                  &checkbox_wav_peak_files,
                   &button_save,
                   &button_cancel});
 
     checkbox_sdcard_speed.set_value(pmem::config_sdcard_high_speed_io());
+    checkbox_wav_peak_files.set_value(pmem::config_wav_peak_files());
 
     button_test_sdcard_high_speed.on_select = [&nav, this](Button&) {
         pmem::set_config_sdcard_high_speed_io(true, false);
@@ -429,6 +432,7 @@ SetSDCardView::SetSDCardView(NavigationView& nav) {
 
     button_save.on_select = [&nav, this](Button&) {
         pmem::set_config_sdcard_high_speed_io(checkbox_sdcard_speed.value(), true);
+        pmem::set_config_wav_peak_files(checkbox_wav_peak_files.value());
         send_system_refresh();
         nav.pop();
     };
@@ -461,6 +465,7 @@ SetConverterSettingsView::SetConverterSettingsView(NavigationView& nav) {
             check_converter.set_value(false);
         }
         // Retune to take converter change in account.
+        radio::update_frequency_correction();
         receiver_model.set_target_frequency(receiver_model.target_frequency());
         // Refresh status bar converter icon.
         send_system_refresh();
@@ -474,6 +479,7 @@ SetConverterSettingsView::SetConverterSettingsView(NavigationView& nav) {
         }
         pmem::set_config_converter(v);
         // Retune to take converter change in account.
+        radio::update_frequency_correction();
         receiver_model.set_target_frequency(receiver_model.target_frequency());
         // Refresh status bar converter icon.
         send_system_refresh();
@@ -482,6 +488,9 @@ SetConverterSettingsView::SetConverterSettingsView(NavigationView& nav) {
     opt_converter_mode.set_by_value(pmem::config_updown_converter());
     opt_converter_mode.on_change = [this](size_t, OptionsField::value_t v) {
         pmem::set_config_updown_converter(v);
+        // Retune to take converter change in account.
+        radio::update_frequency_correction();
+        receiver_model.set_target_frequency(receiver_model.target_frequency());
         // Refresh status bar with up or down icon.
         send_system_refresh();
     };
@@ -491,6 +500,7 @@ SetConverterSettingsView::SetConverterSettingsView(NavigationView& nav) {
     field_converter_freq.on_change = [this](rf::Frequency f) {
         pmem::set_config_converter_freq(f);
         // Retune to take converter change in account.
+        radio::update_frequency_correction();
         receiver_model.set_target_frequency(receiver_model.target_frequency());
     };
     field_converter_freq.on_edit = [this, &nav]() {
@@ -524,11 +534,17 @@ SetFrequencyCorrectionView::SetFrequencyCorrectionView(NavigationView& nav) {
     opt_rx_correction_mode.set_by_value(pmem::config_freq_rx_correction_updown());
     opt_rx_correction_mode.on_change = [this](size_t, OptionsField::value_t v) {
         pmem::set_freq_rx_correction_updown(v);
+        // Retune to take correction change in account.
+        radio::update_frequency_correction();
+        receiver_model.set_target_frequency(receiver_model.target_frequency());
     };
 
     opt_tx_correction_mode.set_by_value(pmem::config_freq_tx_correction_updown());
     opt_tx_correction_mode.on_change = [this](size_t, OptionsField::value_t v) {
         pmem::set_freq_tx_correction_updown(v);
+        // Retune to take correction change in account.
+        radio::update_frequency_correction();
+        receiver_model.set_target_frequency(receiver_model.target_frequency());
     };
 
     field_rx_correction.set_step(100'000);
@@ -536,6 +552,7 @@ SetFrequencyCorrectionView::SetFrequencyCorrectionView(NavigationView& nav) {
     field_rx_correction.on_change = [this](rf::Frequency f) {
         pmem::set_config_freq_rx_correction(f);
         // Retune to take converter change in account.
+        radio::update_frequency_correction();
         receiver_model.set_target_frequency(receiver_model.target_frequency());
     };
     field_rx_correction.on_edit = [this, &nav]() {
@@ -550,6 +567,7 @@ SetFrequencyCorrectionView::SetFrequencyCorrectionView(NavigationView& nav) {
     field_tx_correction.on_change = [this](rf::Frequency f) {
         pmem::set_config_freq_tx_correction(f);
         // Retune to take converter change in account. NB: receiver_model.
+        radio::update_frequency_correction();
         receiver_model.set_target_frequency(receiver_model.target_frequency());
     };
     field_tx_correction.on_edit = [this, &nav]() {
@@ -407,6 +407,11 @@ class SetSDCardView : public View {
         {2 * 8, 198, 28 * 8, 16},
         ""};
 
+    Checkbox checkbox_wav_peak_files{
+        {2 * 8, 216},
+        23,
+        "save WAV peaks as .PPK"};
+
     Button button_save{
         {2 * 8, 16 * 16, 12 * 8, 32},
         "Save"};
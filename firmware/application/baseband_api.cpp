@@ -30,6 +30,7 @@
 #include "portapack_persistent_memory.hpp"
 
 #include "core_control.hpp"
+#include "startup_trace.hpp"
 
 /* Set true to enable additional checks to ensure
  * M4 and M0 are synchronized before passing messages. */
@@ -318,6 +319,12 @@ void set_spectrum(const size_t sampling_rate, const size_t trigger) {
     send_message(&message);
 }
 
+void set_spectrum_detector(const uint8_t threshold, const uint8_t guard_bins, const uint8_t training_bins, const uint8_t edge_bins, const uint8_t dc_bins) {
+    const SpectrumDetectorConfigMessage message{
+        threshold, guard_bins, training_bins, edge_bins, dc_bins};
+    send_message(&message);
+}
+
 void set_wefax_config(uint8_t lpm = 120, uint8_t ioc = 0) {
     const WeFaxRxConfigureMessage message{lpm, ioc};
     send_message(&message);
@@ -352,6 +359,20 @@ void set_subghzd_config(uint8_t modulation = 0, uint32_t sampling_rate = 0) {
 
 static bool baseband_image_running = false;
 
+/* Set once a shut down image has acknowledged it is parked, waiting for
+ * either a reset or a warm restart. */
+static bool baseband_image_parked = false;
+
+/* Warm restart skips the startup code of the image, so globals keep the
+ * values of the last run. Only images checked to keep their state in the
+ * processor, or to reset it on restart, are restarted this way. */
+static bool warm_restart_safe(const spi_flash::image_tag_t image_tag) {
+    return image_tag == spi_flash::image_tag_am_audio ||
+           image_tag == spi_flash::image_tag_nfm_audio ||
+           image_tag == spi_flash::image_tag_wfm_audio ||
+           image_tag == spi_flash::image_tag_wideband_spectrum;
+}
+
 void run_image(const spi_flash::image_tag_t image_tag) {
     if (baseband_image_running) {
         chDbgPanic("BBRunning");
@@ -360,7 +381,15 @@ void run_image(const spi_flash::image_tag_t image_tag) {
     creg::m4txevent::clear();
     shared_memory.clear_baseband_ready();
 
-    m4_init(image_tag, memory::map::m4_code, false);
+    if (baseband_image_parked && warm_restart_safe(image_tag) && m4_image_resident(image_tag, memory::map::m4_code)) {
+        // Same image still in M4 code RAM, only the processor needs rebuilding.
+        startup_trace::begin(image_tag);
+        WarmRestartMessage message;
+        send_message(&message);
+    } else {
+        m4_init(image_tag, memory::map::m4_code, false);
+    }
+    baseband_image_parked = false;
     baseband_image_running = true;
 
     creg::m4txevent::enable();
@@ -373,6 +402,8 @@ void run_image(const spi_flash::image_tag_t image_tag) {
 
         if (count == 0)
             chDbgPanic("Baseband Sync Fail");
+
+        startup_trace::mark(startup_trace::Stage::BasebandReady);
     }
 }
 
@@ -385,6 +416,7 @@ void run_prepared_image(const uint32_t m4_code) {
     shared_memory.clear_baseband_ready();
 
     m4_init_prepared(m4_code, false);
+    baseband_image_parked = false;
     baseband_image_running = true;
 
     creg::m4txevent::enable();
@@ -397,6 +429,8 @@ void run_prepared_image(const uint32_t m4_code) {
 
         if (count == 0)
             chDbgPanic("Baseband Sync Fail");
+
+        startup_trace::mark(startup_trace::Stage::BasebandReady);
     }
 }
 
@@ -413,6 +447,7 @@ void shutdown() {
     shared_memory.application_queue.reset();
 
     baseband_image_running = false;
+    baseband_image_parked = true;
 }
 
 void spectrum_streaming_start() {
@@ -427,6 +462,16 @@ void spectrum_streaming_stop() {
     send_message(&message);
 }
 
+void set_waterfall_palette(const uint16_t* const lut, const uint32_t tag) {
+    WaterfallPaletteMessage message{lut, tag};
+    send_message(&message);
+}
+
+void set_audio_tap(const bool enabled) {
+    AudioTapConfigMessage message{enabled};
+    send_message(&message);
+}
+
 void set_sample_rate(uint32_t sample_rate, OversampleRate oversample_rate) {
     SampleRateConfigMessage message{sample_rate, oversample_rate};
     send_message(&message);
@@ -96,6 +96,7 @@ void set_adsb();
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
 void set_spectrum(const size_t sampling_rate, const size_t trigger);
+void set_spectrum_detector(const uint8_t threshold, const uint8_t guard_bins, const uint8_t training_bins, const uint8_t edge_bins, const uint8_t dc_bins);
 void set_siggen_tone(const uint32_t tone);
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
 void set_spectrum_painter_config(const uint16_t width, const uint16_t height, bool update, int32_t bw);
@@ -114,6 +115,8 @@ void shutdown();
 
 void spectrum_streaming_start();
 void spectrum_streaming_stop();
+void set_waterfall_palette(const uint16_t* const lut, const uint32_t tag);
+void set_audio_tap(const bool enabled);
 
 /* NB: sample_rate should be desired rate. Don't pre-scale. */
 void set_sample_rate(uint32_t sample_rate, OversampleRate oversample_rate = OversampleRate::None);
@@ -22,25 +22,54 @@
 
 #include "baseband_api.hpp"
 #include "core_control.hpp"
+#include "crc.hpp"
 #include "hal.h"
 #include "lpc43xx_cpp.hpp"
-#include "lz4.h"
+#include "lz4.hpp"
 #include "message.hpp"
+#include "startup_trace.hpp"
 
 #include <cstring>
 
 using namespace lpc43xx;
 using namespace portapack;
 
+/* The image m4_init last unpacked, kept so re-entering an app that uses the
+ * same image can skip unpacking it. */
+static struct {
+    spi_flash::image_tag_t tag{};
+    uint32_t base{0};
+    size_t size{0};
+    uint32_t checksum{0};
+} resident_image;
+
+static uint32_t m4_code_checksum(const uint32_t base, const size_t size) {
+    CRC<32> crc{0x04c11db7, 0xffffffff, 0xffffffff};
+    crc.process_bytes(reinterpret_cast<const void*>(base), size);
+    return crc.checksum();
+}
+
 void m4_init(const spi_flash::image_tag_t image_tag, const memory::region_t to, const bool full_reset) {
+    startup_trace::begin(image_tag);
+    resident_image.tag = spi_flash::image_tag_none;
+
     const spi_flash::chunk_t* chunk = reinterpret_cast<const spi_flash::chunk_t*>(spi_flash::images.base());
     while (chunk->tag) {
         if (chunk->tag == image_tag) {
-            const void* src = &chunk->data[0];
-            void* dst = reinterpret_cast<void*>(to.base());
+            startup_trace::mark(startup_trace::Stage::ImageLocated);
+
+            uint8_t* dst = reinterpret_cast<uint8_t*>(to.base());
 
             /* extract and initialize M4 code RAM */
-            unlz4_len(src, dst, chunk->compressed_data_size);
+            const auto size = lz4::decode_block(&chunk->data[0], chunk->compressed_data_size, dst, to.size());
+            if (size == 0)
+                chDbgPanic("BadImg");
+            startup_trace::mark(startup_trace::Stage::ImageDecompressed);
+
+            resident_image.base = to.base();
+            resident_image.size = size;
+            resident_image.checksum = m4_code_checksum(to.base(), size);
+            resident_image.tag = image_tag;
 
             /* M4 core is assumed to be sleeping with interrupts off, so we can mess
              * with its address space and RAM without concern.
@@ -50,6 +79,7 @@ void m4_init(const spi_flash::image_tag_t image_tag, const memory::region_t to,
             /* Reset M4 core and optionally all peripherals */
             LPC_RGU->RESET_CTRL[0] = (full_reset) ? (1 << 1)    // PERIPH_RST
                                                   : (1 << 13);  // M4_RST
+            startup_trace::mark(startup_trace::Stage::M4Reset);
 
             return;
         }
@@ -59,7 +89,15 @@ void m4_init(const spi_flash::image_tag_t image_tag, const memory::region_t to,
     chDbgPanic("NoImg");
 }
 
+bool m4_image_resident(const spi_flash::image_tag_t image_tag, const memory::region_t to) {
+    return image_tag && resident_image.tag == image_tag && resident_image.base == to.base() &&
+           m4_code_checksum(resident_image.base, resident_image.size) == resident_image.checksum;
+}
+
 void m4_init_prepared(const uint32_t m4_code, const bool full_reset) {
+    startup_trace::begin();
+    resident_image.tag = spi_flash::image_tag_none;
+
     /* M4 core is assumed to be sleeping with interrupts off, so we can mess
      * with its address space and RAM without concern.
      */
@@ -68,6 +106,7 @@ void m4_init_prepared(const uint32_t m4_code, const bool full_reset) {
     /* Reset M4 core and optionally all peripherals */
     LPC_RGU->RESET_CTRL[0] = (full_reset) ? (1 << 1)    // PERIPH_RST
                                           : (1 << 13);  // M4_RST
+    startup_trace::mark(startup_trace::Stage::M4Reset);
 
     return;
 }
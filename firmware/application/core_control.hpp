@@ -29,6 +29,10 @@
 
 void m4_init(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to, const bool full_reset);
 void m4_init_prepared(const uint32_t m4_code, const bool full_reset);
+
+/* True if the image last unpacked by m4_init into the region is still there,
+ * verified against the checksum taken when it was unpacked. */
+bool m4_image_resident(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to);
 void m4_request_shutdown();
 
 void m0_halt();
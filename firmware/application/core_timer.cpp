@@ -1,6 +1,5 @@
 /*
- * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
- * Copyright (C) 2023 Bernd Herzog
+ * Copyright (C) 2024 PortaPack Mayhem contributors
  *
  * This file is part of PortaPack.
  *
@@ -20,17 +19,15 @@
  * Boston, MA 02110-1301, USA.
  */
 
-#ifndef __LZ4_H__
-#define __LZ4_H__
+#include "core_timer.hpp"
 
-#include <stdint.h>
+#include "hal.h"
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-extern void unlz4_len(const void* aSource, void* aDestination, uint32_t aLength);
-#ifdef __cplusplus
+namespace core_timer {
+
+/* TIMER3 is set up by the HAL as a free running core clock counter. */
+uint32_t now() {
+    return LPC_TIMER3->TC;
 }
-#endif
 
-#endif /*__LZ4_H__*/
\ No newline at end of file
+} /* namespace core_timer */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CORE_TIMER_H__
+#define __CORE_TIMER_H__
+
+#include <cstdint>
+
+namespace core_timer {
+
+/* Timer counts per microsecond (TIMER3 runs from the 200MHz core clock). */
+constexpr uint32_t counts_per_us = 200;
+
+/* Current TIMER3 count. Differences of two timestamps are wrap-safe as long
+ * as the interval is shorter than a full timer period (about 21s). */
+uint32_t now();
+
+/* Microseconds since a now() timestamp. */
+inline uint32_t elapsed_us(const uint32_t start) {
+    return (now() - start) / counts_per_us;
+}
+
+} /* namespace core_timer */
+
+#endif /*__CORE_TIMER_H__*/
@@ -23,6 +23,8 @@
 #define __DIRTY_REGISTERS_H__
 
 #include <cstddef>
+#include <cstdint>
+#include <array>
 #include <bitset>
 
 #include "utility.hpp"
@@ -49,6 +51,25 @@ class DirtyRegisters {
         mask.reset(reg_num);
     }
 
+    /* Mark only the registers whose value differs between the map before and
+     * after an update, so a flush() writes the minimal set of registers. */
+    template <typename RegisterValues>
+    void mark_changed(const RegisterValues& previous, const RegisterValues& current) {
+        for (size_t n = 0; n < RegisterCount; n++) {
+            if (previous[n] != current[n]) {
+                mask.set(n);
+            }
+        }
+    }
+
+    bool test(const size_t reg_num) const {
+        return mask.test(reg_num);
+    }
+
+    bool test(const RegisterType reg) const {
+        return mask.test(toUType(reg));
+    }
+
     typename mask_t::reference operator[](const size_t reg_num) {
         return mask[reg_num];
     }
@@ -61,4 +82,71 @@ class DirtyRegisters {
     mask_t mask{};
 };
 
+/* Records register writes issued by the radio drivers, so the SPI traffic
+ * generated by an operation (e.g. a retune) can be inspected. Recording is
+ * off until enabled; writes beyond the capacity are only counted. */
+class RegisterWriteTrace {
+   public:
+    struct Entry {
+        uint8_t device;
+        uint8_t reg_num;
+        uint32_t value;
+    };
+
+    static constexpr size_t capacity = 64;
+
+    void enable() {
+        enabled_ = true;
+    }
+
+    void disable() {
+        enabled_ = false;
+    }
+
+    bool enabled() const {
+        return enabled_;
+    }
+
+    void clear() {
+        count_ = 0;
+    }
+
+    void record(const uint8_t device, const uint8_t reg_num, const uint32_t value) {
+        if (!enabled_)
+            return;
+
+        if (count_ < capacity)
+            entries_[count_] = {device, reg_num, value};
+        count_++;
+    }
+
+    /* Number of writes recorded, including those that didn't fit. */
+    size_t count() const {
+        return count_;
+    }
+
+    /* Number of writes to a single device. */
+    size_t count(const uint8_t device) const {
+        size_t n = 0;
+        for (size_t i = 0; i < size(); i++) {
+            if (entries_[i].device == device)
+                n++;
+        }
+        return n;
+    }
+
+    size_t size() const {
+        return count_ < capacity ? count_ : capacity;
+    }
+
+    const Entry& operator[](const size_t index) const {
+        return entries_[index];
+    }
+
+   private:
+    std::array<Entry, capacity> entries_{};
+    size_t count_{0};
+    bool enabled_{false};
+};
+
 #endif /*__DIRTY_REGISTERS_H__*/
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dispatch_stats.hpp"
+
+#include "core_timer.hpp"
+#include "message.hpp"
+
+namespace dispatch_stats {
+
+static Stats<toUType(Message::ID::MAX)> stats{};
+static bool budgeted_dispatch = false;
+
+const char* source_name(const Source source) {
+    switch (source) {
+        case Source::Application:
+            return "application";
+        case Source::Local:
+            return "local";
+        case Source::RtcTick:
+            return "rtc tick";
+        case Source::Usb:
+            return "usb";
+        case Source::Switches:
+            return "switches";
+        case Source::FrameSync:
+            return "frame sync";
+        case Source::Encoder:
+            return "encoder";
+        case Source::Touch:
+            return "touch";
+    }
+    return "?";
+}
+
+void add(const Source source, const uint32_t start) {
+    stats.add(source, core_timer::elapsed_us(start));
+}
+
+void add_message(const size_t id, const uint32_t start) {
+    stats.add_message(id, core_timer::elapsed_us(start));
+}
+
+void add_deferral() {
+    stats.add_deferral();
+}
+
+const Histogram& source(const Source source) {
+    return stats.source(source);
+}
+
+const Histogram& message(const size_t id) {
+    return stats.message(id);
+}
+
+size_t message_count() {
+    return toUType(Message::ID::MAX);
+}
+
+uint32_t deferrals() {
+    return stats.deferrals();
+}
+
+void reset() {
+    stats.reset();
+}
+
+bool budgeted() {
+    return budgeted_dispatch;
+}
+
+void set_budgeted(const bool enabled) {
+    budgeted_dispatch = enabled;
+}
+
+} /* namespace dispatch_stats */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DISPATCH_STATS_H__
+#define __DISPATCH_STATS_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace dispatch_stats {
+
+/* The kinds of work done by EventDispatcher::dispatch(). */
+enum class Source : uint8_t {
+    Application = 0,
+    Local,
+    RtcTick,
+    Usb,
+    Switches,
+    FrameSync,
+    Encoder,
+    Touch,
+};
+
+constexpr size_t source_count = 8;
+
+const char* source_name(const Source source);
+
+/* Bucket n counts handler runs shorter than bucket_limit_us(n); the last
+ * bucket is open ended. Limits grow by 4x: 32us, 128us, 512us, 2ms, ... */
+constexpr size_t bucket_count = 8;
+
+constexpr uint32_t bucket_limit_us(const size_t n) {
+    return 32UL << (2 * n);
+}
+
+constexpr size_t bucket_of(const uint32_t us) {
+    size_t n = 0;
+    while (n < bucket_count - 1 && us >= bucket_limit_us(n))
+        n++;
+    return n;
+}
+
+/* Run time histogram of one handler. Counts saturate rather than wrap. */
+class Histogram {
+   public:
+    void add(const uint32_t us) {
+        auto& count = counts_[bucket_of(us)];
+        if (count < UINT16_MAX)
+            count++;
+        if (us > worst_us_)
+            worst_us_ = us;
+    }
+
+    uint32_t count(const size_t bucket) const {
+        return counts_[bucket];
+    }
+
+    uint32_t total() const {
+        uint32_t sum = 0;
+        for (const auto count : counts_)
+            sum += count;
+        return sum;
+    }
+
+    uint32_t worst_us() const {
+        return worst_us_;
+    }
+
+    void clear() {
+        counts_.fill(0);
+        worst_us_ = 0;
+    }
+
+   private:
+    std::array<uint16_t, bucket_count> counts_{};
+    uint32_t worst_us_{0};
+};
+
+/* Histograms per dispatch source and per message ID, plus how often the
+ * budgeted dispatch put work off to let input through. */
+template <size_t MessageCount>
+class Stats {
+   public:
+    void add(const Source source, const uint32_t us) {
+        sources_[static_cast<size_t>(source)].add(us);
+    }
+
+    void add_message(const size_t id, const uint32_t us) {
+        if (id < MessageCount)
+            messages_[id].add(us);
+    }
+
+    void add_deferral() {
+        deferrals_++;
+    }
+
+    const Histogram& source(const Source source) const {
+        return sources_[static_cast<size_t>(source)];
+    }
+
+    const Histogram& message(const size_t id) const {
+        return messages_[id];
+    }
+
+    uint32_t deferrals() const {
+        return deferrals_;
+    }
+
+    /* In place; a temporary Stats would be too big for the shell stack. */
+    void reset() {
+        for (auto& histogram : sources_)
+            histogram.clear();
+        for (auto& histogram : messages_)
+            histogram.clear();
+        deferrals_ = 0;
+    }
+
+   private:
+    std::array<Histogram, source_count> sources_{};
+    std::array<Histogram, MessageCount> messages_{};
+    uint32_t deferrals_{0};
+};
+
+/* Dispatch work is put off in budgeted mode once a dispatch round has run
+ * this long and input is waiting. */
+constexpr uint32_t budget_us = 8000;
+
+/* start is a core_timer::now() timestamp taken before the handler ran. */
+void add(const Source source, const uint32_t start);
+void add_message(const size_t id, const uint32_t start);
+void add_deferral();
+
+const Histogram& source(const Source source);
+const Histogram& message(const size_t id);
+size_t message_count();
+uint32_t deferrals();
+void reset();
+
+bool budgeted();
+void set_budgeted(const bool enabled);
+
+} /* namespace dispatch_stats */
+
+#endif /*__DISPATCH_STATS_H__*/
@@ -38,6 +38,9 @@
 #include "ch.h"
 
 #include "lpc43xx_cpp.hpp"
+#include "startup_trace.hpp"
+#include "dispatch_stats.hpp"
+#include "core_timer.hpp"
 using namespace lpc43xx;
 
 #include <array>
@@ -81,7 +84,9 @@ class MessageHandlerMap {
         if (message->id < Message::ID::MAX) {
             auto& fn = map_[toUType(message->id)];
             if (fn) {
+                const auto start = core_timer::now();
                 fn(message);
+                dispatch_stats::add_message(toUType(message->id), start);
             }
         }
     }
@@ -141,6 +146,9 @@ eventmask_t EventDispatcher::wait() {
 }
 
 void EventDispatcher::dispatch(const eventmask_t events) {
+    using dispatch_stats::Source;
+    dispatch_start = core_timer::now();
+
     if (shared_memory.m4_panic_msg[0] != 0) {
         if (shared_memory.bb_data.data[0] == 0)
             draw_guru_meditation(CORTEX_M4, shared_memory.m4_panic_msg);
@@ -155,11 +163,11 @@ void EventDispatcher::dispatch(const eventmask_t events) {
     handle_shell();
 
     if (events & EVT_MASK_APPLICATION) {
-        handle_application_queue();
+        timed(Source::Application, [this]() { handle_application_queue(); });
     }
 
     if (events & EVT_MASK_LOCAL) {
-        handle_local_queue();
+        timed(Source::Local, [this]() { handle_local_queue(); });
     }
 
     if (events & EVT_MASK_RTC_TICK) {
@@ -167,14 +175,16 @@ void EventDispatcher::dispatch(const eventmask_t events) {
         if (portapack::init_error != nullptr && ++delayed_error > 1)
             draw_guru_meditation(CORTEX_M4, portapack::init_error);
 
-        handle_rtc_tick();
+        timed(Source::RtcTick, [this]() { handle_rtc_tick(); });
     }
 
-    handle_usb_transfer();
-    handle_usb();
+    timed(Source::Usb, [this]() {
+        handle_usb_transfer();
+        handle_usb();
+    });
 
     if (events & EVT_MASK_SWITCHES) {
-        handle_switches();
+        timed(Source::Switches, [this]() { handle_switches(); });
     }
 
     /*if( events & EVT_MASK_LCD_FRAME_SYNC ) {
@@ -183,23 +193,56 @@ void EventDispatcher::dispatch(const eventmask_t events) {
 
     if (!EventDispatcher::display_sleep) {
         if (events & EVT_MASK_LCD_FRAME_SYNC) {
-            handle_lcd_frame_sync();
+            // Let pending input through first if this round already ran long;
+            // the repaint is put off by one round at most.
+            if (over_budget() && !paint_deferred) {
+                paint_deferred = true;
+                dispatch_stats::add_deferral();
+                events_flag(EVT_MASK_LCD_FRAME_SYNC);
+            } else {
+                paint_deferred = false;
+                timed(Source::FrameSync, [this]() { handle_lcd_frame_sync(); });
+            }
         }
 
         if (events & EVT_MASK_ENCODER) {
-            handle_encoder();
+            timed(Source::Encoder, [this]() { handle_encoder(); });
         }
 
         if (events & EVT_MASK_TOUCH) {
-            handle_touch();
+            timed(Source::Touch, [this]() { handle_touch(); });
         }
     }
 }
 
+template <typename Fn>
+void EventDispatcher::timed(const dispatch_stats::Source source, Fn fn) {
+    const auto start = core_timer::now();
+    fn();
+    dispatch_stats::add(source, start);
+}
+
+/* True in budgeted mode once this dispatch round has used up its budget while
+ * input events are waiting to be handled. */
+bool EventDispatcher::over_budget() const {
+    constexpr eventmask_t input_events = EVT_MASK_SWITCHES | EVT_MASK_ENCODER | EVT_MASK_TOUCH;
+    return dispatch_stats::budgeted() &&
+           (core_timer::elapsed_us(dispatch_start) >= dispatch_stats::budget_us) &&
+           (chThdSelf()->p_epending & input_events);
+}
+
 void EventDispatcher::handle_application_queue() {
-    shared_memory.application_queue.handle([](Message* const message) {
-        message_map.send(message);
-    });
+    const bool drained = shared_memory.application_queue.handle_while(
+        [](Message* const message) {
+            message_map.send(message);
+        },
+        [this]() { return !over_budget(); });
+
+    if (!drained) {
+        // Pick up the rest after the waiting input has been handled.
+        dispatch_stats::add_deferral();
+        events_flag(EVT_MASK_APPLICATION);
+    }
 }
 
 void EventDispatcher::handle_local_queue() {
@@ -336,6 +379,7 @@ void EventDispatcher::handle_lcd_frame_sync() {
 
     static_cast<ui::SystemView*>(top_widget)->paint_overlay();
     painter.paint_widget_tree(top_widget);
+    startup_trace::mark(startup_trace::Stage::FirstPaint);
 
     portapack::backlight()->on();
 
@@ -31,6 +31,7 @@
 #include "portapack_shared_memory.hpp"
 
 #include "message.hpp"
+#include "dispatch_stats.hpp"
 
 #include "touch.hpp"
 
@@ -115,9 +116,16 @@ class EventDispatcher {
     ui::TouchEvent* volatile injected_touch_event = nullptr;
     ui::KeyboardEvent* volatile injected_keyboard_event = nullptr;
 
+    uint32_t dispatch_start = 0;
+    bool paint_deferred = false;
+
     eventmask_t wait();
     void dispatch(const eventmask_t events);
 
+    template <typename Fn>
+    void timed(const dispatch_stats::Source source, Fn fn);
+    bool over_budget() const;
+
     void handle_application_queue();
     void handle_local_queue();
     void handle_rtc_tick();
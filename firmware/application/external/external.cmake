@@ -76,6 +76,7 @@ set(EXTCPPSRC
 	#wardrivemap
 	external/wardrivemap/main.cpp
 	external/wardrivemap/ui_wardrivemap.cpp
+	external/wardrivemap/geo_index.cpp
 
 	#tpmsrx
 	external/tpmsrx/main.cpp
@@ -324,9 +324,9 @@ size_t LevelView::change_mode(freqman_index_t new_mod) {
     return step_mode.selected_index();
 }
 
-void LevelView::handle_coded_squelch(const uint32_t value) {
+void LevelView::handle_coded_squelch(const CodedSquelchMessage& message) {
     if (field_mode.selected_index() == NFM_MODULATION)
-        text_ctcss.set(tone_key_string_by_value(value, text_ctcss.parent_rect().width() / 8));
+        text_ctcss.set(coded_squelch_string(message, text_ctcss.parent_rect().width() / 8));
     else
         text_ctcss.set("        ");
 }
@@ -27,6 +27,7 @@
 #include "ui_fileman.hpp"
 #include "ui_freqman.hpp"
 #include "file_path.hpp"
+#include "portapack_shared_memory.hpp"
 
 using namespace ui;
 using namespace portapack;
@@ -101,6 +102,27 @@ void ScannerThread::set_scanning_direction(bool fwd) {
     }
 }
 
+// Set by the view once it evaluated a settled measurement of the current frequency
+void ScannerThread::set_settled_epoch(const uint32_t v) {
+    _settled_epoch = v;
+}
+
+// After a retune, move on as soon as the view has seen a settled measurement
+// of the new frequency instead of always waiting the worst case.
+void ScannerThread::wait_settled(const bool retuned) {
+    if (!retuned) {
+        chThdSleepMilliseconds(SCANNER_SLEEP_MS);
+        return;
+    }
+
+    const uint32_t epoch = shared_memory.retune_epoch;
+    for (uint32_t ms = 0; ms < SCANNER_SLEEP_MS; ms++) {
+        if (_settled_epoch == epoch || chThdShouldTerminate())
+            break;
+        chThdSleepMilliseconds(1);
+    }
+}
+
 msg_t ScannerThread::static_fn(void* arg) {
     auto obj = static_cast<ScannerThread*>(arg);
     obj->run();
@@ -115,6 +137,7 @@ void ScannerThread::run() {
         int32_t frequency_index = (_stepper > 0) ? size : 0;  // Forcing wraparound to starting frequency on 1st pass
 
         while (!chThdShouldTerminate()) {
+            bool retuned = false;
             bool force_one_step = (_index_stepper != 0);
             int32_t step = force_one_step ? _index_stepper : _stepper;  //_index_stepper direction takes priority
 
@@ -130,6 +153,7 @@ void ScannerThread::run() {
                         _index_stepper = 0;
 
                     receiver_model.set_target_frequency(frequency_list_[frequency_index]);  // Retune
+                    retuned = true;
                 }
                 message.freq = frequency_list_[frequency_index];
                 message.range = frequency_index;  // Inform freq (for coloring purposes also!)
@@ -145,7 +169,7 @@ void ScannerThread::run() {
                 _freq_del = 0;  // deleted.
             }
 
-            chThdSleepMilliseconds(SCANNER_SLEEP_MS);  // Needed to (eventually) stabilize the receiver into new freq
+            wait_settled(retuned);  // Wait for the receiver to stabilize into new freq
         }
     } else if (_manual_search && (def_step_hz_ > 0))  // manual search range mode
     {
@@ -153,6 +177,7 @@ void ScannerThread::run() {
         int64_t frequency_index = (_stepper > 0) ? size : 0;  // Forcing wraparound to starting frequency on 1st pass
 
         while (!chThdShouldTerminate()) {
+            bool retuned = false;
             bool force_one_step = (_index_stepper != 0);
             int32_t step = force_one_step ? _index_stepper : _stepper;  //_index_stepper direction takes priority
 
@@ -168,13 +193,14 @@ void ScannerThread::run() {
                         _index_stepper = 0;
 
                     receiver_model.set_target_frequency(frequency_range_.min + frequency_index * def_step_hz_);  // Retune
+                    retuned = true;
                 }
                 message.freq = frequency_range_.min + frequency_index * def_step_hz_;
                 message.range = 0;  // Inform freq (for coloring purposes also!)
                 EventDispatcher::send_message(message);
             }
 
-            chThdSleepMilliseconds(SCANNER_SLEEP_MS);  // Needed to (eventually) stabilize the receiver into new freq
+            wait_settled(retuned);  // Wait for the receiver to stabilize into new freq
         }
     }
 }
@@ -237,8 +263,9 @@ void ScannerView::handle_retune(int64_t freq, uint32_t freq_idx) {
         if (entries.size() > 0)
             field_current_index.set_text(to_string_dec_uint(freq_idx + 1, 3));
 
-        if (freq_idx < entries.size() && entries[freq_idx].description.size() > 1)
-            text_current_desc.set(entries[freq_idx].description);  // Show description from file
+        auto description = freq_idx < entries.size() ? entry_description(entries[freq_idx]) : std::string{};
+        if (description.size() > 1)
+            text_current_desc.set(description);  // Show description from file
         else
             text_current_desc.set(loaded_filename());  // Show Scan file name (no description in file)
     }
@@ -265,6 +292,19 @@ std::string ScannerView::loaded_filename() const {
     return filename;
 }
 
+std::string ScannerView::entry_description(const scanner_entry_t& entry) const {
+    if (entry.list_index == scanner_entry_t::no_entry || entry.list_index >= freqman_list.size())
+        return {};
+
+    const auto& item = freqman_list[entry.list_index];
+    std::string description{freqman_list.description(item)};
+
+    if (item.type == freqman_type::HamRadio)
+        return (entry.freq == item.frequency_a ? "R: " : "T: ") + description;
+
+    return description;
+}
+
 void ScannerView::focus() {
     button_load.focus();
 }
@@ -353,6 +393,7 @@ ScannerView::ScannerView(
         if (scan_thread && entries.size()) {
             scan_thread->stop();  // STOP SCANNER THREAD
             entries.clear();
+            freqman_list.clear();
 
             show_max_index();  // UPDATE new list size on screen
             field_current_index.set_text("");
@@ -514,7 +555,7 @@ ScannerView::ScannerView(
                 // Note that we are allowing freqs to be added to file (code above) that exceed the
                 // max count we can load into memory.
                 if (entries.size() < FREQMAN_MAX_PER_FILE) {
-                    entries.push_back({current_frequency, ""});
+                    entries.push_back({current_frequency, scanner_entry_t::no_entry});
                     show_max_index();  // Display updated frequency list size
                 }
             }
@@ -547,8 +588,10 @@ void ScannerView::frequency_file_load(const fs::path& path) {
     freqman_index_t def_bw_index{freqman_invalid_index};
     freqman_index_t def_step_index{freqman_invalid_index};
 
-    FreqmanDB db;
-    if (!db.open(path)) {
+    freqman_load_options options{.max_entries = FREQMAN_MAX_PER_FILE};
+    if (!load_freqman_list(path, freqman_list, options)) {
+        // The list was cleared, drop the entries that pointed into it.
+        entries.clear();
         text_current_desc.set("NO " + path.filename().string());
         return;
     }
@@ -557,7 +600,9 @@ void ScannerView::frequency_file_load(const fs::path& path) {
     freqman_file = path.stem().string();
     Optional<scanner_range_t> range;
 
-    for (auto entry : db) {
+    for (FreqmanList::Index i = 0; i < freqman_list.size(); ++i) {
+        const auto& entry = freqman_list[i];
+
         if (is_invalid(def_mod_index))
             def_mod_index = entry.modulation;
 
@@ -570,11 +615,11 @@ void ScannerView::frequency_file_load(const fs::path& path) {
         switch (entry.type) {
             case freqman_type::Repeater:
             case freqman_type::Single:
-                entries.push_back({entry.frequency_a, entry.description});
+                entries.push_back({entry.frequency_a, i});
                 break;
             case freqman_type::HamRadio:
-                entries.push_back({entry.frequency_a, "R: " + entry.description});
-                entries.push_back({entry.frequency_b, "T: " + entry.description});
+                entries.push_back({entry.frequency_a, i});
+                entries.push_back({entry.frequency_b, i});
                 break;
             case freqman_type::Range:
                 // NB: Only the first range will be loaded.
@@ -627,6 +672,10 @@ void ScannerView::update_squelch_while_paused(int32_t max_db) {
 }
 
 void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
+    // Ignore measurements taken before the receiver settled on the current frequency.
+    if (!statistics.settled || (statistics.retune_epoch != shared_memory.retune_epoch))
+        return;
+
     if (userpause) {
         update_squelch_while_paused(statistics.max_db);
     } else if (scan_thread)  // Scanning not user-paused
@@ -669,6 +718,9 @@ void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
             }
         }
     }
+
+    if (scan_thread)
+        scan_thread->set_settled_epoch(statistics.retune_epoch);
 }
 
 void ScannerView::scan_pause() {
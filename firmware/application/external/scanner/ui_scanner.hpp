@@ -39,7 +39,7 @@ using namespace ui;
 
 namespace ui::external_app::scanner {
 
-#define SCANNER_SLEEP_MS 50  // ms that Scanner Thread sleeps per loop
+#define SCANNER_SLEEP_MS 50  // ms that Scanner Thread sleeps per loop (upper bound after a retune)
 #define STATISTICS_UPDATES_PER_SEC 10
 #define MAX_FREQ_LOCK 10  // # of 50ms cycles scanner locks into freq when signal detected, to verify signal is not spurious
 
@@ -50,10 +50,12 @@ namespace ui::external_app::scanner {
 // TODO: Too many functions mix work and UI update.
 // Consolidate UI fixup to a single function.
 
-// TODO: Just use freqman_entry.
 struct scanner_entry_t {
+    /* Value of list_index for frequencies not loaded from the file. */
+    static constexpr FreqmanList::Index no_entry = static_cast<FreqmanList::Index>(-1);
+
     rf::Frequency freq;
-    std::string description;
+    FreqmanList::Index list_index;
 };
 
 struct scanner_range_t {
@@ -76,6 +78,7 @@ class ScannerThread {
     void set_freq_del(const rf::Frequency v);
     void set_index_stepper(const int32_t v);
     void set_scanning_direction(bool fwd);
+    void set_settled_epoch(const uint32_t v);
 
     void stop();
 
@@ -97,8 +100,10 @@ class ScannerThread {
     uint32_t _freq_idx{0};
     int32_t _stepper{1};
     int32_t _index_stepper{0};
+    volatile uint32_t _settled_epoch{0};
     static msg_t static_fn(void* arg);
     void run();
+    void wait_settled(const bool retuned);
     void create_thread();
 };
 
@@ -150,6 +155,7 @@ class ScannerView : public View {
     void handle_retune(int64_t freq, uint32_t freq_idx);
     void handle_encoder(EncoderEvent delta);
     std::string loaded_filename() const;
+    std::string entry_description(const scanner_entry_t& entry) const;
 
     uint32_t browse_timer{0};
     uint32_t lock_timer{0};
@@ -157,6 +163,7 @@ class ScannerView : public View {
     int32_t bigdisplay_current_color{-2};
     rf::Frequency bigdisplay_current_frequency{0};
 
+    FreqmanList freqman_list{};
     std::vector<scanner_entry_t> entries{};
     uint32_t current_index{0};
     rf::Frequency current_frequency{0};
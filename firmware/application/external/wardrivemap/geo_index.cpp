@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "geo_index.hpp"
+
+#include "file_path.hpp"
+#include "metadata_file.hpp"
+#include "flipper_subfile.hpp"
+
+#include <cstring>
+
+namespace ui::external_app::wardrivemap {
+
+Optional<File::Error> GeoIndex::open(const std::filesystem::path& flippersub_dir) {
+    const auto error = file_.open(captures_dir / u"GEOINDEX.BIN", false, true);
+    if (error.is_valid())
+        return error;
+
+    const auto result = file_.read(&header_, sizeof(header_));
+    const bool valid = result.is_ok() && *result == sizeof(header_) && header_.magic == file_magic &&
+                       file_.size() >= sizeof(header_) + header_.record_count * sizeof(GeoRecord);
+
+    for (size_t pass = valid ? 0 : 1; pass < 2; pass++) {
+        if (pass == 1) {
+            // Start over, parsing every capture again.
+            header_ = {};
+            header_.magic = file_magic;
+            file_.seek(sizeof(header_));
+            file_.truncate();
+        }
+
+        if (update(Captures, captures_dir, u"*.txt") && update(FlipperSub, flippersub_dir, u"*.sub"))
+            break;
+    }
+
+    file_.seek(0);
+    const auto header_result = file_.write(&header_, sizeof(header_));
+    if (header_result.is_error())
+        return header_result.error();
+    file_.sync();
+
+    build_grid();
+    return {};
+}
+
+Optional<GeoRecord> GeoIndex::read(const uint16_t record) {
+    if (record >= header_.record_count)
+        return {};
+
+    GeoRecord result;
+    file_.seek(sizeof(header_) + record * sizeof(GeoRecord));
+    const auto read_result = file_.read(&result, sizeof(result));
+    if (read_result.is_error() || *read_result != sizeof(result))
+        return {};
+
+    result.name[sizeof(result.name) - 1] = 0;
+    return result;
+}
+
+/* Lists a directory, appending captures past the known prefix. Returns false
+ * if the prefix changed and the index has to be rebuilt. */
+bool GeoIndex::update(const Source source, const std::filesystem::path& dir, const std::filesystem::path& pattern) {
+    ListingPrefix prefix{header_.sources[source]};
+
+    for (const auto& entry : std::filesystem::directory_iterator(dir, pattern)) {
+        if (!std::filesystem::is_regular_file(entry.status()))
+            continue;
+
+        switch (prefix.add(entry.path().string())) {
+            case ListingPrefix::Name::Changed:
+                return false;
+            case ListingPrefix::Name::New:
+                append(dir, entry.path(), source);
+                break;
+            case ListingPrefix::Name::Known:
+                break;
+        }
+    }
+
+    if (!prefix.complete())
+        return false;
+
+    header_.sources[source] = prefix.known();
+    return true;
+}
+
+void GeoIndex::append(const std::filesystem::path& dir, const std::filesystem::path& name, const Source source) {
+    if (header_.record_count >= max_records)
+        return;
+
+    std::filesystem::path path = dir;
+    path += u"/" + name;
+
+    GeoRecord record{};
+    if (source == Captures) {
+        const auto metadata = read_metadata_file(get_metadata_path(path));
+        if (!metadata)
+            return;
+        record.lat = metadata->latitude;
+        record.lon = metadata->longitude;
+    } else {
+        const auto metadata = read_flippersub_file(path);
+        if (!metadata)
+            return;
+        record.lat = metadata->latitude;
+        record.lon = metadata->longitude;
+    }
+
+    if (!has_position(record.lat, record.lon))
+        return;
+
+    const auto tag = name.filename().string();
+    strncpy(record.name, tag.c_str(), sizeof(record.name) - 1);
+
+    file_.seek(sizeof(header_) + header_.record_count * sizeof(GeoRecord));
+    const auto result = file_.write(&record, sizeof(record));
+    if (result.is_ok() && *result == sizeof(record))
+        header_.record_count++;
+}
+
+void GeoIndex::build_grid() {
+    grid_.clear();
+
+    for (size_t pass = 0; pass < 2; pass++) {
+        if (pass == 1)
+            grid_.build();
+
+        for (uint16_t n = 0; n < header_.record_count; n++) {
+            const auto record = read(n);
+            if (!record)
+                continue;
+            if (pass == 0)
+                grid_.count(record->lat, record->lon);
+            else
+                grid_.place(n, record->lat, record->lon);
+        }
+    }
+}
+
+} /* namespace ui::external_app::wardrivemap */
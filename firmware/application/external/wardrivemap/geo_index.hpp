@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GEO_INDEX_H__
+#define __GEO_INDEX_H__
+
+#include "file.hpp"
+#include "optional.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ui::external_app::wardrivemap {
+
+/* Geotagged capture files, kept in captures_dir/GEOINDEX.BIN so the map
+ * doesn't parse every capture whenever the view changes.
+ *
+ * The file is a header and fixed size records in the order the captures
+ * were found. When the app opens, the capture directories are only listed:
+ * the header keeps how many files each directory had and a hash of their
+ * names, and as long as that prefix is unchanged just the files after it
+ * are parsed and appended. A deleted or renamed file rebuilds the index.
+ *
+ * In memory the records are bucketed into a grid of cells that holds only
+ * record numbers, so a viewport query reads the records of visible cells. */
+
+struct GeoRecord {
+    float lat;
+    float lon;
+    char name[40];
+};
+
+constexpr int32_t cells_per_degree = 8;
+
+constexpr uint32_t cell_key(const float lat, const float lon) {
+    const auto row = static_cast<uint32_t>((std::clamp(lat, -90.0f, 90.0f) + 90.0f) * cells_per_degree);
+    const auto column = static_cast<uint32_t>((std::clamp(lon, -180.0f, 180.0f) + 180.0f) * cells_per_degree);
+    return (row << 16) | column;
+}
+
+/* South west corner of a cell. */
+constexpr float cell_lat(const uint32_t key) {
+    return float(key >> 16) / cells_per_degree - 90.0f;
+}
+
+constexpr float cell_lon(const uint32_t key) {
+    return float(key & 0xffff) / cells_per_degree - 180.0f;
+}
+
+/* Same test the map has always used for a usable position. */
+constexpr bool has_position(const float lat, const float lon) {
+    return lat != 0 && lon != 0 && lat < 400 && lon < 400;
+}
+
+/* FNV-1a, fed one file name at a time. */
+constexpr uint32_t name_hash(uint32_t hash, const std::string_view name) {
+    for (const auto c : name)
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    return hash;
+}
+
+constexpr uint32_t name_hash_basis = 2166136261u;
+
+/* Checks a directory listing, one name at a time, against the number of
+ * files and the name hash kept from the last listing. Names past that
+ * prefix are new; a listing that no longer starts with it (a file deleted
+ * or renamed) calls for a rebuild. */
+class ListingPrefix {
+   public:
+    struct Known {
+        uint32_t files;
+        uint32_t hash;
+    };
+
+    enum class Name {
+        Known,
+        New,
+        Changed,
+    };
+
+    explicit constexpr ListingPrefix(const Known known)
+        : known_{known} {}
+
+    constexpr Name add(const std::string_view name) {
+        files_++;
+        hash_ = name_hash(hash_, name);
+        if (files_ == known_.files && hash_ != known_.hash)
+            return Name::Changed;
+        return (files_ > known_.files) ? Name::New : Name::Known;
+    }
+
+    /* After the last name: false if the listing is shorter than the prefix. */
+    constexpr bool complete() const {
+        return files_ >= known_.files;
+    }
+
+    /* What to keep for the next listing. */
+    constexpr Known known() const {
+        return {files_, hash_};
+    }
+
+   private:
+    Known known_;
+    uint32_t files_{0};
+    uint32_t hash_{name_hash_basis};
+};
+
+/* Record numbers bucketed by cell, cells sorted by key. Built in two passes
+ * over the same positions in the same order: count() each of them, build(),
+ * then place() each of them. */
+class GeoGrid {
+   public:
+    struct Cell {
+        uint32_t key;
+        uint16_t first;
+        uint16_t count;
+    };
+
+    void clear() {
+        cells_.clear();
+        records_.clear();
+    }
+
+    void count(const float lat, const float lon) {
+        const auto key = cell_key(lat, lon);
+        auto it = find(key);
+        if (it == cells_.end() || it->key != key)
+            it = cells_.insert(it, {key, 0, 0});
+        it->count++;
+    }
+
+    void build() {
+        uint16_t first = 0;
+        for (auto& cell : cells_) {
+            cell.first = first;
+            first += cell.count;
+            cell.count = 0;
+        }
+        records_.resize(first);
+    }
+
+    void place(const uint16_t record, const float lat, const float lon) {
+        const auto it = find(cell_key(lat, lon));
+        if (it == cells_.end())
+            return;
+        records_[it->first + it->count] = record;
+        it->count++;
+    }
+
+    const std::vector<Cell>& cells() const {
+        return cells_;
+    }
+
+    const uint16_t* records(const Cell& cell) const {
+        return &records_[cell.first];
+    }
+
+    size_t size() const {
+        return records_.size();
+    }
+
+   private:
+    std::vector<Cell> cells_{};
+    std::vector<uint16_t> records_{};
+
+    std::vector<Cell>::iterator find(const uint32_t key) {
+        return std::lower_bound(cells_.begin(), cells_.end(), key,
+                                [](const Cell& cell, const uint32_t k) { return cell.key < k; });
+    }
+};
+
+class GeoIndex {
+   public:
+    enum Source : uint8_t {
+        Captures = 0,
+        FlipperSub = 1,
+        SourceCount = 2,
+    };
+
+    /* Brings the file up to date with the capture directories and builds
+     * the grid. */
+    Optional<File::Error> open(const std::filesystem::path& flippersub_dir);
+
+    /* Number of geotagged captures. */
+    size_t size() const {
+        return grid_.size();
+    }
+
+    Optional<GeoRecord> read(const uint16_t record);
+
+    /* Calls on_record for every record in a cell that cell_in_view accepts,
+     * until it returns false. */
+    template <typename CellFilter, typename RecordHandler>
+    void query(CellFilter cell_in_view, RecordHandler on_record) {
+        constexpr float cell_size = 1.0f / cells_per_degree;
+        for (const auto& cell : grid_.cells()) {
+            const auto lat = cell_lat(cell.key);
+            const auto lon = cell_lon(cell.key);
+            if (!cell_in_view(lat, lon, lat + cell_size, lon + cell_size))
+                continue;
+
+            const auto records = grid_.records(cell);
+            for (size_t i = 0; i < cell.count; i++) {
+                const auto record = read(records[i]);
+                if (record && !on_record(*record))
+                    return;
+            }
+        }
+    }
+
+   private:
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t record_count;
+        ListingPrefix::Known sources[SourceCount];
+    };
+
+    static constexpr uint32_t file_magic = 0x31584947; /* "GIX1" */
+    static constexpr size_t max_records = 65535;
+
+    File file_{};
+    FileHeader header_{};
+    GeoGrid grid_{};
+
+    bool update(const Source source, const std::filesystem::path& dir, const std::filesystem::path& pattern);
+    void append(const std::filesystem::path& dir, const std::filesystem::path& name, const Source source);
+    void build_grid();
+};
+
+} /* namespace ui::external_app::wardrivemap */
+
+#endif /*__GEO_INDEX_H__*/
@@ -22,8 +22,6 @@
 #include "rtc_time.hpp"
 #include "string_format.hpp"
 #include "file_path.hpp"
-#include "metadata_file.hpp"
-#include "flipper_subfile.hpp"
 #include "portapack_persistent_memory.hpp"
 
 using namespace portapack;
@@ -35,75 +33,36 @@ void WardriveMapView::focus() {
     geopos.focus();
 }
 
-// needs to load on every map change, because won't store or draw all while marker is not in the current view.
-// todo optimize this somehow
+// Needs to load on every map change, since only markers in view are kept; answered from the geo index.
 void WardriveMapView::load_markers() {
     uint16_t displayed_cnt = 0;
     uint16_t cnt = 0;
-    geomap.clear_markers();
-    // serach for files with geotag, and add it to geomap as marker with tag. limit to N bc of mem limit.
-    for (const auto& entry : std::filesystem::directory_iterator(captures_dir, u"*.txt")) {
-        if (std::filesystem::is_regular_file(entry.status())) {
-            if (markers_counted && displayed_cnt > ui::GeoMap::NumMarkerListElements) return;  // only if not fist iteration, since then not counted all elements
-            std::filesystem::path pth = captures_dir;
-            pth += u"/" + entry.path();
-            auto metadata_path = get_metadata_path(pth);
-            auto metadata = read_metadata_file(metadata_path);
-
-            if (metadata) {
-                if (metadata.value().latitude != 0 && metadata.value().longitude != 0 && metadata.value().latitude < 400 && metadata.value().longitude < 400) {
-                    // skip nth
-                    if (marker_start <= cnt) {
-                        if (first_init == false) {
-                            // move map there before add, so will display this.
-                            geopos.set_report_change(false);
-                            geopos.set_lat(metadata.value().latitude);
-                            geopos.set_lon(metadata.value().longitude);
-                            geopos.set_report_change(true);
-                            geomap.move(metadata.value().longitude, metadata.value().latitude);
-                            first_init = true;
-                        }
-                        GeoMarker tmp{metadata.value().latitude, metadata.value().longitude, 400, entry.path().filename().string()};
-                        if (geomap.store_marker(tmp) == MapMarkerStored::MARKER_STORED) displayed_cnt++;
-                        if (!markers_counted) marker_cntall++;
-                    }
-                    cnt++;
-                }
-            }
-        }
-    }
-    // load flipper files too
-    for (const auto& entry : std::filesystem::directory_iterator(flippersub_dir, u"*.sub")) {
-        if (std::filesystem::is_regular_file(entry.status())) {
-            if (markers_counted && displayed_cnt > ui::GeoMap::NumMarkerListElements) return;  // only if not fist iteration, since then not counted all elements
-            std::filesystem::path pth = flippersub_dir;
-            pth += u"/" + entry.path();
-            auto metadata = read_flippersub_file(pth);
-
-            if (metadata) {
-                if (metadata.value().latitude != 0 && metadata.value().longitude != 0 && metadata.value().latitude < 400 && metadata.value().longitude < 400) {
-                    // skip nth
-                    if (marker_start <= cnt) {
-                        if (first_init == false) {
-                            // move map there before add, so will display this.
-                            geopos.set_report_change(false);
-                            geopos.set_lat(metadata.value().latitude);
-                            geopos.set_lon(metadata.value().longitude);
-                            geopos.set_report_change(true);
-                            geomap.move(metadata.value().longitude, metadata.value().latitude);
-                            first_init = true;
-                        }
-                        GeoMarker tmp{metadata.value().latitude, metadata.value().longitude, 400, entry.path().filename().string()};
-                        if (geomap.store_marker(tmp) == MapMarkerStored::MARKER_STORED) displayed_cnt++;
-                        if (!markers_counted) marker_cntall++;
-                    }
-                    cnt++;
+
+    for (;;) {
+        displayed_cnt = 0;
+        cnt = 0;
+        geomap.clear_markers();
+        index.query(
+            [this](float lat_min, float lon_min, float lat_max, float lon_max) {
+                return geomap.area_in_view(lat_min, lon_min, lat_max, lon_max);
+            },
+            [this, &displayed_cnt, &cnt](const GeoRecord& record) {
+                if (!geomap.in_view(record.lat, record.lon)) return true;
+                // skip nth
+                if (marker_start <= cnt) {
+                    GeoMarker tmp{record.lat, record.lon, 400, record.name};
+                    if (geomap.store_marker(tmp) == MapMarkerStored::MARKER_STORED) displayed_cnt++;
                 }
-            }
-        }
+                cnt++;
+                return true;  // keep going to count all markers in view
+            });
+
+        // the view moved away from the current page
+        if (displayed_cnt > 0 || marker_start == 0) break;
+        marker_start = 0;
     }
 
-    markers_counted = true;
+    marker_cntall = cnt;
     // show / hide paginator buttons
     btn_back.hidden((marker_start == 0) || (marker_cntall == 0));
     btn_next.hidden(((marker_start + ui::GeoMap::NumMarkerListElements) >= marker_cntall) || (marker_cntall == 0));
@@ -146,8 +105,18 @@ WardriveMapView::WardriveMapView(NavigationView& nav)
         geomap.set_dirty();
     };
     geomap.init();
-    load_markers();
-    if (marker_cntall > 0) {
+    const auto index_error = index.open(flippersub_dir);
+    if (index.size() > 0) {
+        // center the map on the first marker
+        const auto first = index.read(0);
+        if (first) {
+            geopos.set_report_change(false);
+            geopos.set_lat(first->lat);
+            geopos.set_lon(first->lon);
+            geopos.set_report_change(true);
+            geomap.move(first->lon, first->lat);
+        }
+        load_markers();
         text_notfound.hidden(true);
         geomap.set_dirty();
     } else {
@@ -155,6 +124,8 @@ WardriveMapView::WardriveMapView(NavigationView& nav)
         geopos.hidden(true);
         text_notfound.hidden(false);
         text_info.hidden(true);
+        if (index_error)
+            text_notfound.set("Index error: " + index_error->what());
     }
 
     // never move this before the first load() bc that will mess load up
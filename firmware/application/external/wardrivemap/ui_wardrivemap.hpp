@@ -28,6 +28,7 @@
 #include "ui_geomap.hpp"
 #include "app_settings.hpp"
 #include "utility.hpp"
+#include "geo_index.hpp"
 
 using namespace ui;
 
@@ -62,12 +63,11 @@ class WardriveMapView : public View {
     void on_gps(const GPSPosDataMessage* msg);
     void on_orientation(const OrientationDataMessage* msg);
 
-    void load_markers();  // returns true if any exists, false if none.
+    void load_markers();
 
-    bool first_init = false;       // to center map to first marker, before callback is set
-    bool markers_counted = false;  // to iterate all files on first, but only on first.
-    uint16_t marker_start = 0;     // for paginator, this will be the first displayed
-    uint16_t marker_cntall = 0;    // all geotagged marker count
+    GeoIndex index{};
+    uint16_t marker_start = 0;   // for paginator, this will be the first displayed
+    uint16_t marker_cntall = 0;  // geotagged markers in view
 
     MessageHandlerRegistration message_handler_gps{
         Message::ID::GPSPosData,
@@ -26,6 +26,7 @@
 #include "audio.hpp"
 #include "baseband_api.hpp"
 #include "string_format.hpp"
+#include "portapack_persistent_memory.hpp"
 
 using namespace portapack;
 using namespace ui;
@@ -47,17 +48,15 @@ void ViewWavView::refresh_waveform() {
         return;
     }
 
-    uint8_t bits_per_sample = wav_reader->bits_per_sample();
+    // Zoomed out far enough, read the peak file level matching the scale.
+    std::array<wav_peaks::Peak, 240> pixel_peaks;
+    if (!has_peaks || !peaks.read(position, scale, pixel_peaks.data(), pixel_peaks.size()))
+        read_samples_peaks(position, scale, pixel_peaks.data(), pixel_peaks.size());
 
-    for (size_t i = 0; i < 240; i++) {
-        wav_reader->data_seek(position + (i * scale));
-        if (bits_per_sample == 8) {
-            uint8_t sample;
-            wav_reader->read(&sample, 1);
-            waveform_buffer[i] = (sample - 0x80) * 256;
-        } else {
-            wav_reader->read(&waveform_buffer[i], 2);
-        }
+    for (size_t i = 0; i < pixel_peaks.size(); i++) {
+        const auto& peak = pixel_peaks[i];
+        waveform_buffer[2 * i] = peak.empty() ? 0 : peak.min;
+        waveform_buffer[2 * i + 1] = peak.empty() ? 0 : peak.max;
     }
 
     waveform.set_dirty();
@@ -71,6 +70,96 @@ void ViewWavView::refresh_waveform() {
     display.draw_line({239, 10 * 16 + 1}, {(Coord)(w_start + w_width), 21 * 8}, Theme::getInstance()->bg_darkest->foreground);
 }
 
+// min/max of each run of step samples, read straight from the file
+void ViewWavView::read_samples_peaks(uint64_t first, uint32_t step, wav_peaks::Peak* out, size_t n) {
+    const bool is_8bit = wav_reader->bits_per_sample() == 8;
+    std::array<uint8_t, 512> buffer;
+
+    wav_reader->data_seek(first);
+    for (size_t i = 0; i < n; i++) {
+        wav_peaks::Peak peak{};
+        // A pixel's samples follow on from the previous pixel's, so one seek will do
+        // while step is small. Wider pixels (only without a peak file) seek to each
+        // pixel and use its first buffer full of samples.
+        if (step > buffer.size())
+            wav_reader->data_seek(first + i * step);
+
+        uint32_t remaining = std::min<uint32_t>(step, buffer.size());
+        while (remaining > 0) {
+            const uint32_t bytes_per_sample = is_8bit ? 1 : 2;
+            const auto wanted = std::min<uint32_t>(remaining, buffer.size() / bytes_per_sample);
+            const auto result = wav_reader->read(buffer.data(), wanted * bytes_per_sample);
+            if (result.is_error() || result.value() == 0)
+                break;
+
+            const uint32_t got = result.value() / bytes_per_sample;
+            for (uint32_t k = 0; k < got; k++) {
+                if (is_8bit)
+                    peak.add((buffer[k] - 0x80) * 256);
+                else
+                    peak.add(reinterpret_cast<const int16_t*>(buffer.data())[k]);
+            }
+            remaining -= got;
+        }
+        out[i] = peak;
+    }
+}
+
+// For files recorded without a peak file, when peak files are enabled in
+// Settings > SD Card.
+void ViewWavView::start_peaks(const std::filesystem::path& file_path) {
+    peak_writer = std::make_unique<wav_peaks::PeakWriter>();
+    if (peak_writer->create(file_path).is_valid()) {
+        peak_writer.reset();
+        return;
+    }
+    peak_samples_done = 0;
+    progressbar.set_max(wav_reader->sample_count());
+    progressbar.set_value(0);
+}
+
+// One streaming pass over the samples, spread over frame syncs; the waveform
+// is read from the samples until it's done.
+void ViewWavView::build_peaks() {
+    // The progress bar is the playback's meanwhile.
+    if (playback_in_progress)
+        return;
+
+    const bool is_8bit = wav_reader->bits_per_sample() == 8;
+    const uint32_t bytes_per_sample = is_8bit ? 1 : 2;
+    const uint32_t sample_count = wav_reader->sample_count();
+    std::array<uint8_t, 512> buffer;
+
+    wav_reader->data_seek(peak_samples_done);
+    for (size_t n = 0; n < peak_reads_per_frame && peak_samples_done < sample_count; n++) {
+        const auto wanted = std::min<uint32_t>(sample_count - peak_samples_done, buffer.size() / bytes_per_sample);
+        const auto result = wav_reader->read(buffer.data(), wanted * bytes_per_sample);
+        if (result.is_error() || result.value() == 0) {
+            // Finish short; the reader won't take it and the next open retries.
+            peak_samples_done = sample_count;
+            break;
+        }
+
+        const uint32_t got = result.value() / bytes_per_sample;
+        if (is_8bit)
+            peak_writer->add(buffer.data(), got);
+        else
+            peak_writer->add(reinterpret_cast<const int16_t*>(buffer.data()), got);
+        peak_samples_done += got;
+    }
+    progressbar.set_value(peak_samples_done);
+    if (peak_samples_done < sample_count)
+        return;
+
+    peak_writer->finish();
+    peak_writer.reset();
+    progressbar.set_value(0);
+
+    has_peaks = peaks.open(wav_file_path, sample_count);
+    refresh_overview();
+    refresh_waveform();
+}
+
 void ViewWavView::refresh_measurements() {
     uint64_t span_ns = ns_per_pixel * abs(field_cursor_b.value() - field_cursor_a.value());
 
@@ -113,8 +202,6 @@ void ViewWavView::on_pos_sample_changed() {
 }
 
 void ViewWavView::load_wav(std::filesystem::path file_path) {
-    uint32_t average;
-
     wav_file_path = file_path;
 
     text_filename.set(file_path.filename().string());
@@ -127,33 +214,34 @@ void ViewWavView::load_wav(std::filesystem::path file_path) {
     text_bits_per_sample.set(to_string_dec_uint(wav_reader->bits_per_sample(), 2));
     text_title.set(wav_reader->title());
 
-    // Fill amplitude buffer, world's worst downsampling
-    uint64_t skip = wav_reader->sample_count() / (240 * subsampling_factor);
-    uint8_t bits_per_sample = wav_reader->bits_per_sample();
-
-    for (size_t i = 0; i < 240; i++) {
-        average = 0;
-
-        for (size_t s = 0; s < subsampling_factor; s++) {
-            wav_reader->data_seek(((i * subsampling_factor) + s) * skip);
-            if (bits_per_sample == 8) {
-                uint8_t sample;
-                wav_reader->read(&sample, 1);
-                average += sample / 2;
-            } else {
-                int16_t sample;
-                wav_reader->read(&sample, 2);
-                average += (abs(sample) >> 8);
-            }
-        }
+    // Use the peak file, making it in the background first if enabled.
+    peak_writer.reset();
+    has_peaks = peaks.open(file_path, wav_reader->sample_count());
+    if (!has_peaks && portapack::persistent_memory::config_wav_peak_files())
+        start_peaks(file_path);
 
-        amplitude_buffer[i] = average / subsampling_factor;
-    }
+    refresh_overview();
 
     reset_controls();
     update_scale(1);
 }
 
+// Amplitude overview of the whole file, exact from the peak file and
+// sampled from the start of each pixel's run without one.
+void ViewWavView::refresh_overview() {
+    const uint32_t step = std::max<uint32_t>(wav_reader->sample_count() / 240, 1);
+    std::array<wav_peaks::Peak, 240> pixel_peaks;
+    if (!has_peaks || !peaks.read(0, step, pixel_peaks.data(), pixel_peaks.size()))
+        read_samples_peaks(0, step, pixel_peaks.data(), pixel_peaks.size());
+
+    for (size_t i = 0; i < 240; i++) {
+        const auto& peak = pixel_peaks[i];
+        const int32_t amplitude = peak.empty() ? 0 : std::max(std::abs((int32_t)peak.min), std::abs((int32_t)peak.max));
+        amplitude_buffer[i] = std::min<int32_t>(amplitude >> 8, 127);
+    }
+    set_dirty();
+}
+
 void ViewWavView::reset_controls() {
     field_scale.set_value(1);
     field_pos_seconds.set_value(0);
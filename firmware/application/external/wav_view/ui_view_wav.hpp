@@ -47,7 +47,6 @@ class ViewWavView : public View {
         "wav_viewer", app_settings::Mode::NO_RF};
 
     NavigationView& nav_;
-    static constexpr uint32_t subsampling_factor = 8;
 
     void update_scale(int32_t new_scale);
     void refresh_waveform();
@@ -55,6 +54,10 @@ class ViewWavView : public View {
     void on_pos_time_changed();
     void on_pos_sample_changed();
     void load_wav(std::filesystem::path file_path);
+    void start_peaks(const std::filesystem::path& file_path);
+    void build_peaks();
+    void refresh_overview();
+    void read_samples_peaks(uint64_t first, uint32_t step, wav_peaks::Peak* out, size_t n);
     void reset_controls();
     bool is_active();
     void stop();
@@ -73,7 +76,16 @@ class ViewWavView : public View {
 
     std::unique_ptr<WAVFileReader> wav_reader{};
 
-    int16_t waveform_buffer[240]{};
+    wav_peaks::PeakReader peaks{};
+    bool has_peaks{false};
+
+    // A peak file being built, a few reads per frame so the UI keeps going.
+    static constexpr size_t peak_reads_per_frame = 16;
+    std::unique_ptr<wav_peaks::PeakWriter> peak_writer{};
+    uint32_t peak_samples_done{0};
+
+    // min/max pairs, one per pixel
+    int16_t waveform_buffer[2 * 240]{};
     uint8_t amplitude_buffer[240]{};
     int32_t scale{1};
     uint64_t ns_per_pixel{};
@@ -123,7 +135,7 @@ class ViewWavView : public View {
     Waveform waveform{
         {0, 5 * 16, screen_width, 64},
         waveform_buffer,
-        240,
+        2 * 240,
         0,
         false,
         Theme::getInstance()->bg_darkest->foreground};
@@ -180,6 +192,13 @@ class ViewWavView : public View {
         {7 * 8, 16 * 16, screen_width, 16},
         "-"};
 
+    MessageHandlerRegistration message_handler_frame_sync{
+        Message::ID::DisplayFrameSync,
+        [this](const Message* const) {
+            if (this->peak_writer)
+                this->build_peaks();
+        }};
+
     MessageHandlerRegistration message_handler_replay_thread_error{
         Message::ID::ReplayThreadDone,
         [this](const Message* const p) {
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __EXTERNAL_APP_CATALOG_H__
+#define __EXTERNAL_APP_CATALOG_H__
+
+#include "file.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum class external_app_kind : uint8_t {
+    Application = 0, /* .ppma */
+    Standalone = 1,  /* .ppmp */
+};
+
+/* Everything the menus need from an app file's header, plus the name,
+ * size and modification time of the file it was read from. An entry is
+ * only trusted while the file on the SD card still has the same stamp. */
+struct external_app_catalog_entry {
+    static constexpr size_t max_file_name = 32;
+
+    char16_t file_name[max_file_name];  // NUL padded, not always terminated.
+    uint32_t file_size;
+    uint16_t file_date;
+    uint16_t file_time;
+
+    external_app_kind kind;
+    uint8_t reserved[3];
+    uint32_t header_version;
+    uint32_t app_version;  // Unused for standalone apps.
+    uint32_t menu_location;
+    int32_t desired_menu_position;
+    uint32_t icon_color;
+    uint8_t app_name[16];
+    uint8_t bitmap_data[32];
+
+    /* Returns false if the name is too long to be cached. */
+    bool set_file_name(const std::filesystem::path::string_type& name) {
+        if (name.size() > max_file_name)
+            return false;
+        std::memset(file_name, 0, sizeof(file_name));
+        std::memcpy(file_name, name.data(), name.size() * sizeof(char16_t));
+        return true;
+    }
+
+    std::filesystem::path path() const {
+        size_t length = 0;
+        while (length < max_file_name && file_name[length] != 0)
+            length++;
+        return {&file_name[0], &file_name[length]};
+    }
+
+    bool matches(external_app_kind other_kind, const std::filesystem::path::string_type& name, uint32_t size, uint16_t date, uint16_t time) const {
+        if (kind != other_kind || file_size != size || file_date != date || file_time != time)
+            return false;
+        if (name.size() > max_file_name)
+            return false;
+        if (name.size() < max_file_name && file_name[name.size()] != 0)
+            return false;
+        return std::memcmp(file_name, name.data(), name.size() * sizeof(char16_t)) == 0;
+    }
+};
+
+static_assert(sizeof(external_app_catalog_entry) == 144, "Catalog entry layout changed, bump ExternalAppCatalog::version.");
+
+/* Cache of external app headers, stored in the apps directory so that
+ * opening a menu is one sequential read instead of opening every app
+ * file. To validate it, look every app file up with find(), update() the
+ * ones that miss from the file's header, prune() the ones that are gone
+ * and write() the catalog back if it changed(). */
+class ExternalAppCatalog {
+   public:
+    static constexpr uint32_t magic = 0x43505050;  // "PPPC"
+    static constexpr uint16_t version = 1;
+    /* 96 entries take 13.5KB of heap while a menu loads, room for about
+     * half again as many apps as are built. Apps beyond that are read
+     * from their own headers. */
+    static constexpr uint32_t max_entries = 96;
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t entry_size;
+        uint32_t entry_count;
+    };
+
+    using Entries = std::vector<external_app_catalog_entry>;
+
+    const Entries& entries() const { return entries_; }
+    size_t size() const { return entries_.size(); }
+    bool changed() const { return changed_; }
+
+    /* Reads a catalog file in a single read. Returns false and leaves the
+     * catalog empty if the file is missing, truncated or stale, or if its
+     * entry count doesn't match the file size. */
+    template <typename TFile>
+    bool read(TFile& file) {
+        entries_.clear();
+        seen_.clear();
+        next_ = 0;
+        changed_ = false;
+
+        Header header{};
+        auto header_read = file.read(&header, sizeof(header));
+        if (!header_read || *header_read != sizeof(header))
+            return false;
+
+        if (header.magic != magic ||
+            header.version != version ||
+            header.entry_size != sizeof(external_app_catalog_entry) ||
+            header.entry_count > max_entries)
+            return false;
+
+        const auto bytes = header.entry_count * sizeof(external_app_catalog_entry);
+        if (file.size() != sizeof(header) + bytes)
+            return false;
+
+        entries_.resize(header.entry_count);
+        if (bytes > 0) {
+            auto entries_read = file.read(entries_.data(), bytes);
+            if (!entries_read || *entries_read != bytes) {
+                entries_.clear();
+                return false;
+            }
+        }
+
+        seen_.resize(entries_.size(), false);
+        return true;
+    }
+
+    /* Writes the catalog; the header goes last so an interrupted write is
+     * never mistaken for a valid catalog. */
+    template <typename TFile>
+    bool write(TFile& file) const {
+        Header header{magic, version, sizeof(external_app_catalog_entry), static_cast<uint32_t>(entries_.size())};
+
+        file.seek(sizeof(header));
+        if (!entries_.empty()) {
+            auto written = file.write(entries_.data(), entries_.size() * sizeof(external_app_catalog_entry));
+            if (!written)
+                return false;
+        }
+
+        file.seek(0);
+        return file.write(&header, sizeof(header)).is_ok();
+    }
+
+    /* Returns the entry for a file if its stamp still matches, else
+     * nullptr. Directory order is stable, so the search starts after the
+     * previous hit and is usually a single compare. */
+    const external_app_catalog_entry* find(
+        external_app_kind kind,
+        const std::filesystem::path::string_type& name,
+        uint32_t size,
+        uint16_t date,
+        uint16_t time) {
+        const auto count = entries_.size();
+        for (size_t i = 0; i < count; i++) {
+            const auto index = (next_ + i) % count;
+            if (entries_[index].matches(kind, name, size, date, time)) {
+                seen_[index] = true;
+                next_ = index + 1;
+                return &entries_[index];
+            }
+        }
+        return nullptr;
+    }
+
+    /* Adds the entry for a new file, or replaces the stale entry for a
+     * file that changed. Returns false if the catalog is full. */
+    bool update(const external_app_catalog_entry& entry) {
+        for (size_t i = 0; i < entries_.size(); i++) {
+            if (entries_[i].kind == entry.kind &&
+                std::memcmp(entries_[i].file_name, entry.file_name, sizeof(entry.file_name)) == 0) {
+                entries_[i] = entry;
+                seen_[i] = true;
+                changed_ = true;
+                return true;
+            }
+        }
+        if (entries_.size() >= max_entries)
+            return false;
+
+        entries_.push_back(entry);
+        seen_.push_back(true);
+        changed_ = true;
+        return true;
+    }
+
+    /* Drops the entries of files that weren't found since read(). */
+    void prune() {
+        size_t kept = 0;
+        for (size_t i = 0; i < entries_.size(); i++) {
+            if (seen_[i])
+                entries_[kept++] = entries_[i];
+        }
+        if (kept != entries_.size()) {
+            entries_.resize(kept);
+            changed_ = true;
+        }
+        seen_.assign(kept, true);
+    }
+
+   private:
+    Entries entries_{};
+    std::vector<bool> seen_{};
+    size_t next_{0};
+    bool changed_{false};
+};
+
+#endif /*__EXTERNAL_APP_CATALOG_H__*/
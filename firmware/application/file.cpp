@@ -330,7 +330,7 @@ std::filesystem::filesystem_error copy_file(
 }
 
 FATTimestamp file_created_date(const std::filesystem::path& file_path) {
-    FILINFO filinfo;
+    FILINFO filinfo{};
 
     f_stat(reinterpret_cast<const TCHAR*>(file_path.c_str()), &filinfo);
 
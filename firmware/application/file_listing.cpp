@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "file_listing.hpp"
+
+#include <algorithm>
+
+bool listing_before(std::string_view lhs, bool lhs_directory, std::string_view rhs, bool rhs_directory) {
+    if (lhs_directory != rhs_directory)
+        return lhs_directory;
+    return lhs < rhs;
+}
+
+FileListing::FileListing(size_t max_bytes)
+    : max_bytes_{std::min<size_t>(max_bytes, UINT16_MAX)} {
+}
+
+void FileListing::clear() {
+    entries_.clear();
+    names_.clear();
+    overflowed_ = false;
+}
+
+bool FileListing::add(std::string_view name, uint32_t size, bool is_directory) {
+    if (name.size() > max_name_length)
+        return false;
+
+    if (overflowed_ ||
+        memory_used() + sizeof(Entry) + name.size() > max_bytes_) {
+        overflowed_ = true;
+        return false;
+    }
+
+    entries_.push_back({static_cast<uint16_t>(names_.size()),
+                        static_cast<uint8_t>(name.size()),
+                        is_directory,
+                        size});
+    names_.append(name);
+    return true;
+}
+
+void FileListing::sort() {
+    std::sort(
+        entries_.begin(), entries_.end(),
+        [this](const Entry& lhs, const Entry& rhs) {
+            return listing_before(name(lhs), lhs.is_directory, name(rhs), rhs.is_directory);
+        });
+
+    entries_.shrink_to_fit();
+    names_.shrink_to_fit();
+}
+
+PageSelector::PageSelector(size_t page_size, const ListingKey* after)
+    : page_size_{page_size},
+      has_after_{after != nullptr},
+      after_{after ? *after : ListingKey{}} {
+    items_.reserve(page_size_);
+}
+
+void PageSelector::offer(std::string_view name, uint32_t size, bool is_directory) {
+    if (has_after_ && !listing_before(after_.name, after_.is_directory, name, is_directory))
+        return;
+
+    if (full() && !listing_before(name, is_directory, items_.back().name, items_.back().is_directory))
+        return;
+
+    if (full())
+        items_.pop_back();
+
+    const auto position = std::lower_bound(
+        items_.begin(), items_.end(), name,
+        [is_directory](const Item& item, std::string_view name) {
+            return listing_before(item.name, item.is_directory, name, is_directory);
+        });
+    items_.insert(position, {std::string{name}, size, is_directory});
+}
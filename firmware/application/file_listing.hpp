@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __FILE_LISTING_HPP__
+#define __FILE_LISTING_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* Where an entry sorts in a listing: directories first, then by name. */
+struct ListingKey {
+    std::string name{};
+    bool is_directory{false};
+};
+
+bool listing_before(std::string_view lhs, bool lhs_directory, std::string_view rhs, bool rhs_directory);
+
+/* Compact directory listing: one fixed size record per entry, indexing
+ * into a single arena holding all of the names. A few thousand entries
+ * cost a few bytes each instead of a list node and heap string apiece,
+ * and the listing is sorted once after it has been filled. */
+class FileListing {
+   public:
+    struct Entry {
+        uint16_t name_offset;
+        uint8_t name_length;
+        bool is_directory;
+        uint32_t size;
+    };
+
+    /* max_bytes bounds the records and arena together; names are
+     * addressed with 16 bits so it can't exceed 64KiB. */
+    explicit FileListing(size_t max_bytes);
+
+    void clear();
+
+    static constexpr size_t max_name_length = UINT8_MAX;
+
+    /* Returns false if the entry wasn't added. A name longer than
+     * max_name_length is skipped; otherwise the entry didn't fit, and the
+     * listing is marked as overflowed. */
+    bool add(std::string_view name, uint32_t size, bool is_directory);
+
+    /* Directories first, then by name. */
+    void sort();
+
+    bool overflowed() const { return overflowed_; }
+    bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+    size_t memory_used() const { return entries_.size() * sizeof(Entry) + names_.size(); }
+
+    const Entry& operator[](size_t index) const { return entries_[index]; }
+
+    std::string_view name(const Entry& entry) const {
+        return {names_.data() + entry.name_offset, entry.name_length};
+    }
+
+    std::string_view name(size_t index) const {
+        return name(entries_[index]);
+    }
+
+   private:
+    size_t max_bytes_;
+    std::vector<Entry> entries_{};
+    std::string names_{};
+    bool overflowed_{false};
+};
+
+/* Selects one page of a listing too big to hold in memory. Offered every
+ * entry of the directory, in any order, it keeps the first page_size
+ * ones that sort after the previous page's last entry. A page costs one
+ * pass over the directory and room for page_size names. */
+class PageSelector {
+   public:
+    struct Item {
+        std::string name;
+        uint32_t size;
+        bool is_directory;
+    };
+
+    /* after is the previous page's last_key(), nullptr for the first page. */
+    PageSelector(size_t page_size, const ListingKey* after);
+
+    void offer(std::string_view name, uint32_t size, bool is_directory);
+
+    const std::vector<Item>& items() const { return items_; }
+    bool full() const { return items_.size() == page_size_; }
+
+    /* The next page starts after this; only meaningful for a full page. */
+    ListingKey last_key() const {
+        return {items_.back().name, items_.back().is_directory};
+    }
+
+   private:
+    size_t page_size_;
+    bool has_after_;
+    ListingKey after_;
+    std::vector<Item> items_{};
+};
+
+/* Remembers where pages of a listing start, for listings too big to keep
+ * in memory. Page 0 is always the start of the directory and is not
+ * stored. Once max_count bookmarks are held, every other one is dropped
+ * and only every stride-th page is recorded from then on, so any page is
+ * at most stride - 1 pages away from a bookmark. */
+template <typename Position>
+class PageBookmarks {
+   public:
+    explicit PageBookmarks(size_t max_count)
+        : max_count_{max_count < 2 ? 2 : max_count} {}
+
+    void clear() {
+        bookmarks_.clear();
+        bookmarks_.shrink_to_fit();
+        stride_ = 1;
+    }
+
+    size_t size() const { return bookmarks_.size(); }
+    size_t stride() const { return stride_; }
+
+    /* Call with increasing page numbers. */
+    void record(size_t page, const Position& position) {
+        if (page == 0 || (page % stride_) != 0)
+            return;
+
+        if (bookmarks_.size() >= max_count_) {
+            stride_ *= 2;
+            size_t kept = 0;
+            for (size_t i = 0; i < bookmarks_.size(); i++) {
+                if ((bookmarks_[i].first % stride_) == 0)
+                    bookmarks_[kept++] = bookmarks_[i];
+            }
+            bookmarks_.resize(kept);
+
+            if ((page % stride_) != 0)
+                return;
+        }
+
+        bookmarks_.push_back({page, position});
+    }
+
+    /* Returns the closest bookmarked page at or before page and its
+     * position, or page 0 and nullptr to start from the beginning. */
+    std::pair<size_t, const Position*> nearest(size_t page) const {
+        std::pair<size_t, const Position*> result{0, nullptr};
+        for (const auto& bookmark : bookmarks_) {
+            if (bookmark.first > page)
+                break;
+            result = {bookmark.first, &bookmark.second};
+        }
+        return result;
+    }
+
+   private:
+    size_t max_count_;
+    size_t stride_{1};
+    std::vector<std::pair<size_t, Position>> bookmarks_{};
+};
+
+#endif /*__FILE_LISTING_HPP__*/
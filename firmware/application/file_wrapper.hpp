@@ -26,9 +26,13 @@
 #include "file.hpp"
 #include "optional.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <string_view>
+#include <vector>
 
 enum class LineEnding : uint8_t {
     LF,
@@ -37,8 +41,6 @@ enum class LineEnding : uint8_t {
 
 /* TODO:
  * - CRLF handling.
- * - Avoid full re-read on edits.
- *   - Would need to read old/new text when editing to track newlines.
  * - How to surface errors? Exceptions?
  */
 
@@ -53,7 +55,14 @@ enum class LineEnding : uint8_t {
  * Optional<Error> sync()
  */
 
-/* Wraps a buffer and provides an API for accessing lines efficiently. */
+/* Wraps a buffer and provides an API for accessing lines efficiently.
+ * Three levels of caching are used:
+ * - A sparse line index with the offset of every Nth line, built in one
+ *   pass when the buffer is opened and fixed up in place on edits.
+ * - A window of CacheSize newline offsets around the lines being read.
+ * - A small cache of aligned blocks that all reads go through.
+ * Jumping to any line costs at most one scan of N lines from the nearest
+ * indexed line, and reading a cached line costs at most one block read. */
 template <typename BufferType, uint32_t CacheSize>
 class BufferWrapper {
    public:
@@ -151,6 +160,14 @@ class BufferWrapper {
      * Only really useful for unit testing or diagnostics. */
     Offset start_line() { return start_line_; };
 
+    /* Gets the number of block reads from the buffer so far.
+     * Only really useful for unit testing or diagnostics. */
+    uint32_t block_reads() const { return block_reads_; }
+
+    /* Gets the number of lines in the sparse line index.
+     * Only really useful for unit testing or diagnostics. */
+    size_t index_size() const { return line_index_.size(); }
+
     /* Inserts a line before the specified line or at the
      * end of the buffer if line >= line_count. */
     void insert_line(Line line) {
@@ -177,8 +194,16 @@ class BufferWrapper {
         if (range.start > size() || range.end > size() || range.start > range.end)
             return;
 
+        // Gather what's needed to fix up the line data before the
+        // buffer content moves.
+        const Line edit_line = line_for_offset(range.start);
+        const int32_t removed_newlines = count_newlines(range.start, range.end);
+        int32_t added_newlines = 0;
+        for (auto c : value)
+            added_newlines += (c == '\n') ? 1 : 0;
+
         /* If delta_length == 0, it's an overwrite. Could still have
-         * added or removed newlines so caches will need to be rebuilt.
+         * added or removed newlines so caches will need to be updated.
          * If delta_length > 0, the file needs to grow and content needs
          * to be shifted forward until the end of the range.
          * If delta_length < 0, the file needs to be truncated and the
@@ -191,7 +216,29 @@ class BufferWrapper {
 
         write(range.start, value);
         wrapped_->sync();
-        rebuild_cache();
+        invalidate_blocks();
+
+        newline_count_ += added_newlines - removed_newlines;
+        update_line_count();
+
+        // Line starts after the edit just move. One right at the end
+        // of the range is only still a line start if value ends a line.
+        const bool keep_end = !value.empty() && value.back() == '\n';
+        auto it = line_index_.begin();
+        while (it != line_index_.end()) {
+            if (it->offset <= range.start) {
+                ++it;
+            } else if (it->offset > range.end || (it->offset == range.end && keep_end)) {
+                it->offset += delta_length;
+                it->line += added_newlines - removed_newlines;
+                ++it;
+            } else {
+                it = line_index_.erase(it);
+            }
+        }
+
+        // Lines before the window are unchanged if the edit is after it.
+        reposition_window(std::min(start_line_, edit_line));
     }
 
    protected:
@@ -202,6 +249,12 @@ class BufferWrapper {
         initialize();
     }
 
+    /* Drops cached blocks, e.g. when the buffer is swapped. */
+    void invalidate_blocks() {
+        for (auto& block : blocks_)
+            block.valid = false;
+    }
+
    private:
     /* Number of newline offsets to cache. */
     static constexpr Offset max_newlines = CacheSize;
@@ -209,66 +262,202 @@ class BufferWrapper {
     /* Size of stack buffer used for reading/writing. */
     static constexpr Offset buffer_size = 512;
 
+    /* Size and number of cached blocks. Reads are aligned to the block size. */
+    static constexpr Offset block_size = 512;
+    static constexpr size_t block_count = 2;
+
+    /* Maximum size of the line index, the spacing between indexed
+     * lines doubles each time it fills up. */
+    static constexpr size_t max_index_size = 128;
+    static constexpr Line initial_index_interval = 32;
+
+    struct IndexEntry {
+        Line line;
+        Offset offset;
+    };
+
+    struct Block {
+        Offset offset;
+        Offset length;
+        uint32_t last_used;
+        bool valid;
+        char data[block_size];
+    };
+
     void initialize() {
         start_offset_ = 0;
         start_line_ = 0;
         line_count_ = 0;
+        invalidate_blocks();
         rebuild_cache();
     }
 
+    /* Scans the whole buffer once to count lines and build the line index. */
     void rebuild_cache() {
         newlines_.clear();
+        line_index_.clear();
+        line_index_.push_back({0, 0});
+        index_interval_ = initial_index_interval;
+        newline_count_ = 0;
+
+        // Report progress every N lines.
+        constexpr auto report_interval = 100u;
+        auto next_report = report_interval;
+
+        for (Offset offset = 0; offset < size();) {
+            auto block = get_block(offset);
+            if (!block || block->length == 0)
+                break;
+
+            const auto block_end = block->offset + block->length;
+            for (; offset < block_end; ++offset) {
+                if (block->data[offset - block->offset] != '\n')
+                    continue;
+
+                ++newline_count_;
+                if (newline_count_ % index_interval_ == 0)
+                    add_index_entry({newline_count_, offset + 1});
+
+                if (on_read_progress && newline_count_ > next_report) {
+                    on_read_progress(offset, size());
+                    next_report = newline_count_ + report_interval;
+                }
+            }
+        }
 
+        update_line_count();
+        reposition_window(0);
+    }
+
+    void add_index_entry(IndexEntry entry) {
+        // Don't index the position after a trailing newline.
+        if (entry.offset >= size())
+            return;
+
+        if (line_index_.size() >= max_index_size) {
+            // Keep every other entry and index half as often.
+            size_t kept = 0;
+            for (size_t i = 0; i < line_index_.size(); i += 2)
+                line_index_[kept++] = line_index_[i];
+            line_index_.resize(kept);
+            index_interval_ *= 2;
+
+            if (entry.line % index_interval_ != 0)
+                return;
+        }
+
+        line_index_.push_back(entry);
+    }
+
+    /* Computes line_count_ from the number of newlines in the buffer.
+     * The end of the buffer ends a line if it's not a newline. */
+    void update_line_count() {
         // Special case for empty files to keep them consistent.
         if (size() == 0) {
             line_count_ = 1;
-            newlines_.push_back(0);
             return;
         }
 
-        // TODO: think through this for edit cases.
-        // E.g. don't read to end, maybe could specify
-        // a range to re-read because it should be possible
-        // to tell where the dirty regions are. After the
-        // dirty region, it should be possible to fixup
-        // the line_count data.
-        // TODO: seems like shrink/expand could do this while
-        // they are running.
+        char last = '\n';
+        read(size() - 1, &last, 1);
+        line_count_ = newline_count_ + (last == '\n' ? 0 : 1);
+    }
 
-        line_count_ = start_line_;
-        Offset offset = start_offset_;
+    /* Gets the closest indexed line at or before the line. */
+    IndexEntry index_entry_for_line(Line line) const {
+        auto it = std::upper_bound(
+            line_index_.begin(), line_index_.end(), line,
+            [](Line value, const IndexEntry& entry) { return value < entry.line; });
+        return *(it - 1);
+    }
 
-        // Report progress every N lines.
-        constexpr auto report_interval = 100u;
-        auto result = next_newline(offset);
-        auto next_report = report_interval;
+    /* Gets the line containing the offset. */
+    Line line_for_offset(Offset offset) {
+        // Use the newline window if it contains the offset.
+        if (!newlines_.empty() && offset >= start_offset_ && offset <= newlines_.back()) {
+            Line line = start_line_;
+            for (size_t i = 0; i < newlines_.size() && newlines_[i] < offset; ++i)
+                ++line;
+            return line;
+        }
+
+        auto it = std::upper_bound(
+            line_index_.begin(), line_index_.end(), offset,
+            [](Offset value, const IndexEntry& entry) { return value < entry.offset; });
+        auto entry = *(it - 1);
+
+        return entry.line + count_newlines(entry.offset, offset);
+    }
+
+    /* Counts the newlines in [start, end). */
+    Offset count_newlines(Offset start, Offset end) {
+        Offset count = 0;
+
+        while (start < end) {
+            auto block = get_block(start);
+            if (!block || block->length == 0)
+                break;
 
-        while (result) {
-            ++line_count_;
-            if (newlines_.size() < max_newlines)
-                newlines_.push_back(*result);
-            offset = *result + 1;
+            const auto block_end = std::min(end, block->offset + block->length);
+            for (; start < block_end; ++start)
+                count += (block->data[start - block->offset] == '\n') ? 1 : 0;
+        }
+
+        return count;
+    }
+
+    /* Gets the cached block containing offset, reading it if needed. */
+    const Block* get_block(Offset offset) {
+        const Offset base = offset - (offset % block_size);
+        Block* victim = &blocks_[0];
 
-            if (on_read_progress && line_count_ > next_report) {
-                on_read_progress(offset, size());
-                next_report = line_count_ + report_interval;
+        for (auto& block : blocks_) {
+            if (block.valid && block.offset == base) {
+                block.last_used = ++block_clock_;
+                return &block;
             }
 
-            result = next_newline(offset);
+            // Prefer empty blocks, otherwise the least recently used.
+            if (victim->valid && (!block.valid || block.last_used < victim->last_used))
+                victim = &block;
         }
+
+        wrapped_->seek(base);
+        auto result = wrapped_->read(victim->data, block_size);
+        if (result.is_error()) {
+            victim->valid = false;
+            return nullptr;
+        }
+
+        victim->offset = base;
+        victim->length = *result;
+        victim->last_used = ++block_clock_;
+        victim->valid = true;
+        ++block_reads_;
+
+        return victim;
     }
 
     Optional<Offset> read(Offset offset, char* buffer, Offset length) {
         if (offset + length > size())
             return {};
 
-        wrapped_->seek(offset);
+        Offset copied = 0;
+        while (copied < length) {
+            auto block = get_block(offset + copied);
+            if (!block || block->length == 0)
+                return {};
 
-        auto result = wrapped_->read(buffer, length);
-        if (result.is_error())
-            return {};
+            const auto start = offset + copied - block->offset;
+            if (start >= block->length)
+                break;
+
+            const auto to_copy = std::min(length - copied, block->length - start);
+            memcpy(buffer + copied, &block->data[start], to_copy);
+            copied += to_copy;
+        }
 
-        return *result;
+        return copied;
     }
 
     bool write(Offset offset, std::string_view value) {
@@ -290,6 +479,47 @@ class BufferWrapper {
         return actual;
     }
 
+    /* Moves the newline cache so that it contains the line, starting
+     * from the closest line in the line index. */
+    void reposition_window(Line line) {
+        newlines_.clear();
+
+        if (line >= line_count_)
+            line = line_count_ - 1;
+
+        // Center the window on the line if possible.
+        auto entry = index_entry_for_line(line);
+        Line first_line = entry.line;
+        if (line >= first_line + max_newlines / 2)
+            first_line = line - max_newlines / 2;
+
+        Offset offset = entry.offset;
+        for (Line l = entry.line; l < first_line; ++l) {
+            auto newline = next_newline(offset);
+            if (!newline)
+                break;
+            offset = *newline + 1;
+        }
+
+        start_line_ = first_line;
+        start_offset_ = offset;
+
+        // Special case for empty files to keep them consistent.
+        if (size() == 0) {
+            newlines_.push_back(0);
+            return;
+        }
+
+        while (newlines_.size() < max_newlines) {
+            auto newline = next_newline(offset);
+            if (!newline)
+                break;
+
+            newlines_.push_back(*newline);
+            offset = *newline + 1;
+        }
+    }
+
     /* Ensure specified line is in the newline cache. */
     void ensure_cached(Line line) {
         if (line >= line_count_)
@@ -299,6 +529,14 @@ class BufferWrapper {
         if (index)
             return;
 
+        // Far away lines are found from the line index instead
+        // of walking the window line by line.
+        if (line + max_newlines < start_line_ ||
+            line >= start_line_ + newlines_.size() + max_newlines) {
+            reposition_window(line);
+            return;
+        }
+
         if (line < start_line_) {
             while (line < start_line_ && start_offset_ >= 2) {
                 // start_offset_ - 1 should be a newline. Need to
@@ -319,49 +557,46 @@ class BufferWrapper {
                     start_offset_ = *offset + 1;
                 }
             }
+
+            // A line ending with the start of the buffer.
+            if (line < start_line_ && start_offset_ == 1) {
+                newlines_.push_front(0);
+                start_line_ = 0;
+                start_offset_ = 0;
+            }
         } else {
             while (line >= start_line_ + newlines_.size()) {
                 auto offset = next_newline(newlines_.back() + 1);
-                if (offset) {
+                if (!offset)
+                    break;  // At the EOF.
+
+                if (newlines_.size() >= max_newlines) {
                     start_line_++;
                     start_offset_ = newlines_.front() + 1;
-                    newlines_.push_back(*offset);
-                } /* else at the EOF. */
+                }
+                newlines_.push_back(*offset);
             }
         }
     }
 
     /* Finding the first newline backward from offset. */
     Optional<Offset> previous_newline(Offset offset) {
-        char buffer[buffer_size];
-        auto to_read = buffer_size;
-
-        do {
-            if (offset < to_read) {
-                // NB: Char at 'offset' was read in the previous iteration.
-                to_read = offset;
-                offset = 0;
-            } else
-                offset -= to_read;
-
-            wrapped_->seek(offset);
-
-            auto result = wrapped_->read(buffer, to_read);
-            if (result.is_error())
+        while (true) {
+            auto block = get_block(offset);
+            if (!block || block->length == 0)
                 break;
 
-            // Find newlines in the buffer backwards.
-            for (int32_t i = *result - 1; i >= 0; --i) {
-                switch (buffer[i]) {
-                    case '\n':
-                        return offset + i;
-                }
+            // Find newlines in the block backwards.
+            for (int32_t i = offset - block->offset; i >= 0; --i) {
+                if (block->data[i] == '\n')
+                    return block->offset + i;
             }
 
-            if (offset == 0)
+            if (block->offset == 0)
                 break;
 
-        } while (true);
+            offset = block->offset - 1;
+        }
 
         return {};  // Didn't find one.
     }
@@ -372,26 +607,19 @@ class BufferWrapper {
         if (offset >= size())
             return {};
 
-        char buffer[buffer_size];
-        wrapped_->seek(offset);
-
-        while (true) {
-            auto result = wrapped_->read(buffer, buffer_size);
-            if (result.is_error())
+        while (offset < size()) {
+            auto block = get_block(offset);
+            if (!block || block->length == 0)
                 return {};
 
-            // Find newlines in the buffer.
-            for (Offset i = 0; i < *result; ++i) {
-                switch (buffer[i]) {
-                    case '\n':
-                        return offset + i;
-                }
-            }
-
-            offset += *result;
+            // Find newlines in the block.
+            auto begin = &block->data[offset - block->offset];
+            auto found = static_cast<const char*>(
+                memchr(begin, '\n', block->offset + block->length - offset));
+            if (found)
+                return offset + (found - begin);
 
-            if (*result < buffer_size)
-                break;
+            offset = block->offset + block->length;
         }
 
         // For consistency, treat the end of the file as a "newline".
@@ -478,12 +706,23 @@ class BufferWrapper {
     /* Total number of lines in the buffer. */
     Offset line_count_{0};
 
+    /* Total number of '\n' in the buffer. */
+    Offset newline_count_{0};
+
     /* The offset and line of the newlines cache. */
     Offset start_offset_{0};
     Offset start_line_{0};
 
     LineEnding line_ending_{LineEnding::LF};
     CircularBuffer<Offset, max_newlines + 1> newlines_{};
+
+    /* Sparse line index, sorted by line and offset. */
+    std::vector<IndexEntry> line_index_{};
+    Line index_interval_{initial_index_interval};
+
+    std::array<Block, block_count> blocks_{};
+    uint32_t block_clock_{0};
+    uint32_t block_reads_{0};
 };
 
 /* A BufferWrapper over a file. */
@@ -523,6 +762,7 @@ class FileWrapper : public BufferWrapper<File, 64> {
             return false;
 
         file_ = std::move(file);
+        invalidate_blocks();
         return true;
     }
 
@@ -28,7 +28,7 @@
 #include "freqman_db.hpp"
 
 // Defined for back-compat.
-#define FREQMAN_MAX_PER_FILE freqman_default_max_entries
+#define FREQMAN_MAX_PER_FILE freqman_list_max_entries
 
 enum freqman_error : int8_t {
     NO_ERROR = 0,
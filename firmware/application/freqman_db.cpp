@@ -39,6 +39,7 @@
 namespace fs = std::filesystem;
 
 const std::filesystem::path freqman_extension{u".TXT"};
+const std::filesystem::path freqman_index_extension{u".FMI"};
 
 // NB: Don't include UI headers to keep this code unit testable.
 using option_t = std::pair<std::string_view, int32_t>;
@@ -414,42 +415,18 @@ bool parse_freqman_entry(std::string_view str, freqman_entry& entry) {
 }
 
 bool parse_freqman_file(const fs::path& path, freqman_db& db, freqman_load_options options) {
-    FreqmanDB freqman_db;
-    freqman_db.set_read_raw(false);  // Don't return malformed lines.
-    if (!freqman_db.open(path))
+    FreqmanList list;
+    if (!load_freqman_list(path, list, options))
         return false;
 
     // Attempt to avoid a re-alloc if possible.
     db.clear();
-    db.reserve(freqman_db.entry_count());
-
-    for (auto entry : freqman_db) {
-        // Filter by entry type.
-        if (entry.type == freqman_type::Unknown ||
-            (entry.type == freqman_type::Single && !options.load_freqs) ||
-            (entry.type == freqman_type::Range && !options.load_ranges) ||
-            (entry.type == freqman_type::HamRadio && !options.load_hamradios) ||
-            (entry.type == freqman_type::Repeater && !options.load_repeaters)) {
-            continue;
-        }
-
-        // Use previous entry's mod/band if current's aren't set.
-        if (!db.empty()) {
-            if (is_invalid(entry.modulation))
-                entry.modulation = db.back()->modulation;
-            if (is_invalid(entry.bandwidth))
-                entry.bandwidth = db.back()->bandwidth;
-        }
-
-        // Move the entry onto the heap and push.
-        db.push_back(std::make_unique<freqman_entry>(std::move(entry)));
+    db.reserve(list.size());
 
-        // Limit to max_entries when specified.
-        if (options.max_entries > 0 && db.size() >= options.max_entries)
-            break;
-    }
+    // Move the entries onto the heap and push.
+    for (FreqmanList::Index i = 0; i < list.size(); ++i)
+        db.push_back(std::make_unique<freqman_entry>(list.entry(i)));
 
-    db.shrink_to_fit();
     return true;
 }
 
@@ -491,6 +468,8 @@ bool FreqmanDB::open(const std::filesystem::path& path, bool create) {
         return false;
 
     wrapper_ = *std::move(result);
+    path_ = path;
+    index_invalidated_ = false;
     return true;
 }
 
@@ -498,6 +477,15 @@ void FreqmanDB::close() {
     wrapper_.reset();
 }
 
+void FreqmanDB::invalidate_index() {
+    // The size/date stamp would catch most edits, but FAT dates
+    // have a 2 second resolution, so remove the index outright.
+    if (!index_invalidated_) {
+        delete_file(get_freqman_index_path(path_));
+        index_invalidated_ = true;
+    }
+}
+
 freqman_entry FreqmanDB::operator[](Index index) const {
     auto length = wrapper_->line_length(index);
     auto line_text = wrapper_->get_text(index, 0, length);
@@ -518,6 +506,7 @@ freqman_entry FreqmanDB::operator[](Index index) const {
 
 void FreqmanDB::insert_entry(Index index, const freqman_entry& entry) {
     index = clip<uint32_t>(index, 0u, entry_count());
+    invalidate_index();
     wrapper_->insert_line(index);
     replace_entry(index, entry);
 }
@@ -533,10 +522,12 @@ void FreqmanDB::replace_entry(Index index, const freqman_entry& entry) {
 
     // Don't overwrite the '\n'.
     range->end--;
+    invalidate_index();
     wrapper_->replace_range(*range, to_freqman_string(entry));
 }
 
 void FreqmanDB::delete_entry(Index index) {
+    invalidate_index();
     wrapper_->delete_line(index);
 }
 
@@ -565,3 +556,169 @@ bool FreqmanDB::empty() const {
     // A DB is only really empty if the file size is 0.
     return !wrapper_ || wrapper_->size() == 0;
 }
+
+/* FreqmanList *********************************/
+
+void FreqmanList::clear() {
+    // Re-assign so the memory is actually released.
+    entries_ = {};
+    arena_ = {};
+    intern_ = {};
+}
+
+void FreqmanList::shrink_to_fit() {
+    entries_.shrink_to_fit();
+    arena_.shrink_to_fit();
+}
+
+std::string_view FreqmanList::description(const freqman_compact_entry& entry) const {
+    if (entry.description_size == 0)
+        return {};
+
+    return std::string_view{arena_}.substr(entry.description_offset, entry.description_size);
+}
+
+freqman_entry FreqmanList::entry(Index index) const {
+    const auto& compact = entries_[index];
+
+    return {
+        compact.frequency_a,
+        compact.frequency_b,
+        std::string{description(compact)},
+        compact.type,
+        compact.modulation,
+        compact.bandwidth,
+        compact.step,
+        compact.tone};
+}
+
+void FreqmanList::push_back(const freqman_entry& entry) {
+    push_back(
+        {entry.frequency_a,
+         entry.frequency_b,
+         0,
+         0,
+         entry.type,
+         entry.modulation,
+         entry.bandwidth,
+         entry.step,
+         entry.tone},
+        entry.description);
+}
+
+void FreqmanList::push_back(freqman_compact_entry entry, std::string_view description) {
+    description = description.substr(0, freqman_max_desc_size);
+    entry.description_offset = intern(description);
+    entry.description_size = description.size();
+    entries_.push_back(entry);
+}
+
+void FreqmanList::erase(Index index) {
+    if (index < entries_.size())
+        entries_.erase(entries_.begin() + index);
+}
+
+uint32_t FreqmanList::intern(std::string_view description) {
+    if (description.empty())
+        return 0;
+
+    // FNV-1a, only used to pick the bucket.
+    uint32_t hash = 2166136261u;
+    for (auto c : description)
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+
+    auto& bucket = intern_[hash % intern_buckets];
+    if (bucket > 0) {
+        const auto offset = bucket - 1;
+        if (std::string_view{arena_}.substr(offset, description.size()) == description)
+            return offset;
+    }
+
+    const uint32_t offset = arena_.size();
+    arena_.append(description.data(), description.size());
+    bucket = offset + 1;
+    return offset;
+}
+
+/* Freqman Index *******************************/
+
+fs::path get_freqman_index_path(const fs::path& path) {
+    auto index_path = path;
+    return index_path.replace_extension(freqman_index_extension);
+}
+
+/* Builds the index for path from its text content. */
+static bool build_freqman_index(const fs::path& path, const freqman_index_stamp& source) {
+    FreqmanDB db;
+    db.set_read_raw(false);  // Don't index malformed lines.
+    if (!db.open(path))
+        return false;
+
+    File index;
+    if (index.create(get_freqman_index_path(path)))
+        return false;
+
+    if (!write_freqman_index(index, source, db)) {
+        index.close();
+        delete_file(get_freqman_index_path(path));
+        return false;
+    }
+
+    return true;
+}
+
+static bool load_freqman_index(const fs::path& path, const freqman_index_stamp& source, FreqmanList& list, const freqman_load_options& options) {
+    File index;
+    if (index.open(get_freqman_index_path(path)))
+        return false;
+
+    return read_freqman_index(index, source, list, options);
+}
+
+bool load_freqman_list(const fs::path& path, FreqmanList& list, freqman_load_options options) {
+    list.clear();
+
+    freqman_index_stamp source{};
+    {
+        File file;
+        if (file.open(path))
+            return false;
+
+        auto date = file_created_date(path);
+        source = {static_cast<uint32_t>(file.size()), date.FAT_date, date.FAT_time};
+    }
+
+    if (load_freqman_index(path, source, list, options) ||
+        (build_freqman_index(path, source) && load_freqman_index(path, source, list, options))) {
+        list.shrink_to_fit();
+        return true;
+    }
+
+    // The index couldn't be written (e.g. read-only card), parse the text.
+    FreqmanDB db;
+    db.set_read_raw(false);
+    if (!db.open(path))
+        return false;
+
+    for (auto entry : db) {
+        if (!options.accepts(entry.type))
+            continue;
+
+        // Use previous entry's mod/band if current's aren't set.
+        if (!list.empty()) {
+            if (is_invalid(entry.modulation))
+                entry.modulation = list.back().modulation;
+            if (is_invalid(entry.bandwidth))
+                entry.bandwidth = list.back().bandwidth;
+        }
+
+        list.push_back(entry);
+
+        // Limit to max_entries when specified.
+        if (options.max_entries > 0 && list.size() >= options.max_entries)
+            break;
+    }
+
+    list.shrink_to_fit();
+    return true;
+}
@@ -29,6 +29,7 @@
 #include "file_wrapper.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <string>
@@ -37,6 +38,7 @@
 
 /* Defined in freqman_db.cpp */
 extern const std::filesystem::path freqman_extension;
+extern const std::filesystem::path freqman_index_extension;
 
 using freqman_index_t = uint8_t;
 constexpr freqman_index_t freqman_invalid_index = static_cast<freqman_index_t>(-1);
@@ -161,6 +163,11 @@ std::string freqman_entry_get_step_string_short(freqman_index_t step);
  * ensure app memory stability. */
 constexpr size_t freqman_default_max_entries = 150;
 
+/* Maximum number of items apps using a FreqmanList keep in memory.
+ * Entries are fixed-size so this is bounded at ~32 bytes per entry
+ * plus the description arena. */
+constexpr size_t freqman_list_max_entries = 500;
+
 /* Limiting description to 30 as specified by the format */
 constexpr size_t freqman_max_desc_size = 30;
 
@@ -171,6 +178,14 @@ struct freqman_load_options {
     bool load_ranges{true};
     bool load_hamradios{true};
     bool load_repeaters{true};
+
+    /* Returns true if entries of this type should be loaded. */
+    bool accepts(freqman_type type) const {
+        return (type == freqman_type::Single && load_freqs) ||
+               (type == freqman_type::Range && load_ranges) ||
+               (type == freqman_type::HamRadio && load_hamradios) ||
+               (type == freqman_type::Repeater && load_repeaters);
+    }
 };
 
 using freqman_entry_ptr = std::unique_ptr<freqman_entry>;
@@ -278,7 +293,227 @@ class FreqmanDB {
 
    private:
     std::unique_ptr<FileWrapper> wrapper_{};
+    std::filesystem::path path_{};
     bool read_raw_{true};
+    bool index_invalidated_{false};
+
+    /* Removes the .FMI index once the text file is edited. */
+    void invalidate_index();
+};
+
+/* Compact Freqman Entry ***********************/
+/* Fixed-size form of freqman_entry. The description lives
+ * in the string arena of the FreqmanList holding the entry. */
+struct freqman_compact_entry {
+    int64_t frequency_a{0};
+    int64_t frequency_b{0};
+    uint32_t description_offset{0};
+    uint8_t description_size{0};
+    freqman_type type{freqman_type::Unknown};
+    freqman_index_t modulation{freqman_invalid_index};
+    freqman_index_t bandwidth{freqman_invalid_index};
+    freqman_index_t step{freqman_invalid_index};
+    freqman_index_t tone{freqman_invalid_index};
+};
+static_assert(sizeof(freqman_compact_entry) == 32, "freqman_compact_entry size changed.");
+
+/* In-memory list of freqman entries without per-entry heap allocations.
+ * Descriptions are interned into a single string arena: repeats of a
+ * recent description share the same arena bytes. */
+class FreqmanList {
+   public:
+    using Index = uint32_t;
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    size_t arena_size() const { return arena_.size(); }
+
+    /* Releases all memory held by the list. */
+    void clear();
+    void reserve(size_t count) { entries_.reserve(count); }
+    void shrink_to_fit();
+
+    const freqman_compact_entry& operator[](Index index) const {
+        return entries_[index];
+    }
+    const freqman_compact_entry& back() const {
+        return entries_.back();
+    }
+
+    std::string_view description(const freqman_compact_entry& entry) const;
+    std::string_view description(Index index) const {
+        return description(entries_[index]);
+    }
+
+    /* Gets a full freqman_entry copy of the item at index. */
+    freqman_entry entry(Index index) const;
+
+    void push_back(const freqman_entry& entry);
+    void push_back(freqman_compact_entry entry, std::string_view description);
+
+    /* NB: The description stays in the arena until clear(). */
+    void erase(Index index);
+
+   private:
+    static constexpr size_t intern_buckets = 64;
+
+    std::vector<freqman_compact_entry> entries_{};
+    std::string arena_{};
+    /* Arena offset + 1 of the last description hashed to each bucket. */
+    std::array<uint32_t, intern_buckets> intern_{};
+
+    uint32_t intern(std::string_view description);
+};
+
+/* Freqman Index *******************************/
+/* A .FMI file next to a freqman .TXT holds the entries in binary
+ * fixed-size records so large lists load without text parsing.
+ * The index is rebuilt when the .TXT file's size or date changes. */
+constexpr uint32_t freqman_index_magic = 0x31494D46;  // "FMI1"
+constexpr uint16_t freqman_index_version = 1;
+
+/* Identifies the text file an index was built from. */
+struct freqman_index_stamp {
+    uint32_t size;
+    uint16_t date;
+    uint16_t time;
+};
+
+inline bool operator==(const freqman_index_stamp& lhs, const freqman_index_stamp& rhs) {
+    return lhs.size == rhs.size && lhs.date == rhs.date && lhs.time == rhs.time;
+}
+
+struct freqman_index_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    freqman_index_stamp source;
+    uint32_t record_count;
 };
 
+struct freqman_index_record {
+    int64_t frequency_a;
+    int64_t frequency_b;
+    freqman_type type;
+    freqman_index_t modulation;
+    freqman_index_t bandwidth;
+    freqman_index_t step;
+    freqman_index_t tone;
+    uint8_t description_size;
+    char description[freqman_max_desc_size];
+};
+
+/* Gets the .FMI path for a freqman file path. */
+std::filesystem::path get_freqman_index_path(const std::filesystem::path& path);
+
+/* Loads a freqman file into a FreqmanList through its index,
+ * (re)building the index first if it's missing or stale.
+ * Entries without modulation/bandwidth inherit the previous entry's. */
+bool load_freqman_list(const std::filesystem::path& path, FreqmanList& list, freqman_load_options options);
+
+/* Writes every entry in 'entries' as an index for the source file.
+ * TFile must provide seek(), write(). */
+template <typename TFile, typename TEntries>
+bool write_freqman_index(TFile& file, const freqman_index_stamp& source, TEntries& entries) {
+    freqman_index_header header{
+        freqman_index_magic,
+        freqman_index_version,
+        sizeof(freqman_index_record),
+        source,
+        0};
+
+    // Write the header last so an interrupted build is never valid.
+    file.seek(sizeof(header));
+
+    for (const freqman_entry& entry : entries) {
+        if (entry.type == freqman_type::Unknown || entry.type == freqman_type::Raw)
+            continue;
+
+        freqman_index_record record{
+            entry.frequency_a,
+            entry.frequency_b,
+            entry.type,
+            entry.modulation,
+            entry.bandwidth,
+            entry.step,
+            entry.tone,
+            static_cast<uint8_t>(std::min(entry.description.size(), freqman_max_desc_size)),
+            {}};
+        entry.description.copy(record.description, record.description_size);
+
+        if (!file.write(&record, sizeof(record)))
+            return false;
+        header.record_count++;
+    }
+
+    file.seek(0);
+    return file.write(&header, sizeof(header)).is_ok();
+}
+
+/* Reads an index into list, applying the load options as it goes.
+ * Returns false if the index is invalid or doesn't match source.
+ * TFile must provide read(). */
+template <typename TFile>
+bool read_freqman_index(TFile& file, const freqman_index_stamp& source, FreqmanList& list, const freqman_load_options& options) {
+    freqman_index_header header{};
+    auto header_read = file.read(&header, sizeof(header));
+    if (!header_read || *header_read != sizeof(header))
+        return false;
+
+    if (header.magic != freqman_index_magic ||
+        header.version != freqman_index_version ||
+        header.record_size != sizeof(freqman_index_record) ||
+        !(header.source == source))
+        return false;
+
+    list.clear();
+
+    constexpr size_t chunk_records = 8;
+    std::array<freqman_index_record, chunk_records> records;
+
+    for (uint32_t remaining = header.record_count; remaining > 0;) {
+        const auto count = std::min<uint32_t>(remaining, chunk_records);
+        auto records_read = file.read(records.data(), count * sizeof(freqman_index_record));
+        if (!records_read || *records_read != count * sizeof(freqman_index_record)) {
+            list.clear();
+            return false;
+        }
+        remaining -= count;
+
+        for (size_t i = 0; i < count; i++) {
+            const auto& record = records[i];
+            if (!options.accepts(record.type))
+                continue;
+
+            freqman_compact_entry entry{
+                record.frequency_a,
+                record.frequency_b,
+                0,
+                0,
+                record.type,
+                record.modulation,
+                record.bandwidth,
+                record.step,
+                record.tone};
+
+            // Use previous entry's mod/band if current's aren't set.
+            if (!list.empty()) {
+                if (is_invalid(entry.modulation))
+                    entry.modulation = list.back().modulation;
+                if (is_invalid(entry.bandwidth))
+                    entry.bandwidth = list.back().bandwidth;
+            }
+
+            const auto size = std::min<size_t>(record.description_size, freqman_max_desc_size);
+            list.push_back(entry, {record.description, size});
+
+            // Limit to max_entries when specified.
+            if (options.max_entries > 0 && list.size() >= options.max_entries)
+                return true;
+        }
+    }
+
+    return true;
+}
+
 #endif /* __FREQMAN_DB_H__ */
@@ -230,6 +230,10 @@ void MAX2837::flush() {
     }
 }
 
+void MAX2837::invalidate() {
+    _dirty.set();
+}
+
 void MAX2837::flush_one(const Register reg) {
     const auto reg_num = toUType(reg);
     write(reg_num, _map.w[reg_num]);
@@ -237,6 +241,7 @@ void MAX2837::flush_one(const Register reg) {
 }
 
 void MAX2837::write(const address_t reg_num, const reg_t value) {
+    if (_trace) _trace->record(_trace_device, reg_num, value);
     uint16_t t = (0U << 15) | (reg_num << 10) | (value & 0x3ffU);
     _target.transfer(&t, 1);
 }
@@ -299,6 +304,8 @@ void MAX2837::set_lpf_rf_bandwidth_tx(const uint32_t bandwidth_minimum) {
 
 bool MAX2837::set_frequency(const rf::Frequency lo_frequency) {
     /* TODO: This is a sad implementation. Refactor. */
+    const RegisterMap previous{_map};
+
     if (lo::band[0].contains(lo_frequency)) {
         _map.r.syn_int_div.LOGEN_BSW = 0b00; /* 2300 - 2399.99MHz */
         _map.r.rxrf_1.LNAband = 0;           /* 2.3 - 2.5GHz */
@@ -314,21 +321,23 @@ bool MAX2837::set_frequency(const rf::Frequency lo_frequency) {
     } else {
         return false;
     }
-    _dirty[Register::SYN_INT_DIV] = 1;
-    _dirty[Register::RXRF_1] = 1;
 
     const uint64_t div_q20 = (lo_frequency * (1 << 20)) / pll_factor;
 
     _map.r.syn_int_div.SYN_INTDIV = div_q20 >> 20;
-    _dirty[Register::SYN_INT_DIV] = 1;
     _map.r.syn_fr_div_2.SYN_FRDIV_19_10 = (div_q20 >> 10) & 0x3ff;
-    _dirty[Register::SYN_FR_DIV_2] = 1;
-    /* flush to commit high FRDIV first, as low FRDIV commits the change */
-    flush();
-
     _map.r.syn_fr_div_1.SYN_FRDIV_9_0 = (div_q20 & 0x3ff);
-    _dirty[Register::SYN_FR_DIV_1] = 1;
+
+    /* Only write the registers that changed. Writing low FRDIV commits
+     * the synthesizer change, so it goes last and is always written when
+     * any synthesizer register changed. */
+    _dirty.mark_changed(previous.w, _map.w);
+    if (!_dirty) {
+        return true;
+    }
+    _dirty[Register::SYN_FR_DIV_1] = 0;
     flush();
+    flush_one(Register::SYN_FR_DIV_1);
 
     return true;
 }
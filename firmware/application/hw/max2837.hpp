@@ -827,6 +827,7 @@ class MAX2837 : public MAX283x {
 #endif
 
     bool set_frequency(const rf::Frequency lo_frequency) override;
+    void invalidate() override;
 
     void set_rx_LO_iq_phase_calibration(const size_t v) override;
     void set_tx_LO_iq_phase_calibration(const size_t v) override;
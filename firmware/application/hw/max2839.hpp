@@ -689,6 +689,7 @@ class MAX2839 : public MAX283x {
     void set_lpf_rf_bandwidth_rx(const uint32_t bandwidth_minimum) override;
     void set_lpf_rf_bandwidth_tx(const uint32_t bandwidth_minimum) override;
     bool set_frequency(const rf::Frequency lo_frequency) override;
+    void invalidate() override;
     void set_rx_LO_iq_phase_calibration(const size_t v) override;
     void set_tx_LO_iq_phase_calibration(const size_t v) override;
     void set_rx_buff_vcm(const size_t v) override;
@@ -25,6 +25,7 @@
 #include <array>
 
 #include "rf_path.hpp"
+#include "dirty_registers.hpp"
 
 namespace max283x {
 
@@ -124,6 +125,8 @@ class MAX283x {
     virtual void set_lpf_rf_bandwidth_tx(const uint32_t bandwidth_minimum);
 
     virtual bool set_frequency(const rf::Frequency lo_frequency);
+    /* Marks every register for writing on the next flush. */
+    virtual void invalidate() = 0;
 
     virtual void set_rx_LO_iq_phase_calibration(const size_t v);
     virtual void set_tx_LO_iq_phase_calibration(const size_t v);
@@ -134,6 +137,15 @@ class MAX283x {
 
     virtual reg_t read(const address_t reg_num);
     virtual void write(const address_t reg_num, const reg_t value);
+
+    void set_write_trace(RegisterWriteTrace* const trace, const uint8_t device) {
+        _trace = trace;
+        _trace_device = device;
+    }
+
+   protected:
+    RegisterWriteTrace* _trace{nullptr};
+    uint8_t _trace_device{0};
 };
 
 }  // namespace max283x
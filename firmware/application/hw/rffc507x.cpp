@@ -176,6 +176,7 @@ void RFFC507x::flush() {
 }
 
 void RFFC507x::write(const address_t reg_num, const spi::reg_t value) {
+    if (_trace) _trace->record(_trace_device, reg_num, value);
     _bus.write(reg_num, value);
 }
 
@@ -191,6 +192,10 @@ spi::reg_t RFFC507x::read(const Register reg) {
     return read(toUType(reg));
 }
 
+void RFFC507x::invalidate() {
+    _dirty.set();
+}
+
 void RFFC507x::flush_one(const Register reg) {
     const auto reg_num = toUType(reg);
     write(reg_num, _map.w[reg_num]);
@@ -232,6 +237,7 @@ void RFFC507x::set_mixer_current(const uint8_t value) {
 
 void RFFC507x::set_frequency(const rf::Frequency lo_frequency) {
     const SynthConfig synth_config = SynthConfig::calculate(lo_frequency);
+    const RegisterMap previous{_map};
 
     /* Boost charge pump leakage if VCO frequency > 3.2GHz, indicated by
      * prescaler divider set to 4 (log2=2) instead of 2 (log2=1).
@@ -241,16 +247,15 @@ void RFFC507x::set_frequency(const rf::Frequency lo_frequency) {
     } else {
         _map.r.lf.pllcpl = 2;
     }
-    flush_one(Register::LF);
 
     _map.r.p2_freq1.p2n = synth_config.n_divider_q24 >> 24;
     _map.r.p2_freq1.p2lodiv = synth_config.lo_divider_log2;
     _map.r.p2_freq1.p2presc = synth_config.prescaler_divider_log2;
     _map.r.p2_freq2.p2nmsb = (synth_config.n_divider_q24 >> 8) & 0xffff;
     _map.r.p2_freq3.p2nlsb = synth_config.n_divider_q24 & 0xff;
-    _dirty[Register::P2_FREQ1] = 1;
-    _dirty[Register::P2_FREQ2] = 1;
-    _dirty[Register::P2_FREQ3] = 1;
+
+    /* Only write the registers that changed. */
+    _dirty.mark_changed(previous.w, _map.w);
     flush();
 }
 
@@ -832,6 +832,8 @@ class RFFC507x {
     void reset();
 
     void flush();
+    /* Marks every register for writing on the next flush. */
+    void invalidate();
 
     void enable();
     void disable();
@@ -843,8 +845,15 @@ class RFFC507x {
     reg_t read(const address_t reg_num);
     void write(const address_t reg_num, const reg_t value);
 
+    void set_write_trace(RegisterWriteTrace* const trace, const uint8_t device) {
+        _trace = trace;
+        _trace_device = device;
+    }
+
    private:
     spi::SPI _bus{};
+    RegisterWriteTrace* _trace{nullptr};
+    uint8_t _trace_device{0};
 
     RegisterMap _map{default_hackrf_one};
     DirtyRegisters<Register, reg_count> _dirty{};
@@ -23,6 +23,7 @@
 
 #include "io_wave.hpp"
 #include "utility.hpp"
+#include "portapack_persistent_memory.hpp"
 
 bool WAVFileReader::open(const std::filesystem::path& path) {
     size_t i = 0;
@@ -167,10 +168,23 @@ Optional<File::Error> WAVFileWriter::create(
     if (create_error.is_valid()) {
         return create_error;
     } else {
+        // Opt-in (Settings > SD Card), and best effort: the WAV viewer
+        // builds a missing peak file itself.
+        if (portapack::persistent_memory::config_wav_peak_files())
+            peaks.create(filename);
         return update_header();
     }
 }
 
+// Samples are always written whole, so the buffer is fed to the peak file as is.
+File::Result<File::Size> WAVFileWriter::write(const void* const buffer, const File::Size bytes) {
+    auto write_result = FileWriter::write(buffer, bytes);
+    if (write_result.is_ok() && peaks.is_open()) {
+        peaks.add(static_cast<const int16_t*>(buffer), write_result.value() / sizeof(int16_t));
+    }
+    return write_result;
+}
+
 Optional<File::Error> WAVFileWriter::update_header() {
     header_t header{sampling_rate, (uint32_t)bytes_written_ - sizeof(header_t), info_chunk_size};
 
@@ -24,6 +24,7 @@
 #define __IO_WAVE_H
 
 #include "io_file.hpp"
+#include "wav_peaks.hpp"
 
 #include "file.hpp"
 #include "optional.hpp"
@@ -167,6 +168,7 @@ class WAVFileWriter : public FileWriter {
     ~WAVFileWriter() {
         write_tags();
         update_header();
+        peaks.finish();
     }
 
     Optional<File::Error> create(
@@ -174,7 +176,10 @@ class WAVFileWriter : public FileWriter {
         size_t sampling_rate,
         const std::string& title_set);
 
+    File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
    private:
+    wav_peaks::PeakWriter peaks{};
     uint32_t sampling_rate{0};
     uint32_t info_chunk_size{0};
     std::string title{};
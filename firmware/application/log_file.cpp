@@ -22,16 +22,166 @@
 #include "log_file.hpp"
 #include "string_format.hpp"
 
+// LogWriter //////////////////////////////////////////////////////////////
+
+std::array<LogWriter::Slot, LogWriter::max_files> LogWriter::slots{};
+std::unique_ptr<LogRing> LogWriter::ring{};
+std::array<uint8_t, LogWriter::chunk_size> LogWriter::chunk{};
+uint32_t LogWriter::dropped{0};
+Thread* LogWriter::thread{nullptr};
+Mutex LogWriter::ring_mutex{};
+Mutex LogWriter::io_mutex{};
+
+int32_t LogWriter::attach(File& file) {
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].file == nullptr) {
+            if (thread == nullptr && !start())
+                return -1;
+            slots[i] = {&file, file.tell(), {}, 0};
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LogWriter::detach(const int32_t slot) {
+    flush();
+    slots[slot] = {};
+
+    for (const auto& s : slots) {
+        if (s.file != nullptr)
+            return;
+    }
+    stop();
+}
+
+Optional<File::Error> LogWriter::write(const int32_t slot, std::initializer_list<std::string_view> parts) {
+    chMtxLock(&ring_mutex);
+    auto& s = slots[slot];
+    if (s.dropped) {
+        StringFormatBuffer buffer;
+        size_t length = 0;
+        const auto count = to_string_dec_uint(s.dropped, buffer, length);
+        if (ring->push(slot, {"(", {count, length}, " lines dropped)\r\n"}))
+            s.dropped = 0;
+    }
+    if (!ring->push(slot, parts)) {
+        dropped++;
+        s.dropped++;
+    }
+    const auto wake = ring->used() > ring->capacity() / 2;
+    auto error = s.error;
+    s.error = Optional<File::Error>{};
+    chMtxUnlock();
+
+    if (wake)
+        chEvtSignal(thread, EVENT_MASK(0));
+    return error;
+}
+
+bool LogWriter::start() {
+    chMtxInit(&ring_mutex);
+    chMtxInit(&io_mutex);
+    ring = std::make_unique<LogRing>(ring_size);
+    // Below the UI, and enough stack for FATFS.
+    thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO - 10, LogWriter::static_fn, nullptr);
+    if (!thread)
+        ring.reset();
+    return thread != nullptr;
+}
+
+void LogWriter::stop() {
+    chThdTerminate(thread);
+    chEvtSignal(thread, EVENT_MASK(0));
+    chThdWait(thread);
+    thread = nullptr;
+    ring.reset();
+}
+
+void LogWriter::flush() {
+    chMtxLock(&io_mutex);
+
+    uint32_t written = 0;
+    while (true) {
+        chMtxLock(&ring_mutex);
+        const auto file = ring->next_file();
+        size_t count = 0;
+        if (file >= 0) {
+            // Up to the next sector boundary of the file.
+            const auto limit = chunk_size - (slots[file].offset % chunk_size);
+            count = ring->read(chunk.data(), limit);
+        }
+        chMtxUnlock();
+
+        if (count == 0)
+            break;
+
+        auto& slot = slots[file];
+        const auto result = slot.file->write(chunk.data(), count);
+        if (result.is_error() && !slot.error)
+            slot.error = result.error();
+        slot.offset += count;
+        written |= 1 << file;
+    }
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (written & (1 << i))
+            slots[i].file->sync();
+    }
+
+    chMtxUnlock();
+}
+
+msg_t LogWriter::static_fn(void*) {
+    while (!chThdShouldTerminate()) {
+        chEvtWaitAnyTimeout(EVENT_MASK(0), flush_interval);
+        flush();
+    }
+    return 0;
+}
+
+// LogFile ////////////////////////////////////////////////////////////////
+
+LogFile::~LogFile() {
+    close();
+}
+
+Optional<File::Error> LogFile::append(const std::filesystem::path& filename) {
+    close();
+
+    auto result = ensure_directory(filename.parent_path());
+    if (result.code())
+        return {result};
+
+    auto error = file.append(filename);
+    if (!error)
+        slot = LogWriter::attach(file);
+    return error;
+}
+
+void LogFile::close() {
+    if (slot >= 0) {
+        LogWriter::detach(slot);
+        slot = -1;
+    }
+}
+
 Optional<File::Error> LogFile::write_entry(const std::string& entry) {
     return write_entry(rtc_time::now(), entry);
 }
 
 Optional<File::Error> LogFile::write_entry(const rtc::RTC& datetime, const std::string& entry) {
     std::string timestamp = to_string_timestamp(datetime);
+    if (slot >= 0)
+        return LogWriter::write(slot, {timestamp, " ", entry, "\r\n"});
     return write_raw(timestamp + " " + entry);
 }
 
 Optional<File::Error> LogFile::write_raw(const std::string& message) {
+    if (slot >= 0)
+        return LogWriter::write(slot, {message, "\r\n"});
+
+    // No free slot, write it out here.
     auto error = file.write_line(message);
     if (!error) {
         file.sync();
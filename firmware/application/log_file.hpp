@@ -22,27 +22,87 @@
 #ifndef __LOG_FILE_H__
 #define __LOG_FILE_H__
 
+#include <array>
+#include <memory>
 #include <string>
+#include <string_view>
+
+#include "ch.h"
 
 #include "file.hpp"
+#include "log_ring.hpp"
 #include "rtc_time.hpp"
 
-class LogFile {
+/* Writes the lines of all open log files in the background. Lines are queued
+ * in a ring allocated when the first log opens, and a low priority thread
+ * writes them out every second, or sooner when the ring is half full, in
+ * chunks that end on sector boundaries of the file. Lines that arrive while
+ * the ring is full are dropped and counted, and the file gets a line saying
+ * how many were lost once there is room again. */
+class LogWriter {
    public:
-    Optional<File::Error> append(const std::filesystem::path& filename) {
-        auto result = ensure_directory(filename.parent_path());
-        if (result.code())
-            return {result};
+    static constexpr size_t max_files = 8;
+
+    /* Returns the slot of the file, -1 if all are taken or the writer
+     * couldn't be started; the file is then written to directly. */
+    static int32_t attach(File& file);
+
+    /* Writes out what is queued for the slot before releasing it. */
+    static void detach(const int32_t slot);
 
-        return file.append(filename);
+    /* Never blocks on the SD card. Returns the first write error of the
+     * slot since the last call, if any. */
+    static Optional<File::Error> write(const int32_t slot, std::initializer_list<std::string_view> parts);
+
+    /* Lines dropped since start-up. */
+    static uint32_t dropped_lines() {
+        return dropped;
     }
 
+   private:
+    static constexpr size_t ring_size = 4096;
+    static constexpr size_t chunk_size = 512;
+    static constexpr systime_t flush_interval = MS2ST(1000);
+
+    struct Slot {
+        File* file;
+        File::Offset offset;
+        Optional<File::Error> error;
+        uint32_t dropped;
+    };
+
+    static std::array<Slot, max_files> slots;
+    static std::unique_ptr<LogRing> ring;
+    static std::array<uint8_t, chunk_size> chunk;
+    static uint32_t dropped;
+    static Thread* thread;
+    static Mutex ring_mutex;
+    static Mutex io_mutex;
+
+    static bool start();
+    static void stop();
+    static void flush();
+    static msg_t static_fn(void* arg);
+};
+
+class LogFile {
+   public:
+    LogFile() = default;
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+    ~LogFile();
+
+    Optional<File::Error> append(const std::filesystem::path& filename);
+
     Optional<File::Error> write_entry(const std::string& entry);
     Optional<File::Error> write_entry(const rtc::RTC& datetime, const std::string& entry);
     Optional<File::Error> write_raw(const std::string& message);
 
    private:
     File file{};
+    int32_t slot{-1};
+
+    void close();
 };
 
 #endif /*__LOG_FILE_H__*/
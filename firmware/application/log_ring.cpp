@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "log_ring.hpp"
+
+#include <algorithm>
+
+LogRing::LogRing(const size_t capacity)
+    : data_{std::make_unique<uint8_t[]>(capacity)},
+      capacity_{capacity} {
+}
+
+bool LogRing::push(const uint8_t file, std::initializer_list<std::string_view> parts) {
+    size_t length = 0;
+    for (const auto& part : parts)
+        length += part.size();
+
+    if ((length > max_line) || (header_size + length > capacity_ - used_))
+        return false;
+
+    const uint8_t header[header_size]{
+        file,
+        static_cast<uint8_t>(length & 0xff),
+        static_cast<uint8_t>(length >> 8)};
+    put(header, header_size);
+    for (const auto& part : parts)
+        put(reinterpret_cast<const uint8_t*>(part.data()), part.size());
+    return true;
+}
+
+int32_t LogRing::next_file() const {
+    if (pending_ > 0)
+        return current_file_;
+    if (used_ < header_size)
+        return -1;
+    return at(0);
+}
+
+size_t LogRing::read(uint8_t* out, const size_t size) {
+    size_t count = 0;
+    while (count < size) {
+        if (pending_ == 0) {
+            if (used_ < header_size)
+                break;
+            // Stop where the next file begins.
+            if ((count > 0) && (at(0) != current_file_))
+                break;
+
+            uint8_t header[header_size];
+            get(header, header_size);
+            current_file_ = header[0];
+            pending_ = header[1] | (header[2] << 8);
+        }
+
+        const auto n = std::min(pending_, size - count);
+        get(&out[count], n);
+        pending_ -= n;
+        count += n;
+    }
+    return count;
+}
+
+void LogRing::put(const uint8_t* p, const size_t n) {
+    const auto tail = (head_ + used_) % capacity_;
+    const auto first = std::min(n, capacity_ - tail);
+    std::copy_n(p, first, &data_[tail]);
+    std::copy_n(p + first, n - first, &data_[0]);
+    used_ += n;
+}
+
+void LogRing::get(uint8_t* p, const size_t n) {
+    const auto first = std::min(n, capacity_ - head_);
+    std::copy_n(&data_[head_], first, p);
+    std::copy_n(&data_[0], n - first, p + first);
+    head_ = (head_ + n) % capacity_;
+    used_ -= n;
+}
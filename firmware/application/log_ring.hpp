@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __LOG_RING_H__
+#define __LOG_RING_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+
+/* Byte ring of log lines waiting to be written out. A line is stored as a
+ * three byte header, the index of its file and its length, followed by its
+ * text; a line that doesn't fit is dropped whole. */
+class LogRing {
+   public:
+    static constexpr size_t header_size = 3;
+    static constexpr size_t max_line = 0xffff;
+
+    explicit LogRing(const size_t capacity);
+
+    /* Queues the parts as one line of 'file'. False if it was dropped. */
+    bool push(const uint8_t file, std::initializer_list<std::string_view> parts);
+
+    /* File of the next text to read, -1 when empty. */
+    int32_t next_file() const;
+
+    /* Copies up to 'size' bytes of text of consecutive lines of the next
+     * file; a line may be split over reads. Returns the count copied. */
+    size_t read(uint8_t* out, const size_t size);
+
+    bool empty() const {
+        return used_ == 0;
+    }
+
+    size_t used() const {
+        return used_;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+   private:
+    std::unique_ptr<uint8_t[]> data_;
+    const size_t capacity_;
+    size_t head_{0};
+    size_t used_{0};
+
+    // What's left of the line being read.
+    uint8_t current_file_{0};
+    size_t pending_{0};
+
+    uint8_t at(const size_t offset) const {
+        return data_[(head_ + offset) % capacity_];
+    }
+
+    void put(const uint8_t* p, const size_t n);
+    void get(uint8_t* p, const size_t n);
+};
+
+#endif /*__LOG_RING_H__*/
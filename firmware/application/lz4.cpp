@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "lz4.hpp"
+
+#include <cstring>
+
+namespace lz4 {
+
+/* Reads the optional length extension bytes following a 15 nibble. */
+static bool read_length(const uint8_t*& src, const uint8_t* const src_end, size_t& length) {
+    if (length != 15)
+        return true;
+
+    uint8_t b;
+    do {
+        if (src >= src_end)
+            return false;
+        b = *src++;
+        length += b;
+    } while (b == 0xff);
+
+    return true;
+}
+
+size_t decode_block(
+    const uint8_t* src,
+    const size_t src_size,
+    uint8_t* const dst,
+    const size_t dst_capacity) {
+    const uint8_t* const src_end = src + src_size;
+    uint8_t* out = dst;
+    uint8_t* const out_end = dst + dst_capacity;
+
+    while (src < src_end) {
+        const uint8_t token = *src++;
+
+        size_t literal_length = token >> 4;
+        if (!read_length(src, src_end, literal_length))
+            return 0;
+        if (literal_length > size_t(src_end - src) || literal_length > size_t(out_end - out))
+            return 0;
+
+        std::memcpy(out, src, literal_length);
+        src += literal_length;
+        out += literal_length;
+
+        /* The last sequence of a block carries literals only. */
+        if (src == src_end)
+            break;
+
+        if (src_end - src < 2)
+            return 0;
+        const size_t offset = src[0] | (src[1] << 8);
+        src += 2;
+        if (offset == 0 || offset > size_t(out - dst))
+            return 0;
+
+        size_t match_length = token & 0x0f;
+        if (!read_length(src, src_end, match_length))
+            return 0;
+        match_length += 4;
+        if (match_length > size_t(out_end - out))
+            return 0;
+
+        const uint8_t* match = out - offset;
+        if (offset >= match_length) {
+            std::memcpy(out, match, match_length);
+            out += match_length;
+        } else {
+            /* Overlapping match, e.g. a run: the copy has to see its own output. */
+            while (match_length--)
+                *out++ = *match++;
+        }
+    }
+
+    return out - dst;
+}
+
+} /* namespace lz4 */
@@ -154,4 +154,43 @@ void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags* rds_flags, con
     frame.emplace_back(group);
 }
 
+bool PSNameDecoder::feed(const RDSGroupMessage& group) {
+    constexpr uint8_t valid_a = 1 << 0;
+    constexpr uint8_t valid_b = 1 << 1;
+    constexpr uint8_t valid_d = 1 << 3;
+
+    bool changed = false;
+    if ((group.valid & valid_a) && group.blocks[0] != pi) {
+        reset();
+        pi = group.blocks[0];
+        changed = true;
+    }
+
+    const uint16_t b = group.blocks[1];
+    const bool type_0 = (b >> 12) == 0;
+    if (!type_0 || (group.valid & (valid_b | valid_d)) != (valid_b | valid_d))
+        return changed;
+
+    const size_t segment = b & 3;
+    for (size_t i = 0; i < 2; i++) {
+        char c = group.blocks[3] >> (8 - i * 8);
+        if (c < 0x20 || c > 0x7e)
+            c = ' ';
+        if (chars[segment * 2 + i] != c) {
+            chars[segment * 2 + i] = c;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void PSNameDecoder::reset() {
+    pi = 0;
+    chars.fill(' ');
+}
+
+std::string PSNameDecoder::name() const {
+    return {chars.begin(), chars.end()};
+}
+
 } /* namespace rds */
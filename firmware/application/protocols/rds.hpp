@@ -20,9 +20,11 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <array>
 #include <string>
 #include <vector>
 #include "ch.h"
+#include "message.hpp"
 
 #ifndef __RDS_H__
 #define __RDS_H__
@@ -59,6 +61,28 @@ void gen_PSN(std::vector<RDSGroup>& frame, const std::string& psname, const RDS_
 void gen_RadioText(std::vector<RDSGroup>& frame, const std::string& text, const bool AB, const RDS_flags* rds_flags);
 void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags* rds_flags, const uint16_t year, const uint8_t month, const uint8_t day, const uint8_t hour, const uint8_t minute, const int8_t local_offset);
 
+/* Programme service name from received type 0 groups. Segments not seen
+ * yet are blanks; the name starts over when the PI code changes. */
+class PSNameDecoder {
+   public:
+    PSNameDecoder() {
+        reset();
+    }
+
+    /* Returns true when the PI code or the name changed. */
+    bool feed(const RDSGroupMessage& group);
+    void reset();
+
+    uint16_t pi_code() const {
+        return pi;
+    }
+    std::string name() const;
+
+   private:
+    uint16_t pi{0};
+    std::array<char, 8> chars{};
+};
+
 } /* namespace rds */
 
 #endif /*__RDS_H__*/
@@ -41,6 +41,7 @@ using namespace hackrf::one;
 
 #include "portapack.hpp"
 #include "portapack_persistent_memory.hpp"
+#include "portapack_shared_memory.hpp"
 
 /* Direct access to the radio. Setting values incorrectly can damage
  * the device. Applications should use ReceiverModel or TransmitterModel
@@ -97,6 +98,12 @@ static rf::Direction direction{rf::Direction::Receive};
 static bool baseband_invert = false;
 static bool mixer_invert = false;
 
+// Converter and correction offset for the current direction, see update_frequency_correction().
+static rf::Frequency frequency_correction = 0;
+static tuning::PlanCache tuning_plans{};
+static tuning::State tuning_state{};
+static RegisterWriteTrace register_trace{};
+
 void init() {
     if (hackrf_r9) {
         gpio_r9_not_ant_pwr.write(1);
@@ -110,6 +117,10 @@ void init() {
     second_if->init();
     baseband_codec.init();
     baseband_cpld.init();
+
+    first_if.set_write_trace(&register_trace, debug::trace_device_first_if);
+    second_if->set_write_trace(&register_trace, debug::trace_device_second_if);
+    tuning_state.invalidate();
 }
 
 void set_direction(const rf::Direction new_direction) {
@@ -121,6 +132,8 @@ void set_direction(const rf::Direction new_direction) {
     // hackrf::cpld::load_sram_no_verify();  // After commit "removed the use of the hackrf cpld eeprom #1732", in a H1R1,  Mic App wrong SSB TX with random USB/LSB change.
 
     direction = new_direction;
+    update_frequency_correction();
+    tuning_state.invalidate();
 
     if (hackrf_r9) {
         /*
@@ -156,52 +169,48 @@ void set_direction(const rf::Direction new_direction) {
         led_tx.on();
 }
 
-bool set_tuning_frequency(const rf::Frequency frequency) {
-    rf::Frequency final_frequency = frequency;
+void update_frequency_correction() {
+    rf::Frequency correction = 0;
     // if converter feature is enabled
     if (portapack::persistent_memory::config_converter()) {
         // downconvert
         if (portapack::persistent_memory::config_updown_converter()) {
-            final_frequency = frequency - portapack::persistent_memory::config_converter_freq();
+            correction -= portapack::persistent_memory::config_converter_freq();
         } else  // upconvert
         {
-            final_frequency = frequency + portapack::persistent_memory::config_converter_freq();
+            correction += portapack::persistent_memory::config_converter_freq();
         }
     }
     // apply frequency correction
     if (direction == rf::Direction::Transmit) {
         if (portapack::persistent_memory::config_freq_tx_correction_updown())  // tx freq correction down
-            final_frequency = final_frequency - portapack::persistent_memory::config_freq_tx_correction();
+            correction -= portapack::persistent_memory::config_freq_tx_correction();
         else  // tx freq correction up
-            final_frequency = final_frequency + portapack::persistent_memory::config_freq_tx_correction();
+            correction += portapack::persistent_memory::config_freq_tx_correction();
     } else {
         if (portapack::persistent_memory::config_freq_rx_correction_updown())  // rx freq correction down
-            final_frequency = final_frequency - portapack::persistent_memory::config_freq_rx_correction();
+            correction -= portapack::persistent_memory::config_freq_rx_correction();
         else  // rx freq correction up
-            final_frequency = final_frequency + portapack::persistent_memory::config_freq_rx_correction();
+            correction += portapack::persistent_memory::config_freq_rx_correction();
     }
+    frequency_correction = correction;
+}
 
-    const auto tuning_config = tuning::config::create(final_frequency);
-    if (tuning_config.is_valid()) {
-        first_if.disable();
-
-        // Program first local oscillator frequency (if there is one) into RFFC507x
-        if (tuning_config.first_lo_frequency) {
-            first_if.set_frequency(tuning_config.first_lo_frequency);
-            first_if.enable();
-        }
+bool set_tuning_frequency(const rf::Frequency frequency) {
+    const auto& plan = tuning_plans.get(frequency + frequency_correction);
+    if (!tuning::retune(plan, tuning_state, first_if, *second_if))
+        return false;
 
-        // Program second local oscillator frequency into MAX283x
-        const auto result_second_if = second_if->set_frequency(tuning_config.second_lo_frequency);
+    // Let the baseband tell measurements of the new frequency from stale ones.
+    shared_memory.retune_epoch = shared_memory.retune_epoch + 1;
 
-        rf_path.set_band(tuning_config.rf_path_band);
-        mixer_invert = tuning_config.mixer_invert;
+    rf_path.set_band(plan.rf_path_band);
+    if (plan.mixer_invert != mixer_invert) {
+        mixer_invert = plan.mixer_invert;
         baseband_cpld.set_invert(mixer_invert ^ baseband_invert);
-
-        return result_second_if;
-    } else {
-        return false;
     }
+
+    return true;
 }
 
 void set_rf_amp(const bool rf_amp) {
@@ -276,6 +285,7 @@ void disable() {
     baseband_codec.set_mode(max5864::Mode::Shutdown);
     second_if->set_mode(max2837::Mode::Standby);
     first_if.disable();
+    tuning_state.invalidate();
     set_rf_amp(false);
 
     led_rx.off();
@@ -292,6 +302,7 @@ uint32_t register_read(const size_t register_number) {
 
 void register_write(const size_t register_number, uint32_t value) {
     radio::first_if.write(register_number, value);
+    tuning_state.invalidate();
 }
 
 } /* namespace first_if */
@@ -304,6 +315,7 @@ uint32_t register_read(const size_t register_number) {
 
 void register_write(const size_t register_number, uint32_t value) {
     radio::second_if->write(register_number, value);
+    tuning_state.invalidate();
 }
 
 int8_t temp_sense() {
@@ -312,6 +324,14 @@ int8_t temp_sense() {
 
 } /* namespace second_if */
 
+RegisterWriteTrace& register_write_trace() {
+    return register_trace;
+}
+
+const tuning::PlanCache& tuning_plan_cache() {
+    return tuning_plans;
+}
+
 } /* namespace debug */
 
 } /* namespace radio */
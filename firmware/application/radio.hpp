@@ -23,6 +23,8 @@
 #define __RADIO_H__
 
 #include "rf_path.hpp"
+#include "dirty_registers.hpp"
+#include "tuning.hpp"
 
 #include <cstdint>
 #include <cstddef>
@@ -45,6 +47,8 @@ struct Configuration {
 void init();
 
 void set_direction(const rf::Direction new_direction);
+/* Re-read converter and frequency correction settings. */
+void update_frequency_correction();
 bool set_tuning_frequency(const rf::Frequency frequency);
 void set_rf_amp(const bool rf_amp);
 void set_lna_gain(const int_fast8_t db);
@@ -81,6 +85,13 @@ int8_t temp_sense();
 
 } /* namespace second_if */
 
+constexpr uint8_t trace_device_first_if = 0;
+constexpr uint8_t trace_device_second_if = 1;
+
+/* Register writes to the tuner chips, recorded while enabled. */
+RegisterWriteTrace& register_write_trace();
+const tuning::PlanCache& tuning_plan_cache();
+
 } /* namespace debug */
 
 } /* namespace radio */
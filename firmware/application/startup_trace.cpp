@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "startup_trace.hpp"
+
+#include "core_timer.hpp"
+#include "spi_image.hpp"
+
+#include <cstring>
+
+namespace startup_trace {
+
+static Trace trace{};
+
+const char* stage_name(const Stage stage) {
+    switch (stage) {
+        case Stage::ImageLocated:
+            return "locate";
+        case Stage::ImageDecompressed:
+            return "decompress";
+        case Stage::M4Reset:
+            return "m4 reset";
+        case Stage::BasebandReady:
+            return "baseband ready";
+        case Stage::FirstPaint:
+            return "first paint";
+    }
+    return "?";
+}
+
+void begin(const portapack::spi_flash::image_tag_t& tag) {
+    Trace::tag_t chars;
+    static_assert(sizeof(tag) == sizeof(chars), "image tag size");
+    std::memcpy(chars.data(), &tag, sizeof(chars));
+    trace.begin(core_timer::now(), chars);
+}
+
+void begin() {
+    trace.begin(core_timer::now(), {'-', '-', '-', '-'});
+}
+
+void mark(const Stage stage) {
+    trace.mark(stage, core_timer::now());
+}
+
+const Trace& last() {
+    return trace;
+}
+
+} /* namespace startup_trace */
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __STARTUP_TRACE_H__
+#define __STARTUP_TRACE_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace portapack {
+namespace spi_flash {
+struct image_tag_t;
+} /* namespace spi_flash */
+} /* namespace portapack */
+
+namespace startup_trace {
+
+/* Milestones of a baseband image switch, in the order they normally occur.
+ * Images prepared by the external app loader skip the first two. */
+enum class Stage : uint8_t {
+    ImageLocated = 0,
+    ImageDecompressed,
+    M4Reset,
+    BasebandReady,
+    FirstPaint,
+};
+
+constexpr size_t stage_count = 5;
+
+const char* stage_name(const Stage stage);
+
+/* Timestamps of the stages of the most recent image switch, relative to the
+ * moment the switch began. Each stage is only recorded the first time it is
+ * reached; the first paint closes the trace. Times are in core_timer counts and
+ * wrap-safe as long as a switch takes less than a full timer period. */
+class Trace {
+   public:
+    using tag_t = std::array<char, 4>;
+
+    void begin(const uint32_t now, const tag_t& tag) {
+        tag_ = tag;
+        start_ = now;
+        reached_ = 0;
+        active_ = true;
+        switches_++;
+    }
+
+    void mark(const Stage stage, const uint32_t now) {
+        const auto n = static_cast<size_t>(stage);
+        if (!active_ || reached(stage))
+            return;
+
+        const uint32_t elapsed = now - start_;
+        elapsed_[n] = elapsed;
+        if (elapsed > worst_[n])
+            worst_[n] = elapsed;
+        reached_ |= (1 << n);
+
+        if (stage == Stage::FirstPaint)
+            active_ = false;
+    }
+
+    bool active() const {
+        return active_;
+    }
+
+    bool reached(const Stage stage) const {
+        return reached_ & (1 << static_cast<size_t>(stage));
+    }
+
+    /* Time from the start of the switch to the stage, 0 if not reached. */
+    uint32_t elapsed(const Stage stage) const {
+        return reached(stage) ? elapsed_[static_cast<size_t>(stage)] : 0;
+    }
+
+    /* Longest time to the stage over all switches since boot. */
+    uint32_t worst(const Stage stage) const {
+        return worst_[static_cast<size_t>(stage)];
+    }
+
+    const tag_t& tag() const {
+        return tag_;
+    }
+
+    uint32_t switches() const {
+        return switches_;
+    }
+
+   private:
+    tag_t tag_{};
+    uint32_t start_{0};
+    std::array<uint32_t, stage_count> elapsed_{};
+    std::array<uint32_t, stage_count> worst_{};
+    uint32_t switches_{0};
+    uint8_t reached_{0};
+    bool active_{false};
+};
+
+/* Starts tracing a switch to the given image; an untagged (prepared) image
+ * is recorded as "----". */
+void begin(const portapack::spi_flash::image_tag_t& tag);
+void begin();
+
+void mark(const Stage stage);
+
+const Trace& last();
+
+} /* namespace startup_trace */
+
+#endif /*__STARTUP_TRACE_H__*/
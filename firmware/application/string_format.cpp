@@ -21,6 +21,8 @@
 
 #include "string_format.hpp"
 
+#include <algorithm>
+
 using namespace std::literals;
 
 /* This takes a pointer to the end of a buffer
@@ -112,12 +114,11 @@ std::string to_string_bin(
     return p;
 }
 
-std::string to_string_dec_uint(
+static char* to_string_dec_uint_justify_internal(
+    char* const term,
     const uint32_t n,
     const int32_t l,
     const char fill) {
-    char p[16];
-    auto term = p + sizeof(p) - 1;
     auto q = to_string_dec_uint_pad_internal(term, n, l, fill);
 
     // Right justify.
@@ -129,15 +130,14 @@ std::string to_string_dec_uint(
     return q;
 }
 
-std::string to_string_dec_int(
+static char* to_string_dec_int_justify_internal(
+    char* const term,
     const int32_t n,
     const int32_t l,
     const char fill) {
     const size_t negative = (n < 0) ? 1 : 0;
     uint32_t n_abs = negative ? -n : n;
 
-    char p[16];
-    auto term = p + sizeof(p) - 1;
     auto q = to_string_dec_uint_pad_internal(term, n_abs, l - negative, fill);
 
     // Add sign.
@@ -154,6 +154,92 @@ std::string to_string_dec_int(
     return q;
 }
 
+std::string to_string_dec_uint(
+    const uint32_t n,
+    const int32_t l,
+    const char fill) {
+    char p[16];
+    return to_string_dec_uint_justify_internal(p + sizeof(p) - 1, n, l, fill);
+}
+
+std::string to_string_dec_int(
+    const int32_t n,
+    const int32_t l,
+    const char fill) {
+    char p[16];
+    return to_string_dec_int_justify_internal(p + sizeof(p) - 1, n, l, fill);
+}
+
+StringFormatter::StringFormatter(char* buffer, size_t size)
+    : buffer_{buffer},
+      capacity_{size - 1} {
+    buffer_[0] = 0;
+}
+
+void StringFormatter::clear() {
+    length_ = 0;
+    truncated_ = false;
+    buffer_[0] = 0;
+}
+
+StringFormatter& StringFormatter::append(std::string_view str) {
+    auto count = str.size();
+    if (count > capacity_ - length_) {
+        count = capacity_ - length_;
+        truncated_ = true;
+    }
+
+    std::copy_n(str.data(), count, &buffer_[length_]);
+    length_ += count;
+    buffer_[length_] = 0;
+    return *this;
+}
+
+StringFormatter& StringFormatter::append(char c) {
+    return append(std::string_view{&c, 1});
+}
+
+StringFormatter& StringFormatter::append_dec_int(int64_t n) {
+    StringFormatBuffer b;
+    size_t len;
+    auto str = to_string_dec_int(n, b, len);
+    return append({str, len});
+}
+
+StringFormatter& StringFormatter::append_dec_uint(uint64_t n) {
+    StringFormatBuffer b;
+    size_t len;
+    auto str = to_string_dec_uint(n, b, len);
+    return append({str, len});
+}
+
+StringFormatter& StringFormatter::append_dec_int(const int32_t n, const int32_t l, const char fill) {
+    char p[16];
+    return append(to_string_dec_int_justify_internal(p + sizeof(p) - 1, n, l, fill));
+}
+
+StringFormatter& StringFormatter::append_dec_uint(const uint32_t n, const int32_t l, const char fill) {
+    char p[16];
+    return append(to_string_dec_uint_justify_internal(p + sizeof(p) - 1, n, l, fill));
+}
+
+StringFormatter& StringFormatter::append_hex(uint64_t n, int32_t length) {
+    for (auto i = std::clamp<int32_t>(length, 0, 32); i > 0; i--)
+        append(uint_to_char((i <= 16) ? (n >> ((i - 1) * 4)) & 0xF : 0, 16));
+    return *this;
+}
+
+StringFormatter& StringFormatter::append_hex_array(const uint8_t* array, size_t length) {
+    for (size_t i = 0; i < length; i++)
+        append_hex(array[i]);
+    return *this;
+}
+
+// right-justified frequency in MHz, rounded to 4 decimal places, always 9 characters
+StringFormatter& StringFormatter::append_short_freq(const uint64_t f) {
+    return append_dec_int((f + 50) / 1000000, 4).append('.').append_dec_int(((f + 50) / 100) % 10000, 4, '0');
+}
+
 std::string to_string_decimal(float decimal, int8_t precision) {
     double integer_part;
     double fractional_part;
@@ -211,8 +297,8 @@ std::string to_string_freq(const uint64_t f) {
 
 // right-justified frequency in MHz, rounded to 4 decimal places, always 9 characters
 std::string to_string_short_freq(const uint64_t f) {
-    auto final_str = to_string_dec_int((f + 50) / 1000000, 4) + "." + to_string_dec_int(((f + 50) / 100) % 10000, 4, '0');
-    return final_str;
+    FixedString<16> str;
+    return std::string{str.append_short_freq(f).view()};
 }
 
 // non-justified non-padded frequency in MHz, rounded to specified number of decimal places
@@ -281,8 +367,10 @@ std::string to_string_hex_array(uint8_t* array, int32_t length) {
     std::string str_return;
     str_return.reserve(length * 2);
 
-    for (uint8_t i = 0; i < length; i++)
-        str_return += to_string_hex(array[i], 2);
+    for (uint8_t i = 0; i < length; i++) {
+        str_return += uint_to_char(array[i] >> 4, 16);
+        str_return += uint_to_char(array[i] & 0xF, 16);
+    }
 
     return str_return;
 }
@@ -47,6 +47,76 @@ using StringFormatBuffer = std::array<char, 24>;
 char* to_string_dec_int(int64_t n, StringFormatBuffer& buffer, size_t& length);
 char* to_string_dec_uint(uint64_t n, StringFormatBuffer& buffer, size_t& length);
 
+/* Appends formatted text to a caller supplied buffer without allocating.
+ * Text that doesn't fit is dropped and the buffer is always terminated, so
+ * view() and c_str() stay valid for as long as the buffer does. */
+class StringFormatter {
+   public:
+    StringFormatter(char* buffer, size_t size);
+
+    StringFormatter(const StringFormatter&) = delete;
+    StringFormatter& operator=(const StringFormatter&) = delete;
+
+    void clear();
+
+    StringFormatter& append(std::string_view str);
+    StringFormatter& append(char c);
+
+    /* Same output as the std::string versions of the same name. */
+    StringFormatter& append_dec_int(int64_t n);
+    StringFormatter& append_dec_uint(uint64_t n);
+    StringFormatter& append_dec_int(const int32_t n, const int32_t l, const char fill = 0);
+    StringFormatter& append_dec_uint(const uint32_t n, const int32_t l, const char fill = ' ');
+    StringFormatter& append_hex(uint64_t n, int32_t length);
+    StringFormatter& append_hex_array(const uint8_t* array, size_t length);
+    StringFormatter& append_short_freq(const uint64_t f);
+
+    template <typename T>
+    StringFormatter& append_hex(T n) {
+        return append_hex(n, sizeof(T) * 2);
+    }
+
+    std::string_view view() const {
+        return {buffer_, length_};
+    }
+
+    const char* c_str() const {
+        return buffer_;
+    }
+
+    size_t size() const {
+        return length_;
+    }
+
+    /* True if anything was dropped since the last clear(). */
+    bool truncated() const {
+        return truncated_;
+    }
+
+   private:
+    char* const buffer_;
+    const size_t capacity_;
+    size_t length_{0};
+    bool truncated_{false};
+};
+
+/* Room for FixedString's characters. A base listed ahead of
+ * StringFormatter, so it is constructed before the formatter terminates it. */
+template <size_t N>
+struct FixedStringStorage {
+    std::array<char, N + 1> storage_;
+};
+
+/* A StringFormatter with its own room for N characters, sized at compile
+ * time to the longest text of the call site and usually kept on the stack. */
+template <size_t N>
+class FixedString : private FixedStringStorage<N>, public StringFormatter {
+   public:
+    FixedString()
+        : StringFormatter{this->storage_.data(), this->storage_.size()} {
+    }
+};
+
 std::string to_string_dec_int(int64_t n);
 std::string to_string_dec_uint(uint64_t n);
 
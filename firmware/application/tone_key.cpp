@@ -23,6 +23,9 @@
 
 #include "string_format.hpp"
 #include "tone_key.hpp"
+#include "message.hpp"
+
+#include <algorithm>
 
 namespace tonekey {
 
@@ -109,19 +112,9 @@ std::string tone_key_value_string(tone_index index) {
 // Return variable-length string showing CTCSS tone from tone frequency
 // Value is in 0.01 Hz units
 std::string tone_key_string_by_value(uint32_t value, size_t max_length) {
-    static uint8_t tone_display_toggle{0};
-    static uint32_t last_value;
     tone_index idx;
     std::string freq_str;
 
-    // If >10Hz difference between consecutive samples, it's probably noise, so ignore
-    if (abs(value - last_value) > 10 * 100) {
-        last_value = value;
-        tone_display_toggle = 0;
-        return "        ";
-    }
-    last_value = value;
-
     // Only display 1/10 Hz accuracy if <1000 Hz; max 5 characters
     if (value < 1000 * 100)
         freq_str = "T:" + fx100_string(value);
@@ -129,24 +122,33 @@ std::string tone_key_string_by_value(uint32_t value, size_t max_length) {
         freq_str = "T:" + to_string_dec_uint(value / 100);
 
     // Check field length is enough for character counts in the string below
+    // (the baseband only reports confirmed tones, so there is no noise to filter here)
     if (max_length >= 7 + 2 + 5) {
         idx = tone_key_index_by_value(value);
         if (idx != -1)
             return freq_str + " #" + tone_key_string(idx);
-    } else {
-        // Not enough space; toggle between display of tone received and tone code #
-        if (tone_display_toggle++ >= TONE_DISPLAY_TOGGLE_COUNTER) {
-            if (tone_display_toggle >= TONE_DISPLAY_TOGGLE_COUNTER * 2) tone_display_toggle = 0;
-
-            // Look for a match in the table (otherwise just display frequency)
-            idx = tone_key_index_by_value(value);
-            if (idx != -1)
-                return "T:" + tone_key_string(idx);
-        }
     }
     return freq_str;
 }
 
+// Return string showing a DCS code, e.g. "DCS:023"
+std::string dcs_code_string(uint32_t code) {
+    // DCS codes are conventionally written as three octal digits
+    return std::string{"DCS:"} + char('0' + ((code >> 6) & 7)) + char('0' + ((code >> 3) & 7)) + char('0' + (code & 7));
+}
+
+// Return string showing the sub-tone reported by the baseband, blank if none
+std::string coded_squelch_string(const CodedSquelchMessage& message, size_t max_length) {
+    switch (message.type) {
+        case CodedSquelchMessage::Type::CTCSS:
+            return tone_key_string_by_value(message.value, max_length);
+        case CodedSquelchMessage::Type::DCS:
+            return dcs_code_string(message.value);
+        default:
+            return std::string(std::min<size_t>(max_length, 8), ' ');
+    }
+}
+
 // Search tone_key table for tone frequency value
 // Value is in 0.01 Hz units
 tone_index tone_key_index_by_value(uint32_t value) {
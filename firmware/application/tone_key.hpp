@@ -29,10 +29,11 @@
 #include <string_view>
 #include <vector>
 
+class CodedSquelchMessage;
+
 namespace tonekey {
 
 #define TONE_FREQ_TOLERANCE_CENTIHZ (4 * 100)
-#define TONE_DISPLAY_TOGGLE_COUNTER 3
 #define F2Ix100(x) (int32_t)(x * 100.0 + 0.5)  // add 0.5f to round vs truncate during FP->int conversion
 
 using tone_index = int32_t;
@@ -46,6 +47,8 @@ std::string fx100_string(uint32_t f);
 std::string tone_key_string(tone_index index);
 std::string tone_key_value_string(tone_index index);
 std::string tone_key_string_by_value(uint32_t value, size_t max_length);
+std::string dcs_code_string(uint32_t code);
+std::string coded_squelch_string(const CodedSquelchMessage& message, size_t max_length);
 tone_index tone_key_index_by_value(uint32_t value);
 
 }  // namespace tonekey
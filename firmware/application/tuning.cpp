@@ -77,4 +77,39 @@ Config create(const rf::Frequency target_frequency) {
 }
 
 } /* namespace config */
+
+Plan create_plan(const rf::Frequency frequency) {
+    const auto config = config::create(frequency);
+    return {
+        frequency,
+        config.first_lo_frequency,
+        config.second_lo_frequency,
+        config.rf_path_band,
+        config.mixer_invert,
+    };
+}
+
+size_t PlanCache::index(const rf::Frequency frequency) {
+    /* Fibonacci hashing, spreads evenly spaced channels over the entries. */
+    const uint64_t hash = static_cast<uint64_t>(frequency) * 0x9E3779B97F4A7C15ULL;
+    return hash >> (64 - entry_bits);
+}
+
+const Plan& PlanCache::get(const rf::Frequency frequency) {
+    auto& entry = entries_[index(frequency)];
+    if (entry.is_valid() && entry.frequency == frequency) {
+        hits_++;
+    } else {
+        misses_++;
+        entry = create_plan(frequency);
+    }
+    return entry;
+}
+
+void PlanCache::clear() {
+    entries_.fill({});
+    hits_ = 0;
+    misses_ = 0;
+}
+
 } /* namespace tuning */
@@ -24,6 +24,10 @@
 
 #include "rf_path.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 namespace tuning {
 namespace config {
 
@@ -60,6 +64,98 @@ struct Config {
 Config create(const rf::Frequency target_frequency);
 
 } /* namespace config */
+
+/* Precomputed tuning configuration for one (corrected) frequency. */
+struct Plan {
+    rf::Frequency frequency{0};
+    rf::Frequency first_lo_frequency{0};
+    rf::Frequency second_lo_frequency{0};
+    rf::path::Band rf_path_band{rf::path::Band::Mid};
+    bool mixer_invert{false};
+
+    bool is_valid() const {
+        return (second_lo_frequency != 0);
+    }
+};
+
+Plan create_plan(const rf::Frequency frequency);
+
+/* Small direct-mapped cache of tuning plans. Scanning apps retune over the
+ * same set of frequencies repeatedly, so most retunes become a lookup. */
+class PlanCache {
+   public:
+    static constexpr size_t entry_bits = 6;
+    static constexpr size_t entry_count = 1 << entry_bits;
+
+    const Plan& get(const rf::Frequency frequency);
+    void clear();
+
+    uint32_t hits() const { return hits_; }
+    uint32_t misses() const { return misses_; }
+
+   private:
+    std::array<Plan, entry_count> entries_{};
+    uint32_t hits_{0};
+    uint32_t misses_{0};
+
+    static size_t index(const rf::Frequency frequency);
+};
+
+/* The LO frequencies currently programmed into the tuner chips. A zero first
+ * LO means the first IF (mixer) is disabled. */
+struct State {
+    rf::Frequency first_lo_frequency{0};
+    rf::Frequency second_lo_frequency{0};
+    bool known{false};
+
+    /* Force the next retune to reprogram everything, e.g. after the
+     * tuner chips were disabled or written to directly. retune() then
+     * has the drivers rewrite every register, not just changed ones. */
+    void invalidate() {
+        known = false;
+    }
+};
+
+/* Program the LOs for a plan, touching only what differs from the current
+ * state. The first IF is only disabled/reprogrammed/re-enabled when the
+ * first LO actually changes. Templated on the tuner drivers so the
+ * sequencing can be exercised off-target. */
+template <typename FirstIF, typename SecondIF>
+bool retune(const Plan& plan, State& state, FirstIF& first_if, SecondIF& second_if) {
+    if (!plan.is_valid())
+        return false;
+
+    // The chips may no longer match the drivers' register copies.
+    if (!state.known) {
+        first_if.invalidate();
+        second_if.invalidate();
+    }
+
+    if (!state.known || (plan.first_lo_frequency != state.first_lo_frequency)) {
+        if (!state.known || state.first_lo_frequency != 0)
+            first_if.disable();
+
+        // Program first local oscillator frequency (if there is one) into RFFC507x
+        if (plan.first_lo_frequency) {
+            first_if.set_frequency(plan.first_lo_frequency);
+            first_if.enable();
+        }
+        state.first_lo_frequency = plan.first_lo_frequency;
+    }
+
+    // Program second local oscillator frequency into MAX283x
+    if (!state.known || (plan.second_lo_frequency != state.second_lo_frequency)) {
+        if (!second_if.set_frequency(plan.second_lo_frequency)) {
+            state.invalidate();
+            return false;
+        }
+        state.second_lo_frequency = plan.second_lo_frequency;
+    }
+
+    state.known = true;
+    return true;
+}
+
 } /* namespace tuning */
 
 #endif /*__TUNING_H__*/
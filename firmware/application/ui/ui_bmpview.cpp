@@ -1,6 +1,9 @@
 #include "ui_bmpview.hpp"
 #include "portapack.hpp"
 
+#include <algorithm>
+#include <vector>
+
 bool BMPViewer::load_bmp(const std::filesystem::path& file) {
     if (!bmp.open(file, true)) return false;
     // calc default zoom level to fit screen, and min / max zoom too
@@ -85,23 +88,24 @@ void BMPViewer::set_zoom(int8_t new_zoom) {
     set_dirty();
 }
 
-// reads a lint from the bmp's bx, by coordinate to the line that's size is cnt. according to zoom
+// reads a line from the bmp's bx, by coordinate to the line that's size is cnt. according to zoom
 void BMPViewer::get_line(ui::Color* line, uint32_t bx, uint32_t by, uint32_t cnt) {
     if (!bmp.is_loaded()) return;
-    uint32_t last_targetx = 65534;
-    for (uint32_t x = 0; x < cnt; x++) {
-        uint32_t targetx = (zoom < 0) ? bx + x * -1 * zoom : bx + x / zoom;  // on zoom out could probably avg the pixels, or apply some smoothing, but this is way faster.
-        if (last_targetx == targetx) {
-            line[x] = line[x - 1];
-            continue;
-        }
-        last_targetx = targetx;
-        if (!bmp.seek(targetx, by)) {
-            line[x] = Color::white();  // can't seek there
-        } else {
-            bmp.read_next_px(line[x], false);
-        }
+    if (zoom < 0) {
+        // box filter while the blocks are small, nearest pixel is way faster beyond that
+        const uint32_t step = -1 * zoom;
+        if (!bmp.read_row(bx, by, line, cnt, step, step <= 4))
+            std::fill(line, line + cnt, Color::white());
+        return;
+    }
+    // read the source pixels once, then repeat each of them zoom times (in place, from the end)
+    const uint32_t src_cnt = (cnt + zoom - 1) / zoom;
+    if (!bmp.read_row(bx, by, line, src_cnt)) {
+        std::fill(line, line + cnt, Color::white());
+        return;
     }
+    for (uint32_t x = cnt; x-- > 0;)
+        line[x] = line[x / zoom];
 }
 
 void BMPViewer::paint(Painter& painter) {
@@ -116,14 +120,18 @@ void BMPViewer::paint(Painter& painter) {
 
     uint32_t by = cy;  // we start to read from there
     uint32_t last_by = 65534;
-    ui::Color* line = new ui::Color[d_width];
+    std::vector<ui::Color> line(d_width);
     for (int32_t y = 0; y < d_height; y++) {
         by = cy + ((zoom < 0) ? y * -1 * zoom : y / (int32_t)zoom);
-        if (by != last_by) get_line(line, cx, by, d_width);
-        last_by = by;
-        portapack::display.draw_pixels({rect.left(), rect.top() + y, d_width, 1}, line, d_width);
+        if (by >= bmp.get_real_height()) {
+            std::fill(line.begin(), line.end(), Color::white());
+            last_by = 65534;
+        } else if (by != last_by) {
+            get_line(line.data(), cx, by, d_width);
+            last_by = by;
+        }
+        portapack::display.draw_pixels({rect.left(), rect.top() + y, d_width, 1}, line);
     }
-    delete line;
 }
 
 int8_t BMPViewer::get_zoom() {
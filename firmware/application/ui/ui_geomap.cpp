@@ -570,18 +570,37 @@ void GeoMap::clear_markers() {
     markerListLen = 0;
 }
 
-MapMarkerStored GeoMap::store_marker(GeoMarker& marker) {
+bool GeoMap::in_view(float lat, float lon) {
     const auto r = screen_rect();
-    MapMarkerStored ret;
 
     // Check if it could be on screen
     // (Shows more distant planes when zoomed out)
-    GeoPoint mapPoint = lat_lon_to_map_pixel(marker.lat, marker.lon);
+    GeoPoint mapPoint = lat_lon_to_map_pixel(lat, lon);
     int x_dist = abs((int)mapPoint.x - (int)x_pos);
     int y_dist = abs((int)mapPoint.y - (int)y_pos);
     int zoom_out = (map_zoom < 0) ? -map_zoom : 1;
 
-    if ((x_dist >= (zoom_out * r.width() / 2)) || (y_dist >= (zoom_out * r.height() / 2))) {
+    return (x_dist < (zoom_out * r.width() / 2)) && (y_dist < (zoom_out * r.height() / 2));
+}
+
+bool GeoMap::area_in_view(float lat_min, float lon_min, float lat_max, float lon_max) {
+    const auto r = screen_rect();
+    int zoom_out = (map_zoom < 0) ? -map_zoom : 1;
+    const int half_width = zoom_out * r.width() / 2;
+    const int half_height = zoom_out * r.height() / 2;
+
+    // Map y grows southwards.
+    GeoPoint south_west = lat_lon_to_map_pixel(lat_min, lon_min);
+    GeoPoint north_east = lat_lon_to_map_pixel(lat_max, lon_max);
+
+    return ((int)north_east.x > (int)x_pos - half_width) && ((int)south_west.x < (int)x_pos + half_width) &&
+           ((int)south_west.y > (int)y_pos - half_height) && ((int)north_east.y < (int)y_pos + half_height);
+}
+
+MapMarkerStored GeoMap::store_marker(GeoMarker& marker) {
+    MapMarkerStored ret;
+
+    if (!in_view(marker.lat, marker.lon)) {
         ret = MARKER_NOT_STORED;
     } else if (markerListLen < NumMarkerListElements) {
         markerList[markerListLen] = marker;
@@ -233,6 +233,10 @@ class GeoMap : public Widget {
     void clear_markers();
     MapMarkerStored store_marker(GeoMarker& marker);
 
+    // Whether a position, or any part of a lat/lon box, could be on screen.
+    bool in_view(float lat, float lon);
+    bool area_in_view(float lat_min, float lon_min, float lat_max, float lon_max);
+
     static const Dim banner_height = GEOMAP_BANNER_HEIGHT;
     static const Dim geomap_rect_width = GEOMAP_RECT_WIDTH;
     static const Dim geomap_rect_height = GEOMAP_RECT_HEIGHT;
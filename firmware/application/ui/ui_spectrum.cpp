@@ -28,6 +28,8 @@ using namespace portapack;
 #include "baseband_api.hpp"
 
 #include "string_format.hpp"
+#include "file_path.hpp"
+#include "core_timer.hpp"
 
 #include <cmath>
 #include <array>
@@ -253,14 +255,20 @@ bool FrequencyScale::on_touch(const TouchEvent touch) {
 }
 
 /* WaterfallWidget *********************************************************/
-// TODO: buffer and use "paint" instead of immediate drawing would help with
-// preventing flicker from drawing. Would use more RAM however.
+// Lines are drawn straight to the LCD as they arrive. Views that opt in also
+// keep them in a history ring (spilling to SD) so the waterfall can be redrawn
+// after being covered, and scrolled back by dragging it. Basebands using SpectrumCollector color
+// the lines themselves, leaving only batched blits to do here.
 
 void WaterfallWidget::on_show() {
     clear();
 
     const auto screen_r = screen_rect();
     display.scroll_set_area(screen_r.top(), screen_r.bottom());
+
+    // Also called on a layout change; the history carries on across that.
+    if (history_enabled && !history)
+        open_history();
 }
 
 void WaterfallWidget::on_hide() {
@@ -268,35 +276,143 @@ void WaterfallWidget::on_hide() {
      * position?
      */
     display.scroll_disable();
+
+    close_history();
+}
+
+void WaterfallWidget::set_history(const bool enabled) {
+    history_enabled = enabled;
+    if (!enabled)
+        close_history();
+}
+
+void WaterfallWidget::paint(Painter&) {
+    if (!history)
+        return;
+
+    // Redraw from the history, newest line at the top of the scroll area.
+    for (Coord k = 0; k < screen_rect().height(); k++)
+        draw_history_line(k);
 }
 
 void WaterfallWidget::on_channel_spectrum(
     const ChannelSpectrum& spectrum) {
     /* TODO: static_assert that message.spectrum.db.size() >= pixel_row.size() */
 
-    std::array<Color, 240> pixel_row;
+    WaterfallHistory::Line bins;
     for (size_t i = 0; i < 120; i++) {
-        const auto pixel_color = gradient.lut[spectrum.db[256 - 120 + i]];
-        pixel_row[i] = pixel_color;
+        bins[i] = spectrum.db[256 - 120 + i];
     }
 
     for (size_t i = 120; i < 240; i++) {
-        const auto pixel_color = gradient.lut[spectrum.db[i - 120]];
-        pixel_row[i] = pixel_color;
+        bins[i] = spectrum.db[i - 120];
+    }
+
+    if (history)
+        history->push(bins);
+
+    if (scrollback_lines > 0) {
+        // Keep the same lines on screen while scrolled back.
+        scrollback_lines = std::min(scrollback_lines + 1, history_lines() - 1);
+        return;
     }
 
     const auto draw_y = display.scroll(1);
+    draw_line(draw_y, bins);
+}
 
-    display.draw_pixels(
-        {{0, draw_y}, {pixel_row.size(), 1}},
-        pixel_row);
+void WaterfallWidget::on_rows(WaterfallRowFIFO& rows) {
+    // The ring only holds max_row_batch rows and the baseband keeps filling
+    // it while they are drawn, so carry on until it's empty (or the frame's
+    // time is spent) rather than cap the waterfall at a batch per frame.
+    const auto start = core_timer::now();
+    while (!rows.is_empty() && core_timer::elapsed_us(start) < rows_budget_us)
+        draw_rows(rows);
+}
+
+void WaterfallWidget::draw_rows(WaterfallRowFIFO& rows) {
+    static_assert(sizeof(Color) == sizeof(uint16_t), "Rows are blitted as Colors");
+    static_assert(WaterfallRow::width == WaterfallHistory::line_width, "Row and history widths differ");
+
+    const auto count = std::min(rows.len(), max_row_batch);
+    if (count == 0)
+        return;
+
+    if (history) {
+        for (size_t i = 0; i < count; i++)
+            history->push(rows.peek(i)->bins);
+    }
+
+    if (scrollback_lines > 0) {
+        scrollback_lines = std::min(scrollback_lines + count, history_lines() - 1);
+        rows.skip_n(count);
+        return;
+    }
+
+    // One scroll for the batch, newest row at the top of the scroll area.
+    display.scroll(count);
+    std::array<const Color*, max_row_batch> lines;
+    for (size_t k = 0; k < count; k++)
+        lines[k] = reinterpret_cast<const Color*>(rows.peek(count - 1 - k)->pixels.data());
+
+    // Rows are contiguous on the LCD except where the scroll area wraps.
+    for (size_t k = 0; k < count;) {
+        const auto y = display.scroll_area_y(k);
+        size_t n = 1;
+        while ((k + n < count) && (display.scroll_area_y(k + n) == y + static_cast<Coord>(n)))
+            n++;
+        display.draw_pixel_rows({{0, y}, {WaterfallRow::width, static_cast<Dim>(n)}}, &lines[k]);
+        k += n;
+    }
+    rows.skip_n(count);
+}
+
+void WaterfallWidget::set_scrollback(const size_t lines) {
+    const auto available = history ? history_lines() : 0;
+    const auto clamped = std::min(lines, available > 0 ? available - 1 : 0);
+    if (clamped == scrollback_lines)
+        return;
+
+    const int32_t delta = clamped - scrollback_lines;
+    const Coord height = screen_rect().height();
+    scrollback_lines = clamped;
+    if (std::abs(delta) >= height) {
+        set_dirty();
+        return;
+    }
+
+    // Move what's on screen and only draw the lines uncovered, rather than
+    // going back to the history (and the SD card) for all of them.
+    display.scroll(-delta);
+    const Coord first = (delta > 0) ? height - delta : 0;
+    const Coord last = (delta > 0) ? height : -delta;
+    for (Coord k = first; k < last; k++)
+        draw_history_line(k);
 }
 
 bool WaterfallWidget::on_touch(const TouchEvent event) {
-    if (event.type == TouchEvent::Type::Start) {
-        if (on_touch_select) {
-            on_touch_select(event.point.x(), event.point.y());
+    switch (event.type) {
+        case TouchEvent::Type::Start:
+            touch_start_y = event.point.y();
+            touch_start_scrollback = scrollback_lines;
+            dragging = false;
+            if (on_touch_select) {
+                on_touch_select(event.point.x(), event.point.y());
+            }
+            break;
+
+        case TouchEvent::Type::Move: {
+            // Dragging up reveals older lines, dragging back down returns to live.
+            const auto dy = touch_start_y - event.point.y();
+            if (!dragging && std::abs(dy) < drag_threshold)
+                break;
+            dragging = true;
+            set_scrollback(std::max<int32_t>(static_cast<int32_t>(touch_start_scrollback) + dy, 0));
+            break;
         }
+
+        case TouchEvent::Type::End:
+            break;
     }
     return true;
 }
@@ -307,6 +423,65 @@ void WaterfallWidget::clear() {
         Color::black());
 }
 
+void WaterfallWidget::draw_line(const Coord y, const WaterfallHistory::Line& bins) {
+    std::array<Color, WaterfallHistory::line_width> pixel_row;
+    for (size_t i = 0; i < pixel_row.size(); i++) {
+        pixel_row[i] = gradient.lut[bins[i]];
+    }
+
+    display.draw_pixels(
+        {{0, y}, {pixel_row.size(), 1}},
+        pixel_row);
+}
+
+/* Line k of the scroll area, k = 0 being the top. */
+void WaterfallWidget::draw_history_line(const Coord k) {
+    WaterfallHistory::Line bins;
+    const auto y = display.scroll_area_y(k);
+    if (history_line(scrollback_lines + k, bins))
+        draw_line(y, bins);
+    else
+        display.fill_rectangle({{screen_rect().left(), y}, {screen_rect().width(), 1}}, Color::black());
+}
+
+void WaterfallWidget::open_history() {
+    history = std::make_unique<WaterfallHistory>(history_capacity);
+    scrollback_lines = 0;
+
+    // Without an SD card the history is just shorter.
+    spill = std::make_unique<WaterfallSpill>();
+    if (!spill->open(waterfalls_dir / u"HISTORY.WFH"))
+        spill.reset();
+
+    history->on_evict = [this](const WaterfallHistory::Line& line) {
+        // Lines given up by the spill shorten the history, not break it.
+        if (spill && !spill->push(line))
+            scrollback_lines = std::min(scrollback_lines, history->size());
+    };
+}
+
+void WaterfallWidget::close_history() {
+    spill.reset();
+    history.reset();
+    scrollback_lines = 0;
+}
+
+size_t WaterfallWidget::history_lines() const {
+    return history->size() + (spill ? spill->size() : 0);
+}
+
+/* Line by age, from the RAM ring first and then from the spill file. */
+bool WaterfallWidget::history_line(const size_t age, WaterfallHistory::Line& line) {
+    if (age < history->size())
+        return history->get(age, line);
+
+    const auto spill_age = age - history->size();
+    if (!spill || spill_age >= spill->size())
+        return false;
+
+    return spill->get(spill->size() - 1 - spill_age, line);
+}
+
 /* WaterfallView *******************************************************/
 
 WaterfallView::WaterfallView(const bool cursor) {
@@ -347,19 +522,31 @@ void WaterfallView::on_hide() {
 
 void WaterfallView::start() {
     if (!running_) {
+        rows_fifo = nullptr;
         baseband::spectrum_streaming_start();
+        // Basebands that can color rows answer with a row ring; the rest
+        // keep sending plain spectra and are drawn here as before.
+        rows_tag++;
+        baseband::set_waterfall_palette(
+            reinterpret_cast<const uint16_t*>(waterfall_widget.gradient.lut.data()),
+            rows_tag);
         running_ = true;
     }
 }
 
 void WaterfallView::stop() {
     if (running_) {
+        channel_fifo = nullptr;
+        rows_fifo = nullptr;
+        baseband::set_waterfall_palette(nullptr, rows_tag);
         baseband::spectrum_streaming_stop();
         running_ = false;
     }
 }
 
 void WaterfallView::show_audio_spectrum_view(const bool show) {
+    // Every time, as the baseband may have been changed under the view.
+    baseband::set_audio_tap(show);
     if ((audio_spectrum_view && show) || (!audio_spectrum_view && !show)) return;
 
     if (show) {
@@ -395,7 +582,9 @@ void WaterfallView::set_parent_rect(const Rect new_parent_rect) {
 }
 
 void WaterfallView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
-    waterfall_widget.on_channel_spectrum(spectrum);
+    // With rows coming from the baseband the spectrum only carries metadata.
+    if (!rows_fifo)
+        waterfall_widget.on_channel_spectrum(spectrum);
     sampling_rate = spectrum.sampling_rate;
     frequency_scale.set_spectrum_sampling_rate(sampling_rate);
     frequency_scale.set_channel_filter(
@@ -405,7 +594,8 @@ void WaterfallView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 }
 
 void WaterfallView::on_audio_spectrum() {
-    audio_spectrum_view->on_audio_spectrum(audio_spectrum_data);
+    if (audio_spectrum_view)
+        audio_spectrum_view->on_audio_spectrum(audio_spectrum_data);
 }
 
 } /* namespace spectrum */
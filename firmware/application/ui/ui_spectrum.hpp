@@ -30,9 +30,12 @@
 #include "event_m0.hpp"
 
 #include "message.hpp"
+#include "waterfall_history.hpp"
+#include "waterfall_spill.hpp"
 
 #include <cstdint>
 #include <cstddef>
+#include <memory>
 
 namespace ui {
 namespace spectrum {
@@ -117,13 +120,49 @@ class WaterfallWidget : public Widget {
 
     void on_show() override;
     void on_hide() override;
-    void paint(Painter&) override {}
+    void paint(Painter&) override;
     bool on_touch(const TouchEvent event) override;
 
     void on_channel_spectrum(const ChannelSpectrum& spectrum);
+    /* Blits the rows colored by the baseband, all of them under one scroll. */
+    void on_rows(WaterfallRowFIFO& rows);
+
+    /* Keeps a history of the lines so they can be redrawn and scrolled
+     * back through. Off by default: while shown it takes about 9KB of
+     * heap (the RAM ring and its records, the spill batches, file and
+     * writer thread). */
+    void set_history(const bool enabled);
+
+    /* Lines back from the newest shown at the top; 0 is live. While scrolled
+     * back the view holds still and new lines only go to the history. */
+    void set_scrollback(const size_t lines);
+    size_t scrollback() const {
+        return scrollback_lines;
+    }
 
    private:
+    static constexpr size_t history_capacity = 4 * 1024;
+    static constexpr Coord drag_threshold = 4;
+    static constexpr size_t max_row_batch = 1 << WaterfallRowsConfigMessage::fifo_k;
+    static constexpr uint32_t rows_budget_us = 8000;
+
+    bool history_enabled{false};
+    std::unique_ptr<WaterfallHistory> history{};
+    std::unique_ptr<WaterfallSpill> spill{};
+    size_t scrollback_lines{0};
+
+    Coord touch_start_y{0};
+    size_t touch_start_scrollback{0};
+    bool dragging{false};
+
     void clear();
+    void draw_line(const Coord y, const WaterfallHistory::Line& bins);
+    void draw_rows(WaterfallRowFIFO& rows);
+    void draw_history_line(const Coord k);
+    void open_history();
+    void close_history();
+    size_t history_lines() const;
+    bool history_line(const size_t age, WaterfallHistory::Line& line);
 };
 
 class WaterfallView : public View {
@@ -141,12 +180,19 @@ class WaterfallView : public View {
     void on_show() override;
     void on_hide() override;
 
+    /* The FIFOs handed over by the baseband die with it: stop() before
+     * changing the image under a shown view, and start() after. */
     void start();
     void stop();
 
     void set_parent_rect(const Rect new_parent_rect) override;
     void show_audio_spectrum_view(const bool show);
 
+    /* See WaterfallWidget::set_history(). */
+    void set_history(const bool enabled) {
+        waterfall_widget.set_history(enabled);
+    }
+
    private:
     void update_widgets_rect();
 
@@ -159,6 +205,8 @@ class WaterfallView : public View {
     bool running_{false};
 
     ChannelSpectrumFIFO* channel_fifo{nullptr};
+    WaterfallRowFIFO* rows_fifo{nullptr};
+    uint32_t rows_tag{0};
     AudioSpectrum* audio_spectrum_data{nullptr};
     bool audio_spectrum_update{false};
 
@@ -175,6 +223,15 @@ class WaterfallView : public View {
             const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
             this->channel_fifo = message.fifo;
         }};
+    MessageHandlerRegistration message_handler_waterfall_rows_config{
+        Message::ID::WaterfallRowsConfig,
+        [this](const Message* const p) {
+            // A late answer from before the last start() points at a ring
+            // already freed, maybe along with the image that sent it.
+            const auto message = *reinterpret_cast<const WaterfallRowsConfigMessage*>(p);
+            if (this->running_ && message.tag == this->rows_tag)
+                this->rows_fifo = message.fifo;
+        }};
     MessageHandlerRegistration message_handler_audio_spectrum{
         Message::ID::AudioSpectrum,
         [this](const Message* const p) {
@@ -191,6 +248,9 @@ class WaterfallView : public View {
                     this->on_channel_spectrum(channel_spectrum);
                 }
             }
+            if (this->rows_fifo) {
+                this->waterfall_widget.on_rows(*rows_fifo);
+            }
             if (this->audio_spectrum_update) {
                 this->audio_spectrum_update = false;
                 this->on_audio_spectrum();
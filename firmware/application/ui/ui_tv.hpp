@@ -77,14 +77,17 @@ class TVView : public Widget {
     void on_hide() override;
 
     void paint(Painter& painter) override;
-    void on_channel_spectrum(const ChannelSpectrum& spectrum);
-    void on_adjust_xcorr(uint8_t xcorr);
-    // ui::Color video_buffer[13312];
-    uint8_t video_buffer_int[13312 + 128]{0};  // 128 is for the over length caused by x_correction
-    uint32_t count = 0;
-    uint8_t x_correction = 0;
+    /* Draws the lines synced by the baseband at their rows until the
+     * ring is empty or the time budget is spent. */
+    void on_lines(TvLineFIFO& lines);
 
    private:
+    static constexpr size_t max_line_batch = 1 << TvLinesConfigMessage::fifo_k;
+    static constexpr uint32_t lines_budget_us = 8000;
+
+    /* Draws one batch, a run of consecutive rows through one LCD window. */
+    void draw_lines(TvLineFIFO& lines);
+
     void clear();
 };
 
@@ -107,12 +110,6 @@ class TVWidget : public View {
     void show_audio_spectrum_view(const bool show);
 
     void paint(Painter& painter) override;
-    NumberField field_xcorr{
-        {0 * 8, 0 * 16},
-        5,
-        {0, 128},
-        1,
-        ' '};
 
    private:
     void update_widgets_rect();
@@ -123,22 +120,28 @@ class TVWidget : public View {
 
     TVView tv_view{};
 
-    ChannelSpectrumFIFO* channel_fifo{nullptr};
+    TvLineFIFO* line_fifo{nullptr};
     AudioSpectrum* audio_spectrum_data{nullptr};
     bool audio_spectrum_update{false};
 
     std::unique_ptr<TimeScopeView> audio_spectrum_view{};
 
-    int sampling_rate{0};
     int32_t cursor_position{0};
     ui::Rect tv_normal_rect{};
     ui::Rect tv_reduced_rect{};
 
-    MessageHandlerRegistration message_handler_channel_spectrum_config{
-        Message::ID::ChannelSpectrumConfig,
+    MessageHandlerRegistration message_handler_tv_lines_config{
+        Message::ID::TvLinesConfig,
         [this](const Message* const p) {
-            const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
-            this->channel_fifo = message.fifo;
+            const auto message = *reinterpret_cast<const TvLinesConfigMessage*>(p);
+            this->line_fifo = message.fifo;
+        }};
+    MessageHandlerRegistration message_handler_tv_lines_ready{
+        Message::ID::TvLinesReady,
+        [this](const Message* const) {
+            if (this->line_fifo) {
+                this->tv_view.on_lines(*line_fifo);
+            }
         }};
     MessageHandlerRegistration message_handler_audio_spectrum{
         Message::ID::AudioSpectrum,
@@ -150,11 +153,8 @@ class TVWidget : public View {
     MessageHandlerRegistration message_handler_frame_sync{
         Message::ID::DisplayFrameSync,
         [this](const Message* const) {
-            if (this->channel_fifo) {
-                ChannelSpectrum channel_spectrum;
-                while (channel_fifo->out(channel_spectrum)) {
-                    this->on_channel_spectrum(channel_spectrum);
-                }
+            if (this->line_fifo) {
+                this->tv_view.on_lines(*line_fifo);
             }
             if (this->audio_spectrum_update) {
                 this->audio_spectrum_update = false;
@@ -162,7 +162,6 @@ class TVWidget : public View {
             }
         }};
 
-    void on_channel_spectrum(const ChannelSpectrum& spectrum);
     void on_audio_spectrum();
 };
 
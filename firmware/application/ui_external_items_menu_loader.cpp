@@ -9,8 +9,121 @@
 
 namespace ui {
 
+namespace {
+
+const std::filesystem::path catalog_file_name{u"catalog.bin"};
+
+bool read_app_header(const std::filesystem::path& file_path, external_app_kind kind, external_app_catalog_entry& entry) {
+    File app;
+
+    auto openError = app.open(file_path);
+    if (openError)
+        return false;
+
+    if (kind == external_app_kind::Application) {
+        application_information_t application_information = {};
+
+        auto readResult = app.read(&application_information, sizeof(application_information_t));
+        if (!readResult)
+            return false;
+
+        entry.header_version = application_information.header_version;
+        entry.app_version = application_information.app_version;
+        entry.menu_location = application_information.menu_location;
+        entry.desired_menu_position = application_information.desired_menu_position;
+        entry.icon_color = application_information.icon_color;
+        memcpy(entry.app_name, application_information.app_name, sizeof(entry.app_name));
+        memcpy(entry.bitmap_data, application_information.bitmap_data, sizeof(entry.bitmap_data));
+    } else {
+        standalone_application_information_t application_information = {};
+
+        auto readResult = app.read(&application_information, sizeof(standalone_application_information_t));
+        if (!readResult)
+            return false;
+
+        entry.header_version = application_information.header_version;
+        entry.app_version = 0;
+        entry.menu_location = application_information.menu_location;
+        entry.desired_menu_position = -1;  // No desired position support for standalone apps yet
+        entry.icon_color = application_information.icon_color;
+        memcpy(entry.app_name, application_information.app_name, sizeof(entry.app_name));
+        memcpy(entry.bitmap_data, application_information.bitmap_data, sizeof(entry.bitmap_data));
+    }
+
+    return true;
+}
+
+// app_name isn't guaranteed to be terminated.
+std::string app_name(const external_app_catalog_entry& app) {
+    auto name = reinterpret_cast<const char*>(&app.app_name[0]);
+    return {name, strnlen(name, sizeof(app.app_name))};
+}
+
+std::string app_short_name(const std::filesystem::path& file_name) {
+    // Remove the ".ppma"/".ppmp" suffix
+    std::string appshortname = file_name.string();
+    if (appshortname.size() >= 5)
+        appshortname = appshortname.substr(0, appshortname.size() - 5);
+    return appshortname;
+}
+
+}  // namespace
+
 /* static */ std::vector<DynamicBitmap<16, 16>> ExternalItemsMenuLoader::bitmaps;
 
+/* static */ void ExternalItemsMenuLoader::for_each_external_app(ExternalAppCallback callback) {
+    const auto catalog_path = apps_dir / catalog_file_name;
+    ExternalAppCatalog catalog;
+
+    {
+        File catalog_file;
+        if (!catalog_file.open(catalog_path))
+            catalog.read(catalog_file);
+    }
+
+    // Files whose names don't fit in the catalog, or that don't fit in a
+    // full catalog, are read every time.
+    std::vector<std::pair<external_app_catalog_entry, std::filesystem::path>> uncached;
+
+    const auto scan = [&catalog, &uncached](external_app_kind kind, const std::filesystem::path& pattern) {
+        for (const auto& entry : std::filesystem::directory_iterator(apps_dir, pattern)) {
+            const auto file_name = entry.path();
+            const auto file_size = static_cast<uint32_t>(entry.size());
+
+            if (catalog.find(kind, file_name.native(), file_size, entry.fdate, entry.ftime))
+                continue;
+
+            external_app_catalog_entry app{};
+            app.kind = kind;
+            app.file_size = file_size;
+            app.file_date = entry.fdate;
+            app.file_time = entry.ftime;
+
+            if (!read_app_header(apps_dir / file_name, kind, app))
+                continue;
+
+            if (!app.set_file_name(file_name.native()) || !catalog.update(app))
+                uncached.push_back({app, file_name});
+        }
+    };
+
+    scan(external_app_kind::Application, u"*.ppma");
+    scan(external_app_kind::Standalone, u"*.ppmp");
+    catalog.prune();
+
+    if (catalog.changed()) {
+        File catalog_file;
+        if (!catalog_file.create(catalog_path))
+            catalog.write(catalog_file);
+    }
+
+    for (const auto& app : catalog.entries())
+        callback(app, app.path());
+
+    for (const auto& app : uncached)
+        callback(app.first, app.second);
+}
+
 // iterates over all possible ext apps-s, and if it is runnable on the current system, it'll call the callback, and pass minimal info. used to print to console, and for autostart setting's app list. where the minimal info is enough
 // please keep in sync with load_external_items
 /* static */ void ExternalItemsMenuLoader::load_all_external_items_callback(std::function<void(AppInfoConsole&)> callback, bool module_included) {
@@ -40,61 +153,22 @@ namespace ui {
     if (sd_card::status() != sd_card::Status::Mounted)
         return;
 
-    for (const auto& entry : std::filesystem::directory_iterator(apps_dir, u"*.ppma")) {
-        auto filePath = apps_dir / entry.path();
-        File app;
-
-        auto openError = app.open(filePath);
-        if (openError)
-            continue;
-
-        application_information_t application_information = {};
-
-        auto readResult = app.read(&application_information, sizeof(application_information_t));
-        if (!readResult)
-            continue;
-
-        if (application_information.header_version != CURRENT_HEADER_VERSION)
-            continue;
+    for_each_external_app([&callback](const external_app_catalog_entry& app, const std::filesystem::path& file_name) {
+        if (app.kind == external_app_kind::Application) {
+            if (app.header_version != CURRENT_HEADER_VERSION)
+                return;
 
-        bool versionMatches = VERSION_MD5 == application_information.app_version;
-
-        if (versionMatches) {
-            std::string appshortname = filePath.filename().string();
-            if (appshortname.size() >= 5 && appshortname.substr(appshortname.size() - 5) == ".ppma") {
-                // Remove the ".ppma" suffix
-                appshortname = appshortname.substr(0, appshortname.size() - 5);
-            }
-            AppInfoConsole appInfoConsole = {appshortname.c_str(), reinterpret_cast<char*>(&application_information.app_name[0]), application_information.menu_location};
-            callback(appInfoConsole);
+            if (VERSION_MD5 != app.app_version)
+                return;
+        } else if (app.header_version > CURRENT_STANDALONE_APPLICATION_API_VERSION) {
+            return;
         }
-    }
-
-    for (const auto& entry : std::filesystem::directory_iterator(apps_dir, u"*.ppmp")) {
-        auto filePath = apps_dir / entry.path();
-        File app;
-
-        auto openError = app.open(filePath);
-        if (openError)
-            continue;
-
-        standalone_application_information_t application_information = {};
 
-        auto readResult = app.read(&application_information, sizeof(standalone_application_information_t));
-        if (!readResult)
-            continue;
-
-        if (application_information.header_version > CURRENT_STANDALONE_APPLICATION_API_VERSION)
-            continue;
-
-        std::string appshortname = filePath.filename().string();
-        if (appshortname.size() >= 5 && appshortname.substr(appshortname.size() - 5) == ".ppmp") {
-            // Remove the ".ppmp" suffix
-            appshortname = appshortname.substr(0, appshortname.size() - 5);
-        }
-        AppInfoConsole appInfoConsole = {appshortname.c_str(), reinterpret_cast<char*>(&application_information.app_name[0]), application_information.menu_location};
+        std::string appshortname = app_short_name(file_name);
+        std::string appname = app_name(app);
+        AppInfoConsole appInfoConsole = {appshortname.c_str(), appname.c_str(), static_cast<app_location_t>(app.menu_location)};
         callback(appInfoConsole);
-    }
+    });
 }
 
 /* static */ std::vector<ExternalItemsMenuLoader::GridItemEx> ExternalItemsMenuLoader::load_external_items(app_location_t app_location, NavigationView& nav) {
@@ -160,99 +234,65 @@ namespace ui {
     if (sd_card::status() != sd_card::Status::Mounted)
         return external_apps;
 
-    for (const auto& entry : std::filesystem::directory_iterator(apps_dir, u"*.ppma")) {
-        auto filePath = apps_dir / entry.path();
-        File app;
+    for_each_external_app([&nav, &external_apps, app_location](const external_app_catalog_entry& app, const std::filesystem::path& file_name) {
+        if (app.menu_location != app_location)
+            return;
 
-        auto openError = app.open(filePath);
-        if (openError)
-            continue;
+        auto filePath = apps_dir / file_name;
 
-        application_information_t application_information = {};
-
-        auto readResult = app.read(&application_information, sizeof(application_information_t));
-        if (!readResult)
-            continue;
+        GridItemEx gridItem = {};
+        gridItem.text = app_name(app);
 
-        if (application_information.menu_location != app_location)
-            continue;
+        if (app.kind == external_app_kind::Application) {
+            if (app.header_version != CURRENT_HEADER_VERSION)
+                return;
 
-        if (application_information.header_version != CURRENT_HEADER_VERSION)
-            continue;
+            bool versionMatches = VERSION_MD5 == app.app_version;
 
-        bool versionMatches = VERSION_MD5 == application_information.app_version;
+            if (versionMatches) {
+                gridItem.color = Color((uint16_t)app.icon_color);
 
-        GridItemEx gridItem = {};
-        gridItem.text = reinterpret_cast<char*>(&application_information.app_name[0]);
+                auto dyn_bmp = DynamicBitmap<16, 16>{app.bitmap_data};
+                gridItem.bitmap = dyn_bmp.bitmap();
+                bitmaps.push_back(std::move(dyn_bmp));
 
-        if (versionMatches) {
-            gridItem.color = Color((uint16_t)application_information.icon_color);
+                gridItem.on_select = [&nav, filePath]() {
+                    if (!run_external_app(nav, filePath)) {
+                        nav.display_modal("Error", "The .ppma file in your " + apps_dir.string() + "\nfolder can't be read. Please\nupdate your SD Card content.");
+                    }
+                };
+            } else {
+                gridItem.color = Theme::getInstance()->fg_light->foreground;
 
-            auto dyn_bmp = DynamicBitmap<16, 16>{application_information.bitmap_data};
-            gridItem.bitmap = dyn_bmp.bitmap();
-            bitmaps.push_back(std::move(dyn_bmp));
+                gridItem.bitmap = &bitmap_sd_card_error;
 
-            gridItem.on_select = [&nav, app_location, filePath]() {
-                if (!run_external_app(nav, filePath)) {
-                    nav.display_modal("Error", "The .ppma file in your " + apps_dir.string() + "\nfolder can't be read. Please\nupdate your SD Card content.");
-                }
-            };
+                gridItem.on_select = [&nav]() {
+                    nav.display_modal("Error", "The .ppma file in your " + apps_dir.string() + "\nfolder is outdated. Please\nupdate your SD Card content.");
+                };
+            }
 
-            gridItem.desired_position = application_information.desired_menu_position;
+            gridItem.desired_position = app.desired_menu_position;
         } else {
-            gridItem.color = Theme::getInstance()->fg_light->foreground;
+            if (app.header_version > CURRENT_STANDALONE_APPLICATION_API_VERSION)
+                return;
 
-            gridItem.bitmap = &bitmap_sd_card_error;
+            gridItem.color = Color((uint16_t)app.icon_color);
 
-            gridItem.on_select = [&nav]() {
-                nav.display_modal("Error", "The .ppma file in your " + apps_dir.string() + "\nfolder is outdated. Please\nupdate your SD Card content.");
+            auto dyn_bmp = DynamicBitmap<16, 16>{app.bitmap_data};
+            gridItem.bitmap = dyn_bmp.bitmap();
+            bitmaps.push_back(std::move(dyn_bmp));
+
+            gridItem.on_select = [&nav, filePath]() {
+                if (!run_standalone_app(nav, filePath)) {
+                    nav.display_modal("Error", "The .ppmp file in your " + apps_dir.string() + "\nfolder can't be read. Please\nupdate your SD Card content.");
+                }
             };
 
-            gridItem.desired_position = application_information.desired_menu_position;
+            gridItem.desired_position = app.desired_menu_position;
         }
 
         external_apps.push_back(gridItem);
-    }
-
-    for (const auto& entry : std::filesystem::directory_iterator(apps_dir, u"*.ppmp")) {
-        auto filePath = apps_dir / entry.path();
-        File app;
-
-        auto openError = app.open(filePath);
-        if (openError)
-            continue;
-
-        standalone_application_information_t application_information = {};
-
-        auto readResult = app.read(&application_information, sizeof(standalone_application_information_t));
-        if (!readResult)
-            continue;
-
-        if (application_information.menu_location != app_location)
-            continue;
-
-        if (application_information.header_version > CURRENT_STANDALONE_APPLICATION_API_VERSION)
-            continue;
-
-        GridItemEx gridItem = {};
-        gridItem.text = reinterpret_cast<char*>(&application_information.app_name[0]);
-
-        gridItem.color = Color((uint16_t)application_information.icon_color);
-
-        auto dyn_bmp = DynamicBitmap<16, 16>{application_information.bitmap_data};
-        gridItem.bitmap = dyn_bmp.bitmap();
-        bitmaps.push_back(std::move(dyn_bmp));
-
-        gridItem.on_select = [&nav, app_location, filePath]() {
-            if (!run_standalone_app(nav, filePath)) {
-                nav.display_modal("Error", "The .ppmp file in your " + apps_dir.string() + "\nfolder can't be read. Please\nupdate your SD Card content.");
-            }
-        };
-
-        gridItem.desired_position = -1;  // No desired position support for standalone apps yet
-
-        external_apps.push_back(gridItem);
-    }
+    });
 
     return external_apps;
 }
@@ -27,6 +27,7 @@
 #include "ui_navigation.hpp"
 #include "external_app.hpp"
 #include "standalone_app.hpp"
+#include "external_app_catalog.hpp"
 
 #include "file.hpp"
 
@@ -67,6 +68,13 @@ class ExternalItemsMenuLoader {
     static void load_all_external_items_callback(std::function<void(AppInfoConsole&)> callback, bool module_included = false);
 
    private:
+    using ExternalAppCallback = std::function<void(const external_app_catalog_entry&, const std::filesystem::path&)>;
+
+    /* Calls the callback for every .ppma and .ppmp file in apps_dir, with
+     * its header fields and file name. Headers come from the app catalog;
+     * only new or changed app files are opened. */
+    static void for_each_external_app(ExternalAppCallback callback);
+
     static std::vector<DynamicBitmap<16, 16>> bitmaps;
 };
 
@@ -453,6 +453,7 @@ void SystemStatusView::set_title(const std::string new_value) {
 
 void SystemStatusView::on_converter() {
     pmem::set_config_converter(!pmem::config_converter());
+    radio::update_frequency_correction();
 
     // Poke to update tuning
     // NOTE: Code assumes here that a TX app isn't active, since RX & TX have diff tuning offsets
@@ -36,6 +36,10 @@
 #include "crc.hpp"
 #include "hackrf_cpld_data.hpp"
 #include "performance_counter.hpp"
+#include "startup_trace.hpp"
+#include "dispatch_stats.hpp"
+#include "log_file.hpp"
+#include "core_timer.hpp"
 
 #include "usb_serial_device_to_host.h"
 #include "i2c_device_to_host.h"
@@ -1188,6 +1192,135 @@ static void cmd_sysinfo(BaseSequentialStream* chp, int argc, char* argv[]) {
     return;
 }
 
+static std::string dispatch_histogram_line(const std::string& name, const dispatch_stats::Histogram& histogram) {
+    std::string line = name + ":";
+    for (size_t n = 0; n < dispatch_stats::bucket_count; n++)
+        line += " " + to_string_dec_uint(histogram.count(n));
+    return line + ", worst " + to_string_dec_uint(histogram.worst_us()) + " us\r\n";
+}
+
+static void cmd_dispatchstats(BaseSequentialStream* chp, int argc, char* argv[]) {
+    const char* usage =
+        "usage: dispatchstats [reset|budget on|budget off]\r\n"
+        "buckets: <32us <128us <512us <2ms <8ms <32ms <128ms >=128ms\r\n";
+
+    if (argc == 1 && strcmp(argv[0], "reset") == 0) {
+        dispatch_stats::reset();
+        chprintf(chp, "ok\r\n");
+        return;
+    }
+    if (argc == 2 && strcmp(argv[0], "budget") == 0 &&
+        (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0)) {
+        dispatch_stats::set_budgeted(strcmp(argv[1], "on") == 0);
+        chprintf(chp, "ok\r\n");
+        return;
+    }
+    if (argc > 0) {
+        chprintf(chp, usage);
+        return;
+    }
+
+    std::string info =
+        "budgeted: " + std::string(dispatch_stats::budgeted() ? "on" : "off") + "\r\n" +
+        "deferrals: " + to_string_dec_uint(dispatch_stats::deferrals()) + "\r\n";
+    fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)info.c_str(), info.length());
+
+    for (size_t n = 0; n < dispatch_stats::source_count; n++) {
+        const auto source = static_cast<dispatch_stats::Source>(n);
+        info = dispatch_histogram_line(dispatch_stats::source_name(source), dispatch_stats::source(source));
+        fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)info.c_str(), info.length());
+    }
+
+    // Message handlers, by Message::ID; only those that ran
+    for (size_t id = 0; id < dispatch_stats::message_count(); id++) {
+        const auto& histogram = dispatch_stats::message(id);
+        if (histogram.total() == 0)
+            continue;
+        info = dispatch_histogram_line("msg " + to_string_dec_uint(id), histogram);
+        fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)info.c_str(), info.length());
+    }
+}
+
+// Rewrites the top rows of the screen with their own contents, each row as one
+// draw_pixels burst through the old one pixel per pass write loop and through the
+// unrolled one, and reports pixels/sec for both.
+static void cmd_lcdbench(BaseSequentialStream* chp, int argc, char* argv[]) {
+    const char* usage = "usage: lcdbench [rows]\r\n";
+    int rows = 16;
+    if (argc > 1) {
+        chprintf(chp, usage);
+        return;
+    }
+    if (argc == 1)
+        rows = std::clamp(atoi(argv[0]), 1, (int)ui::screen_height);
+
+    auto evtd = getEventDispatcherInstance();
+    evtd->enter_shell_working_mode();
+
+    std::vector<ui::ColorRGB888> rgb(ui::screen_width);
+    std::vector<ui::Color> row(ui::screen_width);
+    uint32_t ticks[2]{0, 0};
+
+    for (int y = 0; y < rows; y++) {
+        const ui::Rect r{0, y, ui::screen_width, 1};
+        portapack::display.read_pixels(r, rgb);
+        for (int x = 0; x < ui::screen_width; x++)
+            row[x] = ui::Color(rgb[x].r, rgb[x].g, rgb[x].b);
+
+        uint32_t start = core_timer::now();
+        portapack::display.draw_pixels_reference(r, row.data(), row.size());
+        ticks[0] += core_timer::now() - start;
+
+        start = core_timer::now();
+        portapack::display.draw_pixels(r, row);
+        ticks[1] += core_timer::now() - start;
+    }
+
+    evtd->exit_shell_working_mode();
+
+    const uint64_t pixels = (uint64_t)rows * ui::screen_width;
+    const char* names[2]{"per pixel loop", "unrolled loop"};
+    for (size_t path = 0; path < 2; path++) {
+        const uint32_t us = std::max<uint32_t>(ticks[path] / core_timer::counts_per_us, 1);
+        chprintf(chp, "%s: %d px in %d us, %d px/s\r\n", names[path], (int)pixels, (int)us, (int)(pixels * 1000000 / us));
+    }
+}
+
+static void cmd_logstats(BaseSequentialStream* chp, int argc, char* argv[]) {
+    const char* usage = "usage: logstats\r\n";
+    (void)argv;
+    if (argc > 0) {
+        chprintf(chp, usage);
+        return;
+    }
+    chprintf(chp, "dropped lines: %d\r\n", (int)LogWriter::dropped_lines());
+}
+
+static void cmd_startuptrace(BaseSequentialStream* chp, int argc, char* argv[]) {
+    const char* usage = "usage: startuptrace\r\n";
+    (void)argv;
+    if (argc > 0) {
+        chprintf(chp, usage);
+        return;
+    }
+    const auto& trace = startup_trace::last();
+    const auto& tag = trace.tag();
+    std::string info =
+        "image: " + std::string(tag.data(), tag.size()) + "\r\n" +
+        "switches: " + to_string_dec_uint(trace.switches()) + "\r\n" +
+        "stage: last us, worst us\r\n";
+
+    for (size_t n = 0; n < startup_trace::stage_count; n++) {
+        const auto stage = static_cast<startup_trace::Stage>(n);
+        info += std::string(startup_trace::stage_name(stage)) + ": ";
+        info += trace.reached(stage) ? to_string_dec_uint(trace.elapsed(stage) / core_timer::counts_per_us) : "-";
+        info += ", " + to_string_dec_uint(trace.worst(stage) / core_timer::counts_per_us) + "\r\n";
+    }
+
+    fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)info.c_str(), info.length());
+    return;
+}
+
 static void cmd_radioinfo(BaseSequentialStream* chp, int argc, char* argv[]) {
     const char* usage = "usage: radioinfo\r\n";
     (void)argv;
@@ -1411,6 +1544,10 @@ static const ShellCommand commands[] = {
     {"gotenv", cmd_gotenv},
     {"gotlight", cmd_gotlight},
     {"sysinfo", cmd_sysinfo},
+    {"startuptrace", cmd_startuptrace},
+    {"lcdbench", cmd_lcdbench},
+    {"dispatchstats", cmd_dispatchstats},
+    {"logstats", cmd_logstats},
     {"radioinfo", cmd_radioinfo},
     {"pmemreset", cmd_pmemreset},
     {"settingsreset", cmd_settingsreset},
@@ -25,8 +25,9 @@
 #include "chprintf.h"
 #include "string_format.hpp"
 #include <cstring>
+#include <memory>
 
-#include "crc.hpp"
+#include "crc_engine.hpp"
 
 static File* shell_file = nullptr;
 
@@ -254,15 +255,16 @@ void cmd_sd_read(BaseSequentialStream* chp, int argc, char* argv[]) {
     int size = (int)strtol(argv[0], NULL, 10);
 
     uint8_t buffer[62];
+    FixedString<sizeof(buffer) * 2 + 2> line;
 
     do {
         File::Size bytes_to_read = size > 62 ? 62 : size;
         auto bytes_read = shell_file->read(buffer, bytes_to_read);
         if (report_on_error(chp, bytes_read)) return;
 
-        std::string res = to_string_hex_array(buffer, bytes_read.value());
-        res += "\r\n";
-        fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)res.c_str(), res.size());
+        line.clear();
+        line.append_hex_array(buffer, bytes_read.value()).append("\r\n");
+        fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)line.c_str(), line.size());
         if (bytes_to_read != bytes_read.value())
             return;
 
@@ -381,26 +383,26 @@ void cmd_sd_crc32(BaseSequentialStream* chp, int argc, char* argv[]) {
     }
 
     auto path = path_from_string8(argv[0]);
-    File* crc_file = new File();
+    auto crc_file = std::make_unique<File>();
     auto error = crc_file->open(path, true, false);
     if (report_on_error(chp, error)) return;
 
-    uint8_t buffer[64];
-    CRC<32> crc{0x04c11db7, 0xffffffff, 0xffffffff};
+    // Whole sectors per read; the CRC engine keeps up with the SD card.
+    constexpr size_t buffer_size = 512;
+    auto buffer = std::make_unique<uint8_t[]>(buffer_size);
+    CRCEngine<32> crc{0x04c11db7, 0xffffffff, 0xffffffff};
 
     while (true) {
-        auto bytes_read = crc_file->read(buffer, 64);
+        auto bytes_read = crc_file->read(buffer.get(), buffer_size);
         if (report_on_error(chp, bytes_read)) return;
 
         if (bytes_read.value() > 0) {
-            crc.process_bytes((void*)buffer, bytes_read.value());
+            crc.process_bytes(buffer.get(), bytes_read.value());
         }
 
-        if (64 != bytes_read.value()) {
+        if (buffer_size != bytes_read.value()) {
             chprintf(chp, "CRC32: 0x%08X\r\n", crc.checksum());
             return;
         }
     }
-
-    delete crc_file;
 }
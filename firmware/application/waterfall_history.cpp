@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "waterfall_history.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+WaterfallHistory::WaterfallHistory(const size_t capacity)
+    : buffer_(std::min<size_t>(std::max(capacity, max_packed_size), UINT16_MAX)),
+      records_(buffer_.size() / bytes_per_record) {
+}
+
+void WaterfallHistory::push(const Line& line) {
+    Line quantised;
+    for (size_t i = 0; i < line_width; i++)
+        quantised[i] = line[i] & quantise_mask;
+
+    std::array<uint8_t, max_packed_size> packed;
+    const size_t length = pack(quantised.data(), line_width, packed.data());
+
+    // Records never wrap; start over at the beginning if there's no room at the end.
+    const bool wrap = head_ + length > buffer_.size();
+    const size_t offset = wrap ? 0 : head_;
+
+    // Live records run from the oldest up to head_ (circularly), so anything
+    // in the way of the new one is the oldest line(s). On a wrap, lines left
+    // past head_ are given up along with the tail of the buffer.
+    while (count_ > 0) {
+        const auto& oldest = record(0);
+        const bool overlaps = (oldest.offset < offset + length) && (offset < oldest.offset + oldest.length);
+        const bool in_tail = wrap && oldest.offset >= head_;
+        if (!overlaps && !in_tail && count_ < records_.size())
+            break;
+        evict_oldest();
+    }
+
+    std::memcpy(&buffer_[offset], packed.data(), length);
+    records_[(first_ + count_) % records_.size()] = {static_cast<uint16_t>(offset), static_cast<uint16_t>(length)};
+    count_++;
+    head_ = offset + length;
+}
+
+void WaterfallHistory::clear() {
+    first_ = 0;
+    count_ = 0;
+    head_ = 0;
+}
+
+bool WaterfallHistory::get(const size_t age, Line& line) const {
+    if (age >= count_)
+        return false;
+
+    const auto& r = record(count_ - 1 - age);
+    return unpack(&buffer_[r.offset], r.length, line.data(), line_width);
+}
+
+void WaterfallHistory::evict_oldest() {
+    if (on_evict) {
+        Line line;
+        if (get(count_ - 1, line))
+            on_evict(line);
+    }
+    first_ = (first_ + 1) % records_.size();
+    count_--;
+}
+
+/* Header byte h < 128: h + 1 literal bytes follow.
+ * Header byte h >= 128: the next byte repeats h - 125 (3..130) times. */
+size_t WaterfallHistory::pack(const uint8_t* in, const size_t n, uint8_t* out) {
+    size_t i = 0;
+    size_t o = 0;
+
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && in[i + run] == in[i] && run < 130)
+            run++;
+
+        if (run >= 3) {
+            out[o++] = run + 125;
+            out[o++] = in[i];
+            i += run;
+            continue;
+        }
+
+        // Literals, up to the start of the next run of three.
+        const size_t start = i;
+        while (i < n && i - start < 128) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2])
+                break;
+            i++;
+        }
+        out[o++] = i - start - 1;
+        std::memcpy(&out[o], &in[start], i - start);
+        o += i - start;
+    }
+    return o;
+}
+
+bool WaterfallHistory::unpack(const uint8_t* in, const size_t in_size, uint8_t* out, const size_t n) {
+    size_t i = 0;
+    size_t o = 0;
+
+    while (i < in_size) {
+        const uint8_t h = in[i++];
+        if (h < 128) {
+            const size_t count = h + 1;
+            if (i + count > in_size || o + count > n)
+                return false;
+            std::memcpy(&out[o], &in[i], count);
+            i += count;
+            o += count;
+        } else {
+            const size_t count = h - 125;
+            if (i >= in_size || o + count > n)
+                return false;
+            std::memset(&out[o], in[i++], count);
+            o += count;
+        }
+    }
+    return o == n;
+}
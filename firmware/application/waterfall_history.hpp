@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __WATERFALL_HISTORY_H__
+#define __WATERFALL_HISTORY_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* In-RAM ring of recent waterfall lines. Lines are quantised and RLE packed
+ * (PackBits style) into a fixed size byte buffer; when it fills up the oldest
+ * lines are evicted, and handed to on_evict so they can be spilled to SD. */
+class WaterfallHistory {
+   public:
+    static constexpr size_t line_width = 240;
+    using Line = std::array<uint8_t, line_width>;
+
+    /* Bin bits kept; dropping the low bits gives longer runs. */
+    static constexpr uint8_t quantise_mask = 0xfc;
+
+    /* Worst case packed size of a line. */
+    static constexpr size_t max_packed_size = line_width + (line_width + 127) / 128;
+
+    std::function<void(const Line& line)> on_evict{};
+
+    explicit WaterfallHistory(const size_t capacity);
+
+    void push(const Line& line);
+    void clear();
+
+    /* Lines currently held; age 0 is the newest. */
+    size_t size() const {
+        return count_;
+    }
+
+    bool get(const size_t age, Line& line) const;
+
+    static size_t pack(const uint8_t* in, const size_t n, uint8_t* out);
+    static bool unpack(const uint8_t* in, const size_t in_size, uint8_t* out, const size_t n);
+
+   private:
+    struct Record {
+        uint16_t offset;
+        uint16_t length;
+    };
+
+    /* Enough records for a buffer of lines that pack down to 32 bytes;
+     * flatter lines than that are evicted by count instead of by size. */
+    static constexpr size_t bytes_per_record = 32;
+
+    std::vector<uint8_t> buffer_;
+    std::vector<Record> records_;
+    size_t first_{0};
+    size_t count_{0};
+    size_t head_{0};
+
+    const Record& record(const size_t n) const {
+        return records_[(first_ + n) % records_.size()];
+    }
+
+    void evict_oldest();
+};
+
+#endif /*__WATERFALL_HISTORY_H__*/
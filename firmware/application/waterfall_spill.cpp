@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "waterfall_spill.hpp"
+
+#include <cstring>
+
+WaterfallSpill::WaterfallSpill() {
+    chMtxInit(&mutex_);
+}
+
+WaterfallSpill::~WaterfallSpill() {
+    close();
+}
+
+bool WaterfallSpill::open(const std::filesystem::path& filename) {
+    close();
+
+    ensure_directory(filename.parent_path());
+    if (file_.open(filename, false, true))
+        return false;
+
+    restart();
+    failed_ = false;
+    // Below the UI, and enough stack for FATFS.
+    thread_ = chThdCreateFromHeap(NULL, 1024, NORMALPRIO - 10, WaterfallSpill::static_fn, this);
+    if (!thread_) {
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+void WaterfallSpill::close() {
+    if (thread_) {
+        chThdTerminate(thread_);
+        chEvtSignal(thread_, EVENT_MASK(0));
+        chThdWait(thread_);
+        thread_ = nullptr;
+    }
+    file_.close();
+    restart();
+}
+
+bool WaterfallSpill::push(const Line& line) {
+    if (!thread_ || failed_) {
+        count_ = 0;
+        return false;
+    }
+
+    auto& batch = batches_[filling_];
+    batch.lines[batch.count++] = line;
+    count_++;
+
+    if (batch.count < batch_lines)
+        return true;
+
+    // Start the file over rather than let it grow without bound, and drop
+    // what's spilled if the writer is still busy with the previous batch.
+    if (!hand_off() || count_ >= max_lines) {
+        restart();
+        return false;
+    }
+    return true;
+}
+
+bool WaterfallSpill::get(const size_t index, Line& line) {
+    if (index >= count_)
+        return false;
+
+    // Lines still in RAM: the batch being filled, then the one handed to the
+    // thread. The latter may be left over from before a restart, so it only
+    // counts for lines older than the one being filled.
+    const auto& filling = batches_[filling_];
+    const auto& handed = batches_[filling_ ^ 1];
+    if (filling.holds(index)) {
+        line = filling.lines[index - filling.first];
+        return true;
+    }
+    if (index < filling.first && handed.holds(index)) {
+        line = handed.lines[index - handed.first];
+        return true;
+    }
+
+    // Anything else was written out, a whole batch at a time.
+    if (!cache_.holds(index)) {
+        const auto first = index - (index % batch_lines);
+        chMtxLock(&mutex_);
+        const bool ok = file_.seek(first * sizeof(Line)).is_ok() &&
+                        file_.read(cache_.lines.data(), sizeof(cache_.lines)).is_ok();
+        chMtxUnlock();
+        if (!ok)
+            return false;
+        cache_.first = first;
+        cache_.count = batch_lines;
+    }
+    line = cache_.lines[index - cache_.first];
+    return true;
+}
+
+void WaterfallSpill::restart() {
+    count_ = 0;
+    batches_[filling_].first = 0;
+    batches_[filling_].count = 0;
+    cache_.count = 0;
+}
+
+/* Never waits on the SD card: fails if the thread is still writing. */
+bool WaterfallSpill::hand_off() {
+    if (!chMtxTryLock(&mutex_))
+        return false;
+
+    const bool busy = pending_;
+    if (!busy) {
+        writing_ = filling_;
+        pending_ = true;
+        filling_ ^= 1;
+        batches_[filling_].first = count_;
+        batches_[filling_].count = 0;
+    }
+    chMtxUnlock();
+
+    if (busy)
+        return false;
+    chEvtSignal(thread_, EVENT_MASK(0));
+    return true;
+}
+
+void WaterfallSpill::write_pending() {
+    chMtxLock(&mutex_);
+    if (pending_) {
+        const auto& batch = batches_[writing_];
+        if (file_.seek(batch.first * sizeof(Line)).is_error() ||
+            file_.write(batch.lines.data(), batch.count * sizeof(Line)).is_error())
+            failed_ = true;
+        pending_ = false;
+    }
+    chMtxUnlock();
+}
+
+msg_t WaterfallSpill::static_fn(void* arg) {
+    auto spill = static_cast<WaterfallSpill*>(arg);
+    while (!chThdShouldTerminate()) {
+        chEvtWaitAny(EVENT_MASK(0));
+        spill->write_pending();
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __WATERFALL_SPILL_H__
+#define __WATERFALL_SPILL_H__
+
+#include "ch.h"
+
+#include "file.hpp"
+#include "waterfall_history.hpp"
+
+#include <array>
+#include <cstddef>
+
+/* Holds the lines evicted from a WaterfallHistory in a file of raw lines, so
+ * they can be read back at random. Lines are collected in batches that a
+ * thread of its own writes out, keeping the SD card off the UI thread.
+ *
+ * The file is overwritten in place from the start each time it is opened and
+ * restarts after max_lines; lines past size() are left over from earlier. */
+class WaterfallSpill {
+   public:
+    using Line = WaterfallHistory::Line;
+
+    static constexpr size_t batch_lines = 4;
+    static constexpr size_t max_lines = 8192;
+
+    WaterfallSpill();
+    ~WaterfallSpill();
+
+    WaterfallSpill(const WaterfallSpill&) = delete;
+    WaterfallSpill& operator=(const WaterfallSpill&) = delete;
+
+    bool open(const std::filesystem::path& filename);
+    void close();
+
+    /* Returns false if the spilled lines had to be given up to keep the
+     * history contiguous (writer behind, file restarted or write error). */
+    bool push(const Line& line);
+
+    /* Lines held; index 0 is the oldest. */
+    size_t size() const {
+        return count_;
+    }
+
+    bool get(const size_t index, Line& line);
+
+   private:
+    struct Batch {
+        size_t first;
+        size_t count;
+        std::array<Line, batch_lines> lines;
+
+        bool holds(const size_t index) const {
+            return (index >= first) && (index < first + count);
+        }
+    };
+
+    File file_{};
+    Thread* thread_{nullptr};
+    Mutex mutex_{};
+
+    std::array<Batch, 2> batches_{};
+    size_t filling_{0};
+    size_t count_{0};
+
+    /* Under mutex_: the batch handed to the thread, until it is written. */
+    size_t writing_{0};
+    bool pending_{false};
+    bool failed_{false};
+
+    /* Last batch sized block read back from the file. */
+    Batch cache_{};
+
+    void restart();
+    bool hand_off();
+    void write_pending();
+
+    static msg_t static_fn(void* arg);
+};
+
+#endif /*__WATERFALL_SPILL_H__*/
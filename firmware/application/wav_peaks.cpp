@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "wav_peaks.hpp"
+
+namespace wav_peaks {
+
+static File::Offset level_offset(const FileHeader& header, const size_t level) {
+    File::Offset offset = sizeof(FileHeader);
+    for (size_t l = 0; l < level; l++)
+        offset += header.counts[l] * sizeof(Peak);
+    return offset;
+}
+
+std::filesystem::path sidecar_path(const std::filesystem::path& wav_path) {
+    auto path = wav_path;
+    path.replace_extension(u".PPK");
+    return path;
+}
+
+/* PeakWriter ************************************************************/
+
+Optional<File::Error> PeakWriter::create(const std::filesystem::path& wav_path) {
+    open_ = false;
+    const auto error = file_.open(sidecar_path(wav_path), false, true);
+    if (error.is_valid())
+        return error;
+
+    // The magic is only written by finish(), so an unfinished file is ignored.
+    const FileHeader header{};
+    file_.truncate();
+    const auto result = file_.write(&header, sizeof(header));
+    if (result.is_error())
+        return result.error();
+
+    open_ = true;
+    failed_ = false;
+    sample_count_ = 0;
+    level0_count_ = 0;
+    pending_count_ = 0;
+    return {};
+}
+
+void PeakWriter::add(const int16_t* samples, const size_t count) {
+    for (size_t i = 0; i < count; i++)
+        add_sample(samples[i]);
+}
+
+void PeakWriter::add(const uint8_t* samples, const size_t count) {
+    for (size_t i = 0; i < count; i++)
+        add_sample((samples[i] - 0x80) * 256);
+}
+
+void PeakWriter::add_sample(const int16_t sample) {
+    Peak peak;
+    sample_count_++;
+    if (level0_.add(sample, peak))
+        emit(peak);
+}
+
+void PeakWriter::emit(const Peak& peak) {
+    pending_[pending_count_++] = peak;
+    level0_count_++;
+    if (pending_count_ == pending_.size())
+        flush_pending();
+}
+
+void PeakWriter::flush_pending() {
+    if (open_ && !failed_ && pending_count_ > 0)
+        failed_ = file_.write(pending_.data(), pending_count_ * sizeof(Peak)).is_error();
+    pending_count_ = 0;
+}
+
+/* Builds level 1 from level 0, reading it back in chunks and appending the
+ * result after it. */
+void PeakWriter::write_level1(FileHeader& header) {
+    constexpr uint32_t ratio = level_block(1) / level_block(0);
+    BlockAccumulator level1{ratio};
+    std::array<Peak, 64> chunk;
+    Peak peak;
+
+    auto append = [this, &header]() {
+        if (failed_ || pending_count_ == 0)
+            return;
+        failed_ = file_.seek(level_offset(header, 1) + header.counts[1] * sizeof(Peak)).is_error() ||
+                  file_.write(pending_.data(), pending_count_ * sizeof(Peak)).is_error();
+        header.counts[1] += pending_count_;
+        pending_count_ = 0;
+    };
+
+    for (uint32_t i = 0; i < header.counts[0] && !failed_; i += chunk.size()) {
+        const auto n = std::min<uint32_t>(chunk.size(), header.counts[0] - i);
+        if (file_.seek(level_offset(header, 0) + i * sizeof(Peak)).is_error() ||
+            file_.read(chunk.data(), n * sizeof(Peak)).is_error()) {
+            failed_ = true;
+            return;
+        }
+        for (uint32_t k = 0; k < n; k++) {
+            if (level1.add(chunk[k], peak)) {
+                pending_[pending_count_++] = peak;
+                if (pending_count_ == pending_.size())
+                    append();
+            }
+        }
+    }
+    if (level1.flush(peak))
+        pending_[pending_count_++] = peak;
+    append();
+}
+
+Optional<File::Error> PeakWriter::finish() {
+    if (!open_)
+        return {};
+
+    Peak peak;
+    if (level0_.flush(peak))
+        emit(peak);
+    flush_pending();
+
+    FileHeader header{file_magic, sample_count_, {level0_count_, 0}};
+    write_level1(header);
+
+    if (!failed_)
+        failed_ = file_.seek(0).is_error() || file_.write(&header, sizeof(header)).is_error();
+
+    open_ = false;
+    file_.close();
+    if (failed_)
+        return File::Error{FR_DISK_ERR};
+    return {};
+}
+
+/* PeakReader ************************************************************/
+
+bool PeakReader::open(const std::filesystem::path& wav_path, const uint32_t sample_count) {
+    close();
+    if (file_.open(sidecar_path(wav_path)).is_valid())
+        return false;
+
+    const auto result = file_.read(&header_, sizeof(header_));
+    if (result.is_error() || *result != sizeof(header_) || header_.magic != file_magic)
+        return false;
+
+    const uint32_t difference = (header_.sample_count > sample_count) ? header_.sample_count - sample_count : sample_count - header_.sample_count;
+    if (difference >= level_block(0))
+        return false;
+
+    buffer_count_ = 0;
+    open_ = true;
+    return true;
+}
+
+void PeakReader::close() {
+    open_ = false;
+    file_.close();
+}
+
+bool PeakReader::get(const size_t level, const uint32_t index, Peak& peak) {
+    if (level != buffer_level_ || index < buffer_first_ || index >= buffer_first_ + buffer_count_) {
+        const auto n = std::min<uint32_t>(buffer_.size(), header_.counts[level] - index);
+        buffer_count_ = 0;
+        if (file_.seek(level_offset(header_, level) + index * sizeof(Peak)).is_error())
+            return false;
+        const auto result = file_.read(buffer_.data(), n * sizeof(Peak));
+        if (result.is_error() || *result != n * sizeof(Peak))
+            return false;
+        buffer_level_ = level;
+        buffer_first_ = index;
+        buffer_count_ = n;
+    }
+    peak = buffer_[index - buffer_first_];
+    return true;
+}
+
+bool PeakReader::read(const uint64_t first, const uint32_t step, Peak* out, const size_t n) {
+    const int level = level_for(step);
+    if (!open_ || level < 0)
+        return false;
+
+    const uint32_t block = level_block(level);
+    const uint32_t count = header_.counts[level];
+
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t start = first + i * step;
+        const uint64_t begin = start / block;
+        const uint64_t end = std::min<uint64_t>(std::max(begin + 1, (start + step + block - 1) / block), count);
+
+        Peak peak{};
+        for (auto b = begin; b < end; b++) {
+            Peak block_peak;
+            if (!get(level, b, block_peak))
+                return false;
+            peak.add(block_peak);
+        }
+        out[i] = peak;
+    }
+    return true;
+}
+
+} /* namespace wav_peaks */
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __WAV_PEAKS_H__
+#define __WAV_PEAKS_H__
+
+#include "file.hpp"
+#include "optional.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Min/max summary ("peak") sidecar for 16-bit mono WAV files, so waveform
+ * views can draw any zoom level without reading every sample.
+ *
+ * Level 0 holds one min/max pair per 256 samples, level 1 one per 65536.
+ * The file is a header followed by the level 0 peaks and then the level 1
+ * peaks; level 0 is streamed out while the samples come in, level 1 is
+ * built from it when the file is finished. */
+namespace wav_peaks {
+
+struct Peak {
+    int16_t min{INT16_MAX};
+    int16_t max{INT16_MIN};
+
+    void add(const int16_t sample) {
+        min = std::min(min, sample);
+        max = std::max(max, sample);
+    }
+
+    void add(const Peak& other) {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    bool empty() const {
+        return min > max;
+    }
+};
+
+constexpr size_t level_count = 2;
+
+constexpr uint32_t level_block(const size_t level) {
+    return 256UL << (8 * level);
+}
+
+/* Coarsest level with blocks no larger than the given number of samples,
+ * -1 if even level 0 is too coarse. */
+constexpr int level_for(const uint32_t samples) {
+    int level = -1;
+    while (level + 1 < (int)level_count && level_block(level + 1) <= samples)
+        level++;
+    return level;
+}
+
+/* Collects samples into one Peak per block. */
+class BlockAccumulator {
+   public:
+    explicit constexpr BlockAccumulator(const uint32_t block)
+        : block_{block} {}
+
+    /* Returns true, with the finished block in out, every block samples. */
+    bool add(const int16_t sample, Peak& out) {
+        current_.add(sample);
+        if (++count_ < block_)
+            return false;
+        return flush(out);
+    }
+
+    /* Same, for summarising the peaks of a finer level. */
+    bool add(const Peak& peak, Peak& out) {
+        current_.add(peak);
+        if (++count_ < block_)
+            return false;
+        return flush(out);
+    }
+
+    /* Returns a partial last block, if any. */
+    bool flush(Peak& out) {
+        if (count_ == 0)
+            return false;
+        out = current_;
+        current_ = {};
+        count_ = 0;
+        return true;
+    }
+
+   private:
+    const uint32_t block_;
+    Peak current_{};
+    uint32_t count_{0};
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t sample_count;
+    uint32_t counts[level_count];
+};
+
+constexpr uint32_t file_magic = 0x314b5050; /* "PPK1" */
+
+std::filesystem::path sidecar_path(const std::filesystem::path& wav_path);
+
+class PeakWriter {
+   public:
+    Optional<File::Error> create(const std::filesystem::path& wav_path);
+    bool is_open() const {
+        return open_;
+    }
+
+    void add(const int16_t* samples, const size_t count);
+    void add(const uint8_t* samples, const size_t count);
+
+    /* Writes the last partial block, level 1 and the header. */
+    Optional<File::Error> finish();
+
+   private:
+    File file_{};
+    bool open_{false};
+    bool failed_{false};
+    uint32_t sample_count_{0};
+    uint32_t level0_count_{0};
+    BlockAccumulator level0_{level_block(0)};
+    std::array<Peak, 64> pending_{};
+    size_t pending_count_{0};
+
+    void add_sample(const int16_t sample);
+    void emit(const Peak& peak);
+    void flush_pending();
+    void write_level1(FileHeader& header);
+};
+
+class PeakReader {
+   public:
+    /* Fails if there is no sidecar, or it doesn't match the sample count to
+     * within a block (a WAV header may count its own header as data). */
+    bool open(const std::filesystem::path& wav_path, const uint32_t sample_count);
+    void close();
+
+    /* out[i] gets the min/max of the samples from first + i * step on, for
+     * step samples, to block resolution. False if step is below the finest
+     * level or on read error. */
+    bool read(const uint64_t first, const uint32_t step, Peak* out, const size_t n);
+
+   private:
+    File file_{};
+    bool open_{false};
+    FileHeader header_{};
+    std::array<Peak, 64> buffer_{};
+    size_t buffer_level_{0};
+    uint32_t buffer_first_{0};
+    uint32_t buffer_count_{0};
+
+    bool get(const size_t level, const uint32_t index, Peak& peak);
+};
+
+} /* namespace wav_peaks */
+
+#endif /*__WAV_PEAKS_H__*/
@@ -226,6 +226,28 @@ void disable() {
     gpdma_channel_i2s0_rx.disable();
 }
 
+static bool tx_suspended = false;
+static bool rx_suspended = false;
+
+void suspend() {
+    tx_suspended = gpdma_channel_i2s0_tx.is_enabled();
+    rx_suspended = gpdma_channel_i2s0_rx.is_enabled();
+    disable();
+}
+
+void resume() {
+    // A warm restart skips the startup code, so start from the state a
+    // freshly loaded image would have.
+    single_tx_buffer = false;
+    beep_duration_downcounter = 0;
+    tx_next_lli = nullptr;
+    rx_next_lli = nullptr;
+    buffer_tx.fill({});
+
+    if (tx_suspended) init_audio_out();
+    if (rx_suspended) init_audio_in();
+}
+
 void shrink_tx_buffer(bool shrink) {
     single_tx_buffer = shrink;
 
@@ -46,6 +46,9 @@ namespace dma {
 void init_audio_in();
 void init_audio_out();
 void disable();
+/* Stop the running channels, and later restart the same ones from scratch. */
+void suspend();
+void resume();
 void shrink_tx_buffer(bool shrink);
 void beep_start(uint32_t freq, uint32_t sample_rate, uint32_t beep_duration_ms);
 void beep_stop();
@@ -40,6 +40,8 @@ void AudioOutput::configure(const bool do_proc) {
 void AudioOutput::configure(const iir_biquad_config_t& hpf_config, const iir_biquad_config_t& deemph_config, const float squelch_threshold) {
     hpf.configure(hpf_config);
     deemph.configure(deemph_config);
+    hpf_right.configure(hpf_config);
+    deemph_right.configure(deemph_config);
     squelch.set_threshold(squelch_threshold);
 }
 
@@ -93,17 +95,51 @@ void AudioOutput::write(const buffer_f32_t& audio) {
         });
 }
 
+void AudioOutput::write_stereo(const buffer_s16_t& left, const buffer_s16_t& right) {
+    std::array<float, 32> left_f;
+    std::array<float, 32> right_f;
+    std::array<float, 32> mid_f;
+    for (size_t i = 0; i < left.count; i++) {
+        left_f[i] = left.p[i] * ki;
+        right_f[i] = right.p[i] * ki;
+        mid_f[i] = (left_f[i] + right_f[i]) * 0.5f;
+    }
+    const buffer_f32_t left_buffer{left_f.data(), left.count, left.sampling_rate};
+    const buffer_f32_t right_buffer{right_f.data(), right.count, right.sampling_rate};
+
+    if (do_processing) {
+        const bool present = update_squelch({mid_f.data(), left.count, left.sampling_rate});
+
+        hpf.execute_in_place(left_buffer);
+        deemph.execute_in_place(left_buffer);
+        hpf_right.execute_in_place(right_buffer);
+        deemph_right.execute_in_place(right_buffer);
+
+        if (!present) {
+            left_f.fill(0);
+            right_f.fill(0);
+        }
+    } else
+        audio_present = true;
+
+    fill_audio_buffer(left_buffer, right_buffer, audio_present);
+}
+
+bool AudioOutput::update_squelch(const buffer_f32_t& audio) {
+    const auto audio_present_now = squelch.execute(audio);
+    audio_present_history = (audio_present_history << 1) | (audio_present_now ? 1 : 0);
+    audio_present = (audio_present_history != 0);
+    return audio_present;
+}
+
 void AudioOutput::on_block(const buffer_f32_t& audio) {
     if (do_processing) {
-        const auto audio_present_now = squelch.execute(audio);
+        const auto present = update_squelch(audio);
 
         hpf.execute_in_place(audio);     // IIRBiquadFilter name is "hpf", but we will call with "hpf-coef" for all  except AMFM (WFAX) with "lpf-coef" and notch for WFMAM (NOAA)
         deemph.execute_in_place(audio);  // IIRBiquadFilter name is "deemph", but we will call LPF de-emphasis or  other LPF for WFAM (NOAA).
 
-        audio_present_history = (audio_present_history << 1) | (audio_present_now ? 1 : 0);
-        audio_present = (audio_present_history != 0);
-
-        if (!audio_present) {
+        if (!present) {
             for (size_t i = 0; i < audio.count; i++) {
                 audio.p[i] = 0;
             }
@@ -147,6 +183,25 @@ void AudioOutput::fill_audio_buffer(const buffer_f32_t& audio, const bool send_t
     feed_audio_stats(audio);
 }
 
+void AudioOutput::fill_audio_buffer(const buffer_f32_t& left, const buffer_f32_t& right, const bool send_to_fifo) {
+    std::array<float, 32> mid;
+    std::array<int16_t, 32> audio_int;
+
+    auto audio_buffer = audio::dma::tx_empty_buffer();
+    for (size_t i = 0; i < audio_buffer.count; i++) {
+        audio_buffer.p[i].left = __SSAT(int32_t(left.p[i] * k), 16);
+        audio_buffer.p[i].right = __SSAT(int32_t(right.p[i] * k), 16);
+        mid[i] = (left.p[i] + right.p[i]) * 0.5f;
+        audio_int[i] = __SSAT(int32_t(mid[i] * k), 16);
+    }
+    // Recordings and statistics stay mono.
+    if (stream && send_to_fifo) {
+        stream->write(audio_int.data(), audio_buffer.count * sizeof(audio_int[0]));
+    }
+
+    feed_audio_stats(buffer_f32_t{mid.data(), audio_buffer.count, left.sampling_rate});
+}
+
 void AudioOutput::feed_audio_stats(const buffer_s16_t& audio) {
     audio_stats.feed(
         audio,
@@ -51,6 +51,10 @@ class AudioOutput {
     void write(const buffer_s16_t& audio);
     void write(const buffer_f32_t& audio);
 
+    /* Blocks of exactly one audio DMA buffer; squelch is decided on the
+     * mid signal, filters run per channel. */
+    void write_stereo(const buffer_s16_t& left, const buffer_s16_t& right);
+
     void set_stream(std::unique_ptr<StreamInput> new_stream) {
         stream = std::move(new_stream);
     }
@@ -70,6 +74,8 @@ class AudioOutput {
 
     IIRBiquadFilter hpf{};
     IIRBiquadFilter deemph{};
+    IIRBiquadFilter hpf_right{};
+    IIRBiquadFilter deemph_right{};
     FMSquelch squelch{};
 
     std::unique_ptr<StreamInput> stream{};
@@ -82,9 +88,11 @@ class AudioOutput {
     bool do_processing = true;
 
     void on_block(const buffer_f32_t& audio);
+    bool update_squelch(const buffer_f32_t& audio);
 
     void fill_audio_buffer(const buffer_s16_t& audio, const bool send_to_fifo);
     void fill_audio_buffer(const buffer_f32_t& audio, const bool send_to_fifo);
+    void fill_audio_buffer(const buffer_f32_t& left, const buffer_f32_t& right, const bool send_to_fifo);
 
     void feed_audio_stats(const buffer_s16_t& audio);
     void feed_audio_stats(const buffer_f32_t& audio);
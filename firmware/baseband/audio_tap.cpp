@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "audio_tap.hpp"
+
+#include "dsp_fft.hpp"
+#include "dsp_spectrum.hpp"
+#include "utility.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include <algorithm>
+
+void AudioTap::on_message(const Message* const message) {
+    if (message->id == Message::ID::AudioTapConfig) {
+        enabled = reinterpret_cast<const AudioTapConfigMessage*>(message)->enabled;
+        state = State::Idle;
+        samples_to_frame = 0;
+    }
+}
+
+bool AudioTap::clock(const size_t count, const uint32_t sampling_rate) {
+    if (!enabled)
+        return false;
+
+    samples_to_frame -= count;
+    if ((state != State::Idle) || (samples_to_frame > 0))
+        return false;
+
+    samples_to_frame = sampling_rate / frame_rate;
+    state = State::Capture;
+    return true;
+}
+
+void AudioTap::publish() {
+    AudioSpectrumMessage message{&frames[back]};
+    shared_memory.application_queue.push(message);
+    back ^= 1;
+    state = State::Idle;
+}
+
+void AudioSpectrumTap::transform() {
+    if (fft_step < fft_log2) {
+        fft_c_preswapped(fft_data, fft_step, fft_step + 1);
+        fft_step++;
+        return;
+    }
+
+    auto& db = frame().db;
+    for (size_t i = 0; i < db.size(); i++)
+        db[i] = dsp::spectrum::mag2_to_db_8bit(magnitude_squared(fft_data[i]));
+    publish();
+}
+
+void ScopeTap::add(const int16_t sample) {
+    if (bucket_fill == 0) {
+        bucket_min = bucket_max = sample;
+        min_first = true;
+    } else if (sample < bucket_min) {
+        bucket_min = sample;
+        min_first = false;
+    } else if (sample > bucket_max) {
+        bucket_max = sample;
+        min_first = true;
+    }
+
+    if (++bucket_fill < bucket_size)
+        return;
+    bucket_fill = 0;
+
+    // Whichever extreme came last is drawn last.
+    auto& db = frame().db;
+    const auto to_level = [](const int16_t s) {
+        return static_cast<uint8_t>(std::clamp((s >> 8) + 127, 0, 255));
+    };
+    db[point++] = to_level(min_first ? bucket_min : bucket_max);
+    db[point++] = to_level(min_first ? bucket_max : bucket_min);
+
+    if (point >= db.size())
+        publish();
+}
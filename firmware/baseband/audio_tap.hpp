@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __AUDIO_TAP_H__
+#define __AUDIO_TAP_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <complex>
+
+/* Feeds the audio spectrum and scope views of the application. A frame is
+ * started about as often as the display refreshes, whatever the rate of the
+ * signal, and frames go alternately into two AudioSpectrum buffers: the
+ * application reads the one it was handed while the next is written into
+ * the other. Nothing holds the buffer for the reader though; one that falls
+ * more than a frame behind (a busy UI thread) can see it being rewritten. */
+class AudioTap {
+   public:
+    void on_message(const Message* const message);
+
+   protected:
+    enum class State {
+        Idle,
+        Capture,
+        Transform,
+    };
+
+    State state{State::Idle};
+
+    constexpr AudioTap(const bool enabled)
+        : enabled{enabled} {
+    }
+
+    /* Counts off the samples of a buffer, true when a new frame capture
+     * starts with it. */
+    bool clock(const size_t count, const uint32_t sampling_rate);
+
+    AudioSpectrum& frame() {
+        return frames[back];
+    }
+
+    void publish();
+
+    static int16_t to_s16(const int16_t sample) {
+        return sample;
+    }
+
+    static int16_t to_s16(const float sample) {
+        const auto s = sample * 32768.0f;
+        return (s >= 32767.0f) ? 32767 : (s <= -32768.0f) ? -32768
+                                                          : static_cast<int16_t>(s);
+    }
+
+   private:
+    static constexpr uint32_t frame_rate = 60;
+
+    bool enabled;
+    int32_t samples_to_frame{0};
+    std::array<AudioSpectrum, 2> frames{};
+    size_t back{0};
+};
+
+/* 128 bin spectrum from 256 consecutive samples, the FFT spread over the
+ * following buffers so the audio doesn't skip. */
+class AudioSpectrumTap : public AudioTap {
+   public:
+    constexpr AudioSpectrumTap(const bool enabled = false)
+        : AudioTap{enabled} {
+    }
+
+    template <typename T>
+    void feed(const buffer_t<T>& audio) {
+        if (clock(audio.count, audio.sampling_rate))
+            collected = 0;
+
+        if (state == State::Capture) {
+            for (size_t i = 0; (i < audio.count) && (collected < fft_size); i++, collected++) {
+                // Stored bit reversed, ready for the in-place FFT. The /32 keeps
+                // the levels the WFM view has always shown.
+                const size_t n = __RBIT(collected) >> (32 - fft_log2);
+                fft_data[n] = {static_cast<float>(to_s16(audio.p[i]) / 32), 0.0f};
+            }
+            if (collected == fft_size) {
+                fft_step = 0;
+                state = State::Transform;
+            }
+        } else if (state == State::Transform) {
+            transform();
+        }
+    }
+
+   private:
+    static constexpr size_t fft_log2 = 8;
+    static constexpr size_t fft_size = 1 << fft_log2;
+
+    std::array<std::complex<float>, fft_size> fft_data{};
+    size_t collected{0};
+    size_t fft_step{0};
+
+    void transform();
+};
+
+/* Waveform of 128 points, in pairs holding the min and max of each stretch
+ * of samples in the order they occurred, so peaks survive the decimation. */
+class ScopeTap : public AudioTap {
+   public:
+    constexpr ScopeTap(const bool enabled = false)
+        : AudioTap{enabled} {
+    }
+
+    /* Samples per point; 1 shows the signal as it is. */
+    void set_decimation(const size_t factor) {
+        bucket_size = 2 * ((factor > 0) ? factor : 1);
+    }
+
+    template <typename T>
+    void feed(const buffer_t<T>& audio) {
+        if (clock(audio.count, audio.sampling_rate)) {
+            point = 0;
+            bucket_fill = 0;
+        }
+
+        for (size_t i = 0; (i < audio.count) && (state == State::Capture); i++)
+            add(to_s16(audio.p[i]));
+    }
+
+   private:
+    size_t bucket_size{2};
+    size_t bucket_fill{0};
+    size_t point{0};
+    int16_t bucket_min{0};
+    int16_t bucket_max{0};
+    bool min_first{true};
+
+    void add(const int16_t sample);
+};
+
+#endif /*__AUDIO_TAP_H__*/
@@ -28,6 +28,7 @@
 void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
     channel_stats.feed(
         channel,
+        shared_memory.retune_epoch,
         [](const ChannelStatistics& statistics) {
             const ChannelStatisticsMessage channel_stats_message{statistics};
             shared_memory.application_queue.push(channel_stats_message);
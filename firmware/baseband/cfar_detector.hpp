@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CFAR_DETECTOR_H__
+#define __CFAR_DETECTOR_H__
+
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Cell-averaging CFAR over one spectrum slice. Works on the log (0..255)
+ * bins of a ChannelSpectrum, so the noise estimate is the mean of the
+ * training cells around each bin, skipping guard cells next to it. The local
+ * estimate is never allowed below the slice noise floor, which keeps quiet
+ * stretches of spectrum from producing false alarms. Adjacent bins over the
+ * threshold are merged into one (bin, power, width) detection. */
+class CFARDetector {
+   public:
+    static constexpr size_t bin_count = 256;
+
+    void configure(const SpectrumDetectorConfigMessage& message) {
+        config = {message.threshold, message.guard_bins, message.training_bins, message.edge_bins, message.dc_bins};
+    }
+
+    bool enabled() const {
+        return config.threshold != 0;
+    }
+
+    /* Runs the detector over spectrum.db and fills in noise_floor and the
+     * detections of the spectrum. */
+    void execute(ChannelSpectrum& spectrum) {
+        spectrum.detection_count = 0;
+
+        // Bins in frequency order, excluded ones (edges, DC spike) are not
+        // used as training cells nor reported.
+        std::array<uint8_t, bin_count> bins;
+        uint32_t sum = 0;
+        uint32_t count = 0;
+        for (size_t i = 0; i < bin_count; i++) {
+            bins[i] = spectrum.db[(i + bin_count / 2) % bin_count];
+            if (!is_excluded(i)) {
+                sum += bins[i];
+                count++;
+            }
+        }
+        if (count == 0)
+            return;
+
+        // Slice noise floor: mean of the bins below the overall mean, so strong
+        // emitters don't raise it.
+        const uint32_t mean = sum / count;
+        uint32_t floor_sum = 0;
+        uint32_t floor_count = 0;
+        for (size_t i = 0; i < bin_count; i++) {
+            if (!is_excluded(i) && bins[i] <= mean) {
+                floor_sum += bins[i];
+                floor_count++;
+            }
+        }
+        const uint32_t noise_floor = floor_count ? (floor_sum / floor_count) : mean;
+        spectrum.noise_floor = noise_floor;
+
+        // Prefix sums for O(1) training window averages.
+        std::array<uint16_t, bin_count + 1> prefix_sum;
+        std::array<uint16_t, bin_count + 1> prefix_count;
+        prefix_sum[0] = 0;
+        prefix_count[0] = 0;
+        for (size_t i = 0; i < bin_count; i++) {
+            const bool used = !is_excluded(i);
+            prefix_sum[i + 1] = prefix_sum[i] + (used ? bins[i] : 0);
+            prefix_count[i + 1] = prefix_count[i] + (used ? 1 : 0);
+        }
+
+        SpectrumDetection current{};
+        bool in_detection = false;
+
+        for (size_t i = 0; i < bin_count; i++) {
+            bool hit = false;
+            uint32_t local_noise = noise_floor;
+
+            if (!is_excluded(i)) {
+                const uint32_t window_sum = training_sum(prefix_sum, i);
+                const uint32_t window_count = training_sum(prefix_count, i);
+                if (window_count && (window_sum / window_count) > local_noise)
+                    local_noise = window_sum / window_count;
+
+                hit = bins[i] >= local_noise + config.threshold;
+            }
+
+            if (hit) {
+                if (!in_detection) {
+                    current = {static_cast<uint8_t>(i), 0, 0, 0};
+                    in_detection = true;
+                }
+                current.width++;
+                if (bins[i] > current.power) {
+                    current.power = bins[i];
+                    current.bin = i;
+                    current.snr = bins[i] - local_noise;
+                }
+            } else if (in_detection) {
+                add_detection(spectrum, current);
+                in_detection = false;
+            }
+        }
+        if (in_detection)
+            add_detection(spectrum, current);
+    }
+
+   private:
+    struct Config {
+        uint8_t threshold;
+        uint8_t guard_bins;
+        uint8_t training_bins;
+        uint8_t edge_bins;
+        uint8_t dc_bins;
+    };
+    Config config{0, 0, 0, 0, 0};
+
+    bool is_excluded(const size_t i) const {
+        if ((i < config.edge_bins) || (i >= bin_count - config.edge_bins))
+            return true;
+        return (i >= bin_count / 2 - config.dc_bins) && (i < bin_count / 2 + config.dc_bins);
+    }
+
+    /* Sum over the leading and lagging training cells around bin i. */
+    uint32_t training_sum(const std::array<uint16_t, bin_count + 1>& prefix, const size_t i) const {
+        const size_t near = config.guard_bins + 1;
+        const size_t far = config.guard_bins + config.training_bins;
+        uint32_t total = 0;
+
+        if (i >= near) {
+            const size_t start = (i >= far) ? (i - far) : 0;
+            total += prefix[i - near + 1] - prefix[start];
+        }
+        if (i + near < bin_count) {
+            const size_t end = (i + far < bin_count) ? (i + far + 1) : bin_count;
+            total += prefix[end] - prefix[i + near];
+        }
+        return total;
+    }
+
+    static void add_detection(ChannelSpectrum& spectrum, const SpectrumDetection& detection) {
+        if (spectrum.detection_count < spectrum.detections.size()) {
+            spectrum.detections[spectrum.detection_count++] = detection;
+            return;
+        }
+
+        // Full, replace the weakest if this one is stronger.
+        size_t weakest = 0;
+        for (size_t n = 1; n < spectrum.detections.size(); n++) {
+            if (spectrum.detections[n].power < spectrum.detections[weakest].power)
+                weakest = n;
+        }
+        if (detection.power > spectrum.detections[weakest].power)
+            spectrum.detections[weakest] = detection;
+    }
+};
+
+#endif /*__CFAR_DETECTOR_H__*/
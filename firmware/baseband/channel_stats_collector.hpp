@@ -24,6 +24,7 @@
 
 #include "dsp_types.hpp"
 #include "message.hpp"
+#include "retune_settle_detector.hpp"
 #include "utility.hpp"
 
 #include <cstdint>
@@ -34,7 +35,15 @@
 class ChannelStatsCollector {
    public:
     template <typename Callback>
-    void feed(const buffer_c16_t& src, Callback callback) {
+    void feed(const buffer_c16_t& src, const uint32_t retune_epoch, Callback callback) {
+        const bool was_settled = settle.settled() && (settle.epoch() == retune_epoch);
+        if (!settle.feed(src, retune_epoch)) {
+            // Samples from before the front end settled would report the old frequency.
+            max_squared = 0;
+            count = 0;
+            return;
+        }
+
         void* src_p = src.p;
         while (src_p < &src.p[src.count]) {
             const uint32_t sample = *__SIMD32(src_p)++;
@@ -47,10 +56,11 @@ class ChannelStatsCollector {
 
         const size_t samples_per_update = src.sampling_rate * update_interval;
 
-        if (count >= samples_per_update) {
+        // Report the first settled block right away, so retuning apps don't wait a full interval.
+        if ((count >= samples_per_update) || !was_settled) {
             const float max_squared_f = max_squared;
             const int32_t max_db = mag2_to_dbv_norm(max_squared_f * (1.0f / (32768.0f * 32768.0f)));
-            callback({max_db, count});
+            callback({max_db, count, retune_epoch, true});
 
             max_squared = 0;
             count = 0;
@@ -61,6 +71,7 @@ class ChannelStatsCollector {
     static constexpr float update_interval{0.1f};
     uint32_t max_squared{0};
     size_t count{0};
+    RetuneSettleDetector settle{};
 };
 
 #endif /*__CHANNEL_STATS_COLLECTOR_H__*/
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_SPECTRUM_H__
+#define __DSP_SPECTRUM_H__
+
+#include "dsp_types.hpp"
+#include "dsp_fft.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <complex>
+
+namespace dsp {
+namespace spectrum {
+
+/* Periodic Hamming window for 256 points in Q15, first half; the second
+ * half mirrors it. Applied to the samples this is the same as the three
+ * point (0.54, -0.23) convolution of the bins it replaces. */
+constexpr std::array<int16_t, 129> hamming_256_q15{{
+    2621, 2626, 2640, 2662, 2694, 2735, 2785, 2843, 2911, 2988, 3073, 3167, 3270,
+    3382, 3503, 3631, 3769, 3915, 4069, 4231, 4401, 4580, 4766, 4960, 5162, 5371,
+    5588, 5812, 6043, 6281, 6526, 6778, 7036, 7301, 7572, 7849, 8132, 8421, 8716,
+    9015, 9320, 9631, 9946, 10265, 10589, 10918, 11250, 11586, 11926, 12270, 12617, 12967,
+    13319, 13674, 14032, 14392, 14754, 15118, 15483, 15850, 16217, 16586, 16955, 17325, 17695,
+    18065, 18434, 18804, 19172, 19540, 19906, 20272, 20635, 20997, 21357, 21715, 22070, 22423,
+    22773, 23120, 23463, 23803, 24139, 24472, 24800, 25124, 25444, 25759, 26069, 26374, 26674,
+    26968, 27257, 27540, 27817, 28088, 28353, 28611, 28863, 29108, 29347, 29578, 29802, 30018,
+    30228, 30429, 30624, 30810, 30988, 31159, 31321, 31475, 31621, 31758, 31887, 32007, 32119,
+    32222, 32316, 32402, 32478, 32546, 32605, 32655, 32695, 32727, 32750, 32763, 32767,
+}};
+
+inline complex16_t hamming_256(const complex16_t s, const size_t i) {
+    const int32_t w = hamming_256_q15[(i <= 128) ? i : (256 - i)];
+    return {
+        static_cast<int16_t>((s.real() * w) >> 15),
+        static_cast<int16_t>((s.imag() * w) >> 15)};
+}
+
+/* fft_swap() with the Hamming window applied on the way in. */
+template <typename T>
+void fft_swap_hamming(const buffer_c16_t src, std::array<T, 256>& dst) {
+    constexpr size_t N = 256;
+    for (size_t i = 0; i < N; i++) {
+        const size_t i_rev = __RBIT(i) >> (32 - log_2(N));
+        const auto s = hamming_256(src.p[i], i);
+        dst[i_rev] = {
+            static_cast<typename T::value_type>(s.real()),
+            static_cast<typename T::value_type>(s.imag())};
+    }
+}
+
+/* log2(1 + m) for the top five mantissa bits, in Q8 spectrum levels. */
+constexpr std::array<int16_t, 32> log2_mantissa_q8{{
+    86, 255, 418, 577, 731, 882, 1028, 1171, 1310, 1445, 1577, 1707, 1833, 1957, 2077, 2196,
+    2312, 2425, 2536, 2645, 2752, 2857, 2960, 3061, 3160, 3258, 3354, 3448, 3541, 3632, 3721, 3810,
+}};
+
+/* Squared magnitude of a bin of int16 scaled samples to the 0..255 scale of
+ * ChannelSpectrum::db, i.e. 5 levels per dBV below full scale at 255. The
+ * log is taken from the float's exponent and a mantissa table, and the
+ * result is within one level of mag2_to_dbv_norm(). */
+inline uint8_t mag2_to_db_8bit(const float mag2) {
+    constexpr int32_t full_scale_log2 = 30;  // (1 << 15) squared
+    constexpr int32_t levels_per_log2_q8 = 3853;
+    constexpr int32_t top_level_q8 = 255 << 8;
+
+    uint32_t bits;
+    std::memcpy(&bits, &mag2, sizeof(bits));
+
+    const int32_t exponent = static_cast<int32_t>(bits >> 23) - 127 - full_scale_log2;
+    const int32_t level_q8 = top_level_q8 + exponent * levels_per_log2_q8 + log2_mantissa_q8[(bits >> 18) & 31];
+    if (level_q8 <= 0) return 0;
+    if (level_q8 >= top_level_q8) return 255;
+    return level_q8 >> 8;
+}
+
+} /* namespace spectrum */
+} /* namespace dsp */
+
+#endif /*__DSP_SPECTRUM_H__*/
@@ -20,6 +20,7 @@
  */
 
 #include "ch.h"
+#include "audio_dma.hpp"
 #include "debug.hpp"
 #include "event_m4.hpp"
 #include "lpc43xx_cpp.hpp"
@@ -48,26 +49,29 @@ CH_IRQ_HANDLER(MAPP_IRQHandler) {
 
 Thread* EventDispatcher::thread_event_loop = nullptr;
 
-EventDispatcher::EventDispatcher(
-    std::unique_ptr<BasebandProcessor> baseband_processor)
-    : baseband_processor{std::move(baseband_processor)} {
-}
-
 void EventDispatcher::run() {
     thread_event_loop = chThdSelf();
 
     lpc43xx::creg::m0apptxevent::enable();
 
-    // Indicate to the M0 thread that
-    // M4 is ready to receive message events.
-    shared_memory.set_baseband_ready();
+    while (true) {
+        // Indicate to the M0 thread that
+        // M4 is ready to receive message events.
+        shared_memory.set_baseband_ready();
 
-    while (is_running) {
-        const auto events = wait();
-        dispatch(events);
-    }
+        while (is_running) {
+            const auto events = wait();
+            dispatch(events);
+        }
 
-    lpc43xx::creg::m0apptxevent::disable();
+        // Tear down the processor (threads, DMA) and wait for the M0 to
+        // either load another image or warm restart this one.
+        baseband_processor.reset();
+        park();
+
+        baseband_processor = make_processor();
+        is_running = true;
+    }
 }
 
 void EventDispatcher::request_stop() {
@@ -112,6 +116,47 @@ void EventDispatcher::on_message_shutdown(const ShutdownMessage&) {
     request_stop();
 }
 
+/* The M0 may overwrite M4 code RAM as soon as the shutdown is acknowledged,
+ * so nothing may run until it either resets this core or sends a warm
+ * restart: interrupts and the system tick stay off, and only the M0 event
+ * wakes the core to look at the message. */
+void EventDispatcher::park() {
+    audio::dma::suspend();
+
+    // A pending DMA interrupt would keep waking the core below.
+    nvicDisableVector(DMA_IRQn);
+
+    const auto systick_ctrl = SysTick->CTRL;
+    chSysDisable();
+    systick_stop();
+
+    // Acknowledge the shutdown.
+    shared_memory.baseband_message = nullptr;
+
+    while (true) {
+        creg::m0apptxevent::clear();
+        NVIC_ClearPendingIRQ(M0CORE_IRQn);
+
+        const auto message = shared_memory.baseband_message;
+        if (message) {
+            shared_memory.baseband_message = nullptr;
+            if (message->id == Message::ID::WarmRestart)
+                break;
+        }
+
+        port_wait_for_interrupt();
+    }
+
+    SysTick->VAL = 0;
+    SysTick->CTRL = systick_ctrl;
+    chSysEnable();
+
+    nvicEnableVector(DMA_IRQn, CORTEX_PRIORITY_MASK(LPC_DMA_IRQ_PRIORITY));
+
+    // Audio DMA is set up by main() in many images, before the processor.
+    audio::dma::resume();
+}
+
 void EventDispatcher::on_message_default(const Message* const message) {
     baseband_processor->on_message(message);
 }
@@ -31,12 +31,22 @@
 
 #include "ch.h"
 
+#include <memory>
+
 constexpr auto EVT_MASK_BASEBAND = EVENT_MASK(0);
 constexpr auto EVT_MASK_SPECTRUM = EVENT_MASK(1);
 
 class EventDispatcher {
    public:
-    EventDispatcher(std::unique_ptr<BasebandProcessor> baseband_processor);
+    /* The processor type is remembered so a fresh instance can be built
+     * when the M0 warm restarts the image. */
+    template <typename Processor>
+    EventDispatcher(std::unique_ptr<Processor> baseband_processor)
+        : baseband_processor{std::move(baseband_processor)},
+          make_processor{[]() -> std::unique_ptr<BasebandProcessor> {
+              return std::make_unique<Processor>();
+          }} {
+    }
 
     void run();
     void request_stop();
@@ -53,6 +63,7 @@ class EventDispatcher {
     static Thread* thread_event_loop;
 
     std::unique_ptr<BasebandProcessor> baseband_processor;
+    std::unique_ptr<BasebandProcessor> (*const make_processor)();
 
     bool is_running = true;
 
@@ -66,6 +77,8 @@ class EventDispatcher {
     void on_message_shutdown(const ShutdownMessage&);
     void on_message_default(const Message* const message);
 
+    void park();
+
     void handle_spectrum();
 };
 
@@ -0,0 +1,511 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __MPX_DECODER_H__
+#define __MPX_DECODER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace mpx {
+
+/* FM broadcast multiplex: mono (L+R) audio up to 15 kHz, a 19 kHz pilot,
+ * L-R on a suppressed 38 kHz carrier and RDS on 57 kHz, the last two phase
+ * locked to the pilot. */
+constexpr float pilot_hz = 19000.0f;
+
+/* RDS sends biphase coded, differentially encoded bits at 1187.5 bps, so
+ * the BPSK symbol ("chip") rate is twice that. */
+constexpr float rds_chip_rate = 2375.0f;
+
+/* An RDS block is 16 data bits and a 10 bit checkword, the CRC of the data
+ * XORed with an offset word that names the block's position in the group. */
+constexpr uint32_t rds_generator = 0x5b9;
+constexpr uint32_t rds_block_mask = 0x3ffffff;
+
+enum RDSOffset : uint32_t {
+    A = 0x0fc,
+    B = 0x198,
+    C = 0x168,
+    Cprime = 0x350,
+    D = 0x1b4,
+};
+
+/* Remainder of a 26 bit block divided by the generator; for a block
+ * received without errors this is its offset word. */
+constexpr uint32_t rds_syndrome(uint32_t block) {
+    for (int bit = 25; bit >= 10; bit--) {
+        if (block & (1u << bit))
+            block ^= rds_generator << (bit - 10);
+    }
+    return block;
+}
+
+constexpr uint32_t rds_encode(const uint16_t data, const uint32_t offset) {
+    return (uint32_t(data) << 10) | (rds_syndrome(uint32_t(data) << 10) ^ offset);
+}
+
+/* Second order PLL on the pilot. The NCO is a unit phasor rotated by the
+ * nominal pilot step and a small correction each sample, so the 38 and
+ * 57 kHz carriers are plain polynomials of it. The phase error is
+ * normalised by the pilot amplitude, which is estimated once per block. */
+class PilotPLL {
+   public:
+    void configure(const float sample_rate) {
+        const float step = 2.0f * pi * pilot_hz / sample_rate;
+        step_cos = std::cos(step);
+        step_sin = std::sin(step);
+
+        const float theta = (loop_bandwidth_hz / sample_rate) / (damping + 0.25f / damping);
+        const float d = 1.0f + 2.0f * damping * theta + theta * theta;
+        kp = 4.0f * damping * theta / d;
+        ki = 4.0f * theta * theta / d;
+        max_frequency = 2.0f * pi * max_offset_hz / sample_rate;
+
+        reset();
+    }
+
+    void reset() {
+        cos_ = 1.0f;
+        sin_ = 0.0f;
+        frequency = 0.0f;
+        i_avg = 0.0f;
+        q_avg = 0.0f;
+        error_gain = 0.0f;
+        locked_ = false;
+        lock_count = 0;
+    }
+
+    /* Advances the NCO past one sample; cos() and sin() are its phase for
+     * the sample being fed. */
+    void feed(const float x) {
+        const float pd_i = x * cos_;
+        const float pd_q = -x * sin_;
+        i_avg += (pd_i - i_avg) * average_alpha;
+        q_avg += (pd_q - q_avg) * average_alpha;
+
+        const float error = pd_q * error_gain;
+        frequency = std::clamp(frequency + ki * error, -max_frequency, max_frequency);
+        const float delta = kp * error + frequency;
+
+        const float c = cos_ * step_cos - sin_ * step_sin;
+        const float s = sin_ * step_cos + cos_ * step_sin;
+        const float c2 = c - delta * s;
+        const float s2 = s + delta * c;
+        const float g = 1.5f - 0.5f * (c2 * c2 + s2 * s2);
+        cos_ = c2 * g;
+        sin_ = s2 * g;
+    }
+
+    /* Refreshes the amplitude estimate and the lock indicator. */
+    void update() {
+        const float amplitude = std::sqrt(i_avg * i_avg + q_avg * q_avg);
+        if (amplitude < min_amplitude) {
+            // No pilot: free run at the nominal frequency rather than chase
+            // noise, so the 57 kHz mixer stays close for RDS on mono stations.
+            error_gain = 0.0f;
+            frequency = 0.0f;
+        } else {
+            error_gain = 1.0f / amplitude;
+        }
+
+        const bool in_phase = (i_avg > lock_ratio * amplitude) && (amplitude > min_amplitude);
+        if (in_phase) {
+            if (lock_count < lock_blocks)
+                lock_count++;
+            else
+                locked_ = true;
+        } else {
+            lock_count = 0;
+            if (i_avg < unlock_ratio * amplitude || amplitude < min_amplitude / 2)
+                locked_ = false;
+        }
+    }
+
+    float cos() const {
+        return cos_;
+    }
+
+    float sin() const {
+        return sin_;
+    }
+
+    bool locked() const {
+        return locked_;
+    }
+
+   private:
+    static constexpr float pi = 3.14159265358979f;
+    static constexpr float loop_bandwidth_hz = 20.0f;
+    static constexpr float damping = 0.707f;
+    static constexpr float max_offset_hz = 20.0f;
+    static constexpr float average_alpha = 1.0f / 4096;
+    /* i_avg is half the pilot amplitude; a 9% pilot gives about 0.04. */
+    static constexpr float min_amplitude = 0.01f;
+    static constexpr float lock_ratio = 0.9f;
+    static constexpr float unlock_ratio = 0.7f;
+    static constexpr size_t lock_blocks = 32;
+
+    float step_cos{1.0f};
+    float step_sin{0.0f};
+    float kp{0};
+    float ki{0};
+    float max_frequency{0};
+
+    float cos_{1.0f};
+    float sin_{0.0f};
+    float frequency{0};
+    float i_avg{0};
+    float q_avg{0};
+    float error_gain{1.0f};
+    bool locked_{false};
+    size_t lock_count{0};
+};
+
+/* Recovers RDS bits from the 57 kHz subcarrier mixed down to complex
+ * baseband. A Costas loop removes what is left of the carrier phase (RDS
+ * may be in quadrature with the third pilot harmonic, and mono stations
+ * have no pilot at all), chips are integrated between clock ticks kept on
+ * the signal's zero crossings, and chip pairs are split into bits on the
+ * alignment that looks most like biphase. */
+class RDSDemodulator {
+   public:
+    void configure(const float sample_rate) {
+        chip_step = rds_chip_rate / sample_rate;
+
+        const float theta = (loop_bandwidth_hz / sample_rate) / (damping + 0.25f / damping);
+        const float d = 1.0f + 2.0f * damping * theta + theta * theta;
+        kp = 4.0f * damping * theta / d;
+        ki = 4.0f * theta * theta / d;
+
+        rot_cos = 1.0f;
+        rot_sin = 0.0f;
+        frequency = 0.0f;
+        power = 0.0f;
+        phase = 0.0f;
+        level = false;
+        chip_sum = 0.0f;
+        previous_chip = 0.0f;
+        chip_parity = 0;
+        score = {};
+        previous_bit = false;
+    }
+
+    /* Returns true and sets bit when a data bit was completed. */
+    bool feed(const float i, const float q, bool& bit) {
+        const float yi = i * rot_cos + q * rot_sin;
+        const float yq = q * rot_cos - i * rot_sin;
+
+        power += (yi * yi + yq * yq - power) * power_alpha;
+        const float error = (yi * yq) / (power + min_power);
+        frequency += ki * error;
+        const float delta = kp * error + frequency;
+        const float c = rot_cos - delta * rot_sin;
+        const float s = rot_sin + delta * rot_cos;
+        const float g = 1.5f - 0.5f * (c * c + s * s);
+        rot_cos = c * g;
+        rot_sin = s * g;
+
+        const bool new_level = yi > 0;
+        if (new_level != level) {
+            // Pull the clock so zero crossings fall on chip boundaries.
+            const float clock_error = (phase < 0.5f) ? phase : phase - 1.0f;
+            phase -= clock_error * clock_gain;
+            if (phase < 0)
+                phase += 1.0f;
+            level = new_level;
+        }
+
+        chip_sum += yi;
+        phase += chip_step;
+        if (phase < 1.0f)
+            return false;
+        phase -= 1.0f;
+
+        const float chip = chip_sum;
+        chip_sum = 0.0f;
+        return on_chip(chip, bit);
+    }
+
+   private:
+    static constexpr float loop_bandwidth_hz = 10.0f;
+    static constexpr float damping = 0.707f;
+    static constexpr float power_alpha = 1.0f / 256;
+    static constexpr float min_power = 1e-9f;
+    static constexpr float clock_gain = 0.05f;
+    static constexpr float score_decay = 1.0f - 1.0f / 64;
+
+    float chip_step{0};
+    float kp{0};
+    float ki{0};
+
+    float rot_cos{1.0f};
+    float rot_sin{0.0f};
+    float frequency{0};
+    float power{0};
+    float phase{0};
+    bool level{false};
+    float chip_sum{0};
+    float previous_chip{0};
+    size_t chip_parity{0};
+    std::array<float, 2> score{};
+    bool previous_bit{false};
+
+    bool on_chip(const float chip, bool& bit) {
+        // A biphase symbol is a chip pair of opposite signs; a pair straddling
+        // two symbols only differs when consecutive bits differ.
+        const float difference = previous_chip - chip;
+        previous_chip = chip;
+        chip_parity ^= 1;
+        score[chip_parity] = score[chip_parity] * score_decay + std::fabs(difference);
+
+        if (score[chip_parity] < score[chip_parity ^ 1])
+            return false;
+
+        const bool encoded = difference > 0;
+        bit = encoded != previous_bit;
+        previous_bit = encoded;
+        return true;
+    }
+};
+
+/* Finds block boundaries with the checkword and collects groups. Sync is
+ * taken on any block whose syndrome is a valid offset and dropped after
+ * a run of bad blocks; a single bad block right after acquisition drops it
+ * too. No error correction is attempted. */
+class RDSGroupSync {
+   public:
+    static constexpr size_t max_bad_blocks = 8;
+
+    void reset() {
+        shift = 0;
+        bits = 0;
+        synced_ = false;
+        bad_blocks = 0;
+        index = 0;
+        valid = 0;
+        blocks = {};
+        group_.blocks = {};
+        group_.valid = 0;
+    }
+
+    /* Returns true when a group with a good block B was completed. */
+    bool feed(const bool bit) {
+        shift = ((shift << 1) | (bit ? 1 : 0)) & rds_block_mask;
+        if (bits < 26)
+            bits++;
+        if (bits < 26)
+            return false;
+
+        const auto found = block_index(rds_syndrome(shift));
+        if (!synced_) {
+            if (found < 0)
+                return false;
+
+            synced_ = true;
+            bad_blocks = max_bad_blocks - 1;
+            valid = 0;
+            bits = 0;
+            return on_block(found, true);
+        }
+
+        bits = 0;
+        const bool good = (found == int32_t(index));
+        if (good) {
+            bad_blocks = 0;
+        } else if (++bad_blocks >= max_bad_blocks) {
+            synced_ = false;
+            return false;
+        }
+        return on_block(index, good);
+    }
+
+    bool synced() const {
+        return synced_;
+    }
+
+    /* The last completed group. */
+    const RDSGroupMessage& group() const {
+        return group_;
+    }
+
+   private:
+    uint32_t shift{0};
+    size_t bits{0};
+    bool synced_{false};
+    size_t bad_blocks{0};
+    size_t index{0};
+    uint8_t valid{0};
+    std::array<uint16_t, 4> blocks{};
+    RDSGroupMessage group_{};
+
+    /* Position in the group for an offset word, or -1. C' counts as C. */
+    static int32_t block_index(const uint32_t syndrome) {
+        switch (syndrome) {
+            case RDSOffset::A:
+                return 0;
+            case RDSOffset::B:
+                return 1;
+            case RDSOffset::C:
+            case RDSOffset::Cprime:
+                return 2;
+            case RDSOffset::D:
+                return 3;
+            default:
+                return -1;
+        }
+    }
+
+    bool on_block(const size_t position, const bool good) {
+        blocks[position] = shift >> 10;
+        if (good)
+            valid |= 1 << position;
+
+        index = (position + 1) & 3;
+        if (index != 0)
+            return false;
+
+        // Without block B the group type is unknown.
+        const bool complete = valid & (1 << 1);
+        if (complete) {
+            group_.blocks = blocks;
+            group_.valid = valid;
+        }
+        valid = 0;
+        return complete;
+    }
+};
+
+/* One pass over the 192 kHz demodulated multiplex: tracks the pilot, writes
+ * the L-R signal for the caller to filter alongside the mono audio, and
+ * runs the RDS receiver on a 24 kHz complex baseband made with a third
+ * order CIC decimator. */
+class MPXDecoder {
+   public:
+    static constexpr uint32_t sample_rate = 192000;
+    static constexpr size_t rds_decimation = 8;
+    static constexpr uint32_t rds_sample_rate = sample_rate / rds_decimation;
+    /* 2 for the product with the carrier, and the droop of the 384 to
+     * 192 kHz CIC around 38 kHz. */
+    static constexpr float side_gain = 2.0f / 0.82f;
+
+    MPXDecoder() {
+        pll.configure(sample_rate);
+        rds.configure(rds_sample_rate);
+        sync.reset();
+    }
+
+    /* Writes L-R into side at the scale of the mono signal, or silence
+     * while the pilot isn't locked. Returns true when an RDS group became
+     * available through group(). */
+    bool execute(const buffer_s16_t& mpx, const buffer_s16_t& side) {
+        bool group_ready = false;
+        const bool stereo_now = pll.locked();
+
+        for (size_t n = 0; n < mpx.count; n++) {
+            const int32_t sample = mpx.p[n];
+            const float c = pll.cos();
+            const float s = pll.sin();
+            pll.feed(sample * (1.0f / 32768.0f));
+
+            if (stereo_now) {
+                // The pilot is sin(x), which the NCO's cos() locks onto, so
+                // the sin(2x) subcarrier is -2 sin() cos() of the NCO.
+                const float s2 = -2.0f * s * c;
+                const int32_t v = sample * s2 * side_gain;
+                side.p[n] = std::clamp<int32_t>(v, -32768, 32767);
+            } else {
+                side.p[n] = 0;
+            }
+
+            // cos(3x) and -sin(3x) in Q14.
+            const float c3 = c * (4.0f * c * c - 3.0f);
+            const float s3 = s * (4.0f * s * s - 3.0f);
+            group_ready |= feed_rds((sample * int32_t(c3 * 16384.0f)) >> 14,
+                                    (sample * int32_t(s3 * 16384.0f)) >> 14);
+        }
+
+        pll.update();
+        return group_ready;
+    }
+
+    bool stereo() const {
+        return pll.locked();
+    }
+
+    const RDSGroupMessage& group() const {
+        return sync.group();
+    }
+
+   private:
+    static constexpr float rds_scale = 1.0f / (rds_decimation * rds_decimation * rds_decimation * 32768.0f);
+
+    PilotPLL pll{};
+    RDSDemodulator rds{};
+    RDSGroupSync sync{};
+
+    /* CIC integrators and combs; unsigned so wrap around is defined. */
+    std::array<uint32_t, 3> integrator_i{};
+    std::array<uint32_t, 3> integrator_q{};
+    std::array<uint32_t, 3> comb_i{};
+    std::array<uint32_t, 3> comb_q{};
+    size_t rds_phase{0};
+
+    static int32_t comb(const uint32_t in, std::array<uint32_t, 3>& delay) {
+        uint32_t x = in;
+        for (auto& z : delay) {
+            const uint32_t y = x - z;
+            z = x;
+            x = y;
+        }
+        return int32_t(x);
+    }
+
+    bool feed_rds(const int32_t i, const int32_t q) {
+        integrator_i[0] += i;
+        integrator_i[1] += integrator_i[0];
+        integrator_i[2] += integrator_i[1];
+        integrator_q[0] += q;
+        integrator_q[1] += integrator_q[0];
+        integrator_q[2] += integrator_q[1];
+
+        if (++rds_phase < rds_decimation)
+            return false;
+        rds_phase = 0;
+
+        const float bi = comb(integrator_i[2], comb_i) * rds_scale;
+        const float bq = comb(integrator_q[2], comb_q) * rds_scale;
+        bool bit;
+        if (!rds.feed(bi, bq, bit))
+            return false;
+        return sync.feed(bit);
+    }
+};
+
+} /* namespace mpx */
+
+#endif /*__MPX_DECODER_H__*/
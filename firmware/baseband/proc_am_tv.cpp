@@ -34,37 +34,28 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
-    std::fill(spectrum.begin(), spectrum.end(), 0);
+    channel_spectrum.feed(buffer);
 
-    for (size_t i = 0; i < spectrum.size(); i++) {
-        spectrum[i] += buffer.p[i];
+    // The time scope shows the I samples at the start of a buffer. Only
+    // those are fed, so the tap is paced on a correspondingly lower rate.
+    for (size_t i = 0; i < scope_samples.size(); i++) {
+        scope_samples[i] = buffer.p[i].real() * 256;
     }
-
-    const buffer_c16_t buffer_c16{spectrum.data(), spectrum.size(), buffer.sampling_rate};
-    channel_spectrum.feed(buffer_c16);
-
-    int8_t re;
-    // int8_t im;
-    // int8_t mag;
-
-    for (size_t i = 0; i < 128; i++) {
-        re = buffer.p[i].real();
-        // im = buffer.p[i].imag();
-        // mag = __builtin_sqrtf((re * re) + (im * im)) ;
-        const unsigned int v = re + 127.0f;  // timescope
-        audio_spectrum.db[i] = std::max(0U, std::min(255U, v));
-    }
-    AudioSpectrumMessage message{&audio_spectrum};
-    shared_memory.application_queue.push(message);
+    scope.feed(buffer_s16_t{
+        scope_samples.data(), scope_samples.size(),
+        static_cast<uint32_t>(buffer.sampling_rate * scope_samples.size() / buffer.count)});
 }
 
 void WidebandFMAudio::on_message(const Message* const message) {
     switch (message->id) {
-        case Message::ID::UpdateSpectrum:
         case Message::ID::SpectrumStreamingConfig:
             channel_spectrum.on_message(message);
             break;
 
+        case Message::ID::AudioTapConfig:
+            scope.on_message(message);
+            break;
+
         case Message::ID::WFMConfigure:
             configure(*reinterpret_cast<const WFMConfigureMessage*>(message));
             break;
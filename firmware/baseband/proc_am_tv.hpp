@@ -34,6 +34,7 @@
 #include "block_decimator.hpp"
 
 #include "tv_collector.hpp"
+#include "audio_tap.hpp"
 
 class WidebandFMAudio : public BasebandProcessor {
    public:
@@ -42,15 +43,16 @@ class WidebandFMAudio : public BasebandProcessor {
 
    private:
     static constexpr size_t baseband_fs = 2000000;
+    static_assert(baseband_fs == TvLineSync::sampling_rate, "Line sync timing is for 2 MHz");
 
     std::array<complex16_t, 512> dst{};
     const buffer_c16_t dst_buffer{
         dst.data(),
         dst.size()};
 
-    AudioSpectrum audio_spectrum{};
     TvCollector channel_spectrum{};
-    std::array<complex16_t, 256> spectrum{};
+    ScopeTap scope{true};
+    std::array<int16_t, 128> scope_samples{};
     bool configured{false};
 
     /* NB: Threads should be the last members in the class definition. */
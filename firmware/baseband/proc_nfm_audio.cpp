@@ -60,36 +60,17 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
              * Note we're only processing a small section of the wave each time this fn is called */
             auto audio_ctcss = ctcss_filter.execute(audio, work_audio_buffer);
 
-            // s16 to f32 for hpf
-            std::array<float, 8> audio_f;
-            for (size_t i = 0; i < audio_ctcss.count; i++) {
-                audio_f[i] = audio_ctcss.p[i] * ki;
-            }
-
-            hpf.execute_in_place(buffer_f32_t{
-                audio_f.data(),
-                audio_ctcss.count,
-                audio_ctcss.sampling_rate});
-
-            // Zero-crossing detection
+            // Decimate to the sub-tone detector rate by averaging.
             for (size_t c = 0; c < audio_ctcss.count; c++) {
-                cur_sample = audio_f[c];
-                if (cur_sample * prev_sample < 0.0) {
-                    z_acc += z_timer;
-                    z_timer = 1;
-                    z_count++;
-                } else
-                    z_timer++;
-                prev_sample = cur_sample;
-            }
-
-            z_filter_count++;
-            if ((z_filter_count >= Z_MIN_FILTER_COUNT) && (z_count >= Z_MIN_ZERO_CROSSINGS)) {
-                ctcss_message.value = (100 * 12000 / 2 * z_count) / z_acc;
-                shared_memory.application_queue.push(ctcss_message);
-                z_filter_count = 0;
-                z_count = 0;
-                z_acc = 0;
+                subtone_acc += audio_ctcss.p[c] * ki;
+                if (++subtone_acc_count == subtone_decimation) {
+                    // Changes are rare, so keep one until the queue takes it.
+                    subtone_pending |= subtone_detector.execute(subtone_acc / subtone_decimation);
+                    if (subtone_pending)
+                        subtone_pending = !shared_memory.application_queue.push(subtone_detector.report());
+                    subtone_acc = 0;
+                    subtone_acc_count = 0;
+                }
             }
         }
     } else {
@@ -114,6 +95,7 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
     switch (message->id) {
         case Message::ID::UpdateSpectrum:
         case Message::ID::SpectrumStreamingConfig:
+        case Message::ID::WaterfallPalette:
             channel_spectrum.on_message(message);
             break;
 
@@ -156,7 +138,6 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
     channel_spectrum.set_decimation_factor(1.0f);
     audio_output.configure(message.audio_hpf_config, message.audio_deemph_config, (float)message.squelch_level / 100.0);
 
-    hpf.configure(audio_24k_hpf_30hz_config);
     ctcss_filter.configure(taps_64_lp_025_025.taps);
 
     configured = true;
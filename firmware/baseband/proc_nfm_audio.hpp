@@ -33,12 +33,10 @@
 
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
+#include "subtone_detector.hpp"
 
 #include <cstdint>
 
-#define Z_MIN_FILTER_COUNT 224
-#define Z_MIN_ZERO_CROSSINGS 20
-
 class NarrowbandFMAudio : public BasebandProcessor {
    public:
     void execute(const buffer_c8_t& buffer) override;
@@ -72,9 +70,13 @@ class NarrowbandFMAudio : public BasebandProcessor {
     int32_t channel_filter_high_f = 0;
     int32_t channel_filter_transition = 0;
 
-    // For CTCSS decoding
+    // For CTCSS/DCS decoding
     dsp::decimate::FIR64AndDecimateBy2Real ctcss_filter{};
-    IIRBiquadFilter hpf{};
+    subtone::SubToneDetector subtone_detector{};
+    static constexpr size_t subtone_decimation = 12000 / subtone::SubToneDetector::sample_rate;
+    float subtone_acc{0};
+    size_t subtone_acc_count{0};
+    bool subtone_pending{false};
 
     dsp::demodulate::FM demod{};
 
@@ -86,15 +88,12 @@ class NarrowbandFMAudio : public BasebandProcessor {
     uint32_t tone_delta{0};
     bool pitch_rssi_enabled{false};
 
-    float cur_sample{}, prev_sample{};
-    uint32_t z_acc{0}, z_timer{0}, z_count{0}, z_filter_count{0};
     bool ctcss_detect_enabled{true};
     static constexpr float k = 32768.0f;
     static constexpr float ki = 1.0f / k;
 
     bool configured{false};
     // RequestSignalMessage sig_message { RequestSignalMessage::Signal::Squelched };
-    CodedSquelchMessage ctcss_message{0};
 
     /* NB: Threads should be the last members in the class definition. */
     BasebandThread baseband_thread{baseband_fs, this, baseband::Direction::Receive};
@@ -119,6 +119,7 @@ void ReplayProcessor::on_message(const Message* const message) {
     switch (message->id) {
         case Message::ID::UpdateSpectrum:
         case Message::ID::SpectrumStreamingConfig:
+        case Message::ID::WaterfallPalette:
             channel_spectrum.on_message(message);
             break;
 
@@ -24,7 +24,6 @@
 
 #include "portapack_shared_memory.hpp"
 #include "audio_output.hpp"
-#include "dsp_fft.hpp"
 #include "event_m4.hpp"
 #include "audio_dma.hpp"
 
@@ -70,6 +69,30 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 
     auto audio_4fs = audio_dec_1.execute(audio_oversampled, work_audio_buffer);
 
+    /* 192kHz int16_t[128]   for wfm
+     * -> pilot PLL, L-R demodulation and RDS
+     * -> 192kHz int16_t[128] L-R
+     * -> 4th order CIC decimation by 2, FIR filter as below
+     * -> 48kHz int16_t[32] L-R */
+
+    const bool wfm = (decim_1.decimation_factor() == 2);
+    if (wfm) {
+        if (mpx_decoder.execute(audio_4fs, side_buffer))
+            shared_memory.application_queue.push(mpx_decoder.group());
+
+        if (mpx_decoder.stereo() != stereo) {
+            stereo = mpx_decoder.stereo();
+            stereo_pending = true;
+        }
+        if (stereo_pending)
+            stereo_pending = !shared_memory.application_queue.push(StereoPilotMessage{stereo});
+
+        if (stereo) {
+            const auto side_2fs = side_dec_1.execute({side.data(), audio_4fs.count, audio_4fs.sampling_rate}, side_buffer);
+            side_filter.execute(side_2fs, side_buffer);
+        }
+    }
+
     /* 192kHz int16_t[128]   for wfm
      * -> 4th order CIC decimation by 2, gain of 1
      * -> 96kHz int16_t[64] */
@@ -80,57 +103,8 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 
     auto audio_2fs = audio_dec_2.execute(audio_4fs, work_audio_buffer);
 
-    // Input: 96kHz int16_t[64]
-    // audio_spectrum_decimator piles up 256 samples before doing FFT computation
-    // This sends an AudioSpectrum every: sample rate/buffer size/refresh period = 3072000/2048/50 = 30 Hz
-    // When audio_spectrum_timer expires, the audio spectrum computation is triggered
-
-    // 0~3: feed continuous audio
-    // 4~31: ignore, wrap at 31
-
-    audio_spectrum_timer++;
-    if (audio_spectrum_timer == 50) {
-        audio_spectrum_timer = 0;
-        audio_spectrum_state = FEED;
-    }
-
-    switch (audio_spectrum_state) {
-        case FEED:
-            // Convert audio to "complex" just so the FFT can be done :/
-            for (size_t i = 0; i < 64; i++) {
-                complex_audio[i] = {(int16_t)(work_audio_buffer.p[i] / 32), (int16_t)0};
-            }
-            audio_spectrum_decimator.feed(
-                complex_audio_buffer,
-                [this](const buffer_c16_t& data) {
-                    this->post_message(data);
-                });
-            break;
-        case FFT:
-            // Spread the FFT workload in time to avoid making the audio skip
-            // "8" comes from the log2() of the size of audio_spectrum: log2(256) = 8
-            if (fft_step < 8) {
-                fft_c_preswapped(audio_spectrum, fft_step, fft_step + 1);
-                fft_step++;
-            } else {
-                const size_t spectrum_end = spectrum.db.size();
-                for (size_t i = 0; i < spectrum_end; i++) {
-                    // const auto corrected_sample = spectrum_window_hamming_3(audio_spectrum, i);
-                    const auto corrected_sample = audio_spectrum[i];
-                    const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-                    const float db = mag2_to_dbv_norm(mag2);
-                    constexpr float mag_scale = 5.0f;
-                    const unsigned int v = (db * mag_scale) + 255.0f;
-                    spectrum.db[i] = std::max(0U, std::min(255U, v));
-                }
-                AudioSpectrumMessage message{&spectrum};
-                shared_memory.application_queue.push(message);
-                audio_spectrum_state = IDLE;
-            }
-            break;
-        default:
-            break;
-    }
+    // 96kHz int16_t[64] for wfm, 24kHz int16_t[16] for wfmam
+    audio_spectrum.feed(audio_2fs);
 
     /* 96kHz int16_t[64]         for wfm
      * -> FIR filter, <15kHz (0.156fs) pass, >19kHz (0.198fs) stop, gain of 1
@@ -145,27 +119,37 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
     /* -> 48kHz int16_t[32]  for wfm  ,   */
     /* -> 12kHz int16_t[8]   for wfmam ,  */
 
-    if (decim_1.decimation_factor() == 2) {
+    if (wfm && stereo) {
+        write_stereo(audio, {side.data(), audio.count, audio.sampling_rate});
+    } else if (wfm) {
         audio_output.write(audio);  // we are in original wfm , decim_1.decimation_factor == 2
     } else {
         audio_output.apt_write(audio);  // we are in added wfmam (noaa), decim_1.decimation_factor == 8
     }
 }
 
-void WidebandFMAudio::post_message(const buffer_c16_t& data) {
-    // This is called when audio_spectrum_decimator is filled up to 256 samples
-    fft_swap(data, audio_spectrum);
-    audio_spectrum_state = FFT;
-    fft_step = 0;
+void WidebandFMAudio::write_stereo(const buffer_s16_t& mid, const buffer_s16_t& side) {
+    for (size_t i = 0; i < mid.count; i++) {
+        audio_left[i] = __SSAT(mid.p[i] + side.p[i], 16);
+        audio_right[i] = __SSAT(mid.p[i] - side.p[i], 16);
+    }
+    audio_output.write_stereo(
+        {audio_left.data(), mid.count, mid.sampling_rate},
+        {audio_right.data(), mid.count, mid.sampling_rate});
 }
 
 void WidebandFMAudio::on_message(const Message* const message) {
     switch (message->id) {
         case Message::ID::UpdateSpectrum:
         case Message::ID::SpectrumStreamingConfig:
+        case Message::ID::WaterfallPalette:
             channel_spectrum.on_message(message);
             break;
 
+        case Message::ID::AudioTapConfig:
+            audio_spectrum.on_message(message);
+            break;
+
         case Message::ID::WFMConfigure:
             configure_wfm(*reinterpret_cast<const WFMConfigureMessage*>(message));
             break;
@@ -207,6 +191,7 @@ void WidebandFMAudio::configure_wfm(const WFMConfigureMessage& message) {
     channel_filter_transition = message.decim_1_filter.transition_normalized * decim_1_input_fs;
     demod.configure(demod_input_fs, message.deviation);
     audio_filter.configure(message.audio_filter.taps);
+    side_filter.configure(message.audio_filter.taps);
     audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
 
     channel_spectrum.set_decimation_factor(1);
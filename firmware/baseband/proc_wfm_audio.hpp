@@ -30,10 +30,11 @@
 #include "dsp_types.hpp"
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
-#include "block_decimator.hpp"
 
 #include "audio_output.hpp"
+#include "audio_tap.hpp"
 #include "spectrum_collector.hpp"
+#include "mpx_decoder.hpp"
 
 #include <array>
 #include <memory>
@@ -93,11 +94,6 @@ class WidebandFMAudio : public BasebandProcessor {
         (int16_t*)dst.data(),
         sizeof(dst) / sizeof(int16_t)};
 
-    std::array<complex16_t, 64> complex_audio{};
-    const buffer_c16_t complex_audio_buffer{
-        complex_audio.data(),
-        complex_audio.size()};
-
     dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0{};
     // dsp::decimate::FIRC16xR16x16Decim2 decim_1{};   //original condition , before adding wfmam
 
@@ -118,20 +114,24 @@ class WidebandFMAudio : public BasebandProcessor {
     dsp::decimate::DecimateBy2CIC4Real audio_dec_2{};
     dsp::decimate::FIR64AndDecimateBy2Real audio_filter{};
 
+    /* WFM only: L-R from the 192 kHz multiplex, decimated and filtered
+     * exactly like the mono audio so the two stay aligned. */
+    mpx::MPXDecoder mpx_decoder{};
+    std::array<int16_t, 128> side{};
+    const buffer_s16_t side_buffer{
+        side.data(),
+        side.size()};
+    dsp::decimate::DecimateBy2CIC4Real side_dec_1{};
+    dsp::decimate::FIR64AndDecimateBy2Real side_filter{};
+    std::array<int16_t, 32> audio_left{};
+    std::array<int16_t, 32> audio_right{};
+    bool stereo{false};
+    bool stereo_pending{false};
+
     AudioOutput audio_output{};
 
-    // For fs=96kHz FFT streaming
-    BlockDecimator<complex16_t, 256> audio_spectrum_decimator{1};
-    std::array<std::complex<float>, 256> audio_spectrum{};
-    uint32_t audio_spectrum_timer{0};
-    enum AudioSpectrumState {
-        IDLE = 0,
-        FEED,
-        FFT
-    };
-    AudioSpectrumState audio_spectrum_state{IDLE};
-    AudioSpectrum spectrum{};
-    uint32_t fft_step{0};
+    // On by default, the FM radio and graphic equalizer apps rely on it.
+    AudioSpectrumTap audio_spectrum{true};
 
     SpectrumCollector channel_spectrum{};
     size_t spectrum_interval_samples = 0;
@@ -146,7 +146,7 @@ class WidebandFMAudio : public BasebandProcessor {
     void configure_wfm(const WFMConfigureMessage& message);
     void configure_wfmam(const WFMAMConfigureMessage& message);
     void capture_config(const CaptureConfigMessage& message);
-    void post_message(const buffer_c16_t& data);
+    void write_stereo(const buffer_s16_t& mid, const buffer_s16_t& side);
 };
 
 #endif /*__PROC_WFM_AUDIO_H__*/
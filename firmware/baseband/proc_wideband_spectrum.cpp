@@ -23,6 +23,7 @@
 #include "audio_dma.hpp"
 
 #include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
 
 #include <cstdint>
 #include <cstddef>
@@ -35,6 +36,12 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 
     if (!configured) return;
 
+    // Drop buffers captured before the front end settled on a new frequency.
+    if (!settle.feed(buffer, shared_memory.retune_epoch)) {
+        phase = 0;
+        return;
+    }
+
     if (phase == 0) {
         std::fill(spectrum.begin(), spectrum.end(), 0);
     }
@@ -89,6 +96,8 @@ void WidebandSpectrum::on_message(const Message* const msg) {
     switch (msg->id) {
         case Message::ID::UpdateSpectrum:
         case Message::ID::SpectrumStreamingConfig:
+        case Message::ID::WaterfallPalette:
+        case Message::ID::SpectrumDetectorConfig:
             channel_spectrum.on_message(msg);
             break;
 
@@ -27,6 +27,7 @@
 #include "rssi_thread.hpp"
 
 #include "spectrum_collector.hpp"
+#include "retune_settle_detector.hpp"
 
 #include "message.hpp"
 
@@ -47,6 +48,7 @@ class WidebandSpectrum : public BasebandProcessor {
     void on_signal_message(const RequestSignalMessage& message);
 
     SpectrumCollector channel_spectrum{};
+    RetuneSettleDetector settle{};
 
     std::array<complex16_t, 256> spectrum{};
     size_t phase = 0, trigger = 127;
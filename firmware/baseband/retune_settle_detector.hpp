@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RETUNE_SETTLE_DETECTOR_H__
+#define __RETUNE_SETTLE_DETECTOR_H__
+
+#include <cstdint>
+#include <cstddef>
+
+/* Tracks the retune epoch published by the M0 and decides when samples taken
+ * after a retune are valid. The synthesizer lock status isn't visible from
+ * the M4, so a short guard time covers lock, after which the block power and
+ * DC offset of two consecutive blocks must agree. A maximum settle time
+ * bounds the wait on signals that never look stable. */
+class RetuneSettleDetector {
+   public:
+    /* Returns true if the samples in src were taken after the front end
+     * settled for the given epoch. A new epoch restarts settling. */
+    template <typename Buffer>
+    bool feed(const Buffer& src, const uint32_t current_epoch) {
+        if (current_epoch != epoch_) {
+            epoch_ = current_epoch;
+            settled_ = false;
+            samples_ = 0;
+            have_previous_ = false;
+        }
+
+        if (settled_)
+            return true;
+
+        int32_t sum_i = 0;
+        int32_t sum_q = 0;
+        uint64_t sum_mag_sq = 0;
+        for (size_t n = 0; n < src.count; n++) {
+            const int32_t i = src.p[n].real();
+            const int32_t q = src.p[n].imag();
+            sum_i += i;
+            sum_q += q;
+            sum_mag_sq += static_cast<uint32_t>(i * i) + static_cast<uint32_t>(q * q);
+        }
+
+        if (src.count == 0)
+            return false;
+
+        const Block block{
+            sum_i / static_cast<int32_t>(src.count),
+            sum_q / static_cast<int32_t>(src.count),
+            static_cast<uint32_t>(sum_mag_sq / src.count)};
+
+        samples_ += src.count;
+        const size_t guard_samples = src.sampling_rate / guard_time_divisor;
+        const size_t max_samples = src.sampling_rate / max_time_divisor;
+
+        if (samples_ >= guard_samples) {
+            if ((have_previous_ && is_stable(previous_, block)) || (samples_ >= max_samples)) {
+                settled_ = true;
+            }
+        }
+
+        previous_ = block;
+        have_previous_ = true;
+
+        return settled_;
+    }
+
+    uint32_t epoch() const {
+        return epoch_;
+    }
+
+    bool settled() const {
+        return settled_;
+    }
+
+   private:
+    struct Block {
+        int32_t dc_i;
+        int32_t dc_q;
+        uint32_t power;
+    };
+
+    /* 1ms guard (PLL lock), 5ms upper bound. */
+    static constexpr size_t guard_time_divisor = 1000;
+    static constexpr size_t max_time_divisor = 200;
+
+    uint32_t epoch_{0};
+    size_t samples_{0};
+    Block previous_{0, 0, 0};
+    bool have_previous_{false};
+    bool settled_{false};
+
+    static bool is_stable(const Block& a, const Block& b) {
+        /* Power within ~1dB (25%). */
+        const uint32_t p_max = (a.power > b.power) ? a.power : b.power;
+        const uint32_t p_min = (a.power > b.power) ? b.power : a.power;
+        if ((p_max - p_min) > (p_max / 4))
+            return false;
+
+        /* DC offset drift small compared to the signal amplitude. */
+        const int64_t di = a.dc_i - b.dc_i;
+        const int64_t dq = a.dc_q - b.dc_q;
+        return ((di * di + dq * dq) * 64) <= static_cast<int64_t>(p_max) + 1;
+    }
+};
+
+#endif /*__RETUNE_SETTLE_DETECTOR_H__*/
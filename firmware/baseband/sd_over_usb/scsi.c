@@ -21,6 +21,7 @@
  */
 
 #include "scsi.h"
+#include "scsi_transfer.h"
 #include "diskio.h"
 #include <libopencm3/lpc43xx/scu.h>
 #include <libopencm3/lpc43xx/rgu.h>
@@ -35,34 +36,43 @@ void usb_bulk_block_cb(void* user_data, unsigned int bytes_transferred) {
     (void)bytes_transferred;
 }
 
-void usb_send_bulk(void* const data, const uint32_t maximum_length) {
+void usb_send_bulk_async(void* const data, const uint32_t length) {
     usb_bulk_block_done = false;
 
     usb_transfer_schedule_block(
         &usb_endpoint_bulk_in,
         data,
-        maximum_length,
+        length,
         usb_bulk_block_cb,
         NULL);
-
-    while (!usb_bulk_block_done)
-        ;
 }
 
-void usb_receive_bulk(void* const data, const uint32_t maximum_length) {
+void usb_receive_bulk_async(void* const data, const uint32_t length) {
     usb_bulk_block_done = false;
 
     usb_transfer_schedule_block(
         &usb_endpoint_bulk_out,
         data,
-        maximum_length,
+        length,
         usb_bulk_block_cb,
         NULL);
+}
 
+void usb_bulk_wait(void) {
     while (!usb_bulk_block_done)
         ;
 }
 
+void usb_send_bulk(void* const data, const uint32_t maximum_length) {
+    usb_send_bulk_async(data, maximum_length);
+    usb_bulk_wait();
+}
+
+void usb_receive_bulk(void* const data, const uint32_t maximum_length) {
+    usb_receive_bulk_async(data, maximum_length);
+    usb_bulk_wait();
+}
+
 void usb_send_csw(msd_cbw_t* msd_cbw_data, uint8_t status) {
     msd_csw_t csw = {
         .signature = MSD_CSW_SIGNATURE,
@@ -208,31 +218,28 @@ static data_request_t decode_data_request(const uint8_t* cmd) {
     return req;
 }
 
+/* Each half of the bulk buffer is one SD multi-block command and one USB transfer. */
+#define DATA_HALF_BLOCKS (USB_BULK_BUFFER_SIZE / 2 / SCSI_BLOCK_SIZE)
+
 uint8_t data_read10(msd_cbw_t* msd_cbw_data) {
     data_request_t req = decode_data_request(msd_cbw_data->cmd_data);
 
-    for (size_t block_index = 0; block_index < req.blk_cnt; block_index++) {
-        read_block(req.first_lba + block_index, &usb_bulk_buffer[0], 1 /* n blocks */);
-        usb_send_bulk(&usb_bulk_buffer[0], 512);
-    }
-
-    return 0;
+    return scsi_transfer_read(req.first_lba, req.blk_cnt, &usb_bulk_buffer[0], DATA_HALF_BLOCKS) ? 0 : 1;
 }
 
 uint8_t data_write10(msd_cbw_t* msd_cbw_data) {
     data_request_t req = decode_data_request(msd_cbw_data->cmd_data);
 
-    for (size_t block_index = 0; block_index < req.blk_cnt; block_index++) {
-        usb_receive_bulk(&usb_bulk_buffer[0], 512);
-        write_block(req.first_lba + block_index, &usb_bulk_buffer[0], 1 /* n blocks */);
-    }
-
-    return 0;
+    return scsi_transfer_write(req.first_lba, req.blk_cnt, &usb_bulk_buffer[0], DATA_HALF_BLOCKS) ? 0 : 1;
 }
 
-void scsi_command(msd_cbw_t* msd_cbw_data) {
+void scsi_command(msd_cbw_t* received_cbw) {
     uint8_t status = 1;
 
+    // The CBW was received into the bulk buffer, which the data phase reuses.
+    msd_cbw_t cbw = *received_cbw;
+    msd_cbw_t* msd_cbw_data = &cbw;
+
     switch (msd_cbw_data->cmd_data[0]) {
         case SCSI_CMD_INQUIRY:
             if ((msd_cbw_data->cmd_data[1] & 0b1) && msd_cbw_data->cmd_data[2] == 0x80) {
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "scsi_transfer.h"
+#include "diskio.h"
+
+static uint32_t min_blocks(const uint32_t a, const uint32_t b) {
+    return a < b ? a : b;
+}
+
+bool scsi_transfer_read(uint32_t first_lba, uint32_t block_count, uint8_t* buffer, uint32_t half_blocks) {
+    uint8_t* const halves[2] = {buffer, buffer + half_blocks * SCSI_BLOCK_SIZE};
+    uint32_t half = 0;
+    bool ok = true;
+
+    uint32_t chunk = min_blocks(block_count, half_blocks);
+    if (chunk > 0 && read_block(first_lba, halves[half], chunk))
+        ok = false;
+
+    while (block_count > 0) {
+        usb_send_bulk_async(halves[half], chunk * SCSI_BLOCK_SIZE);
+        first_lba += chunk;
+        block_count -= chunk;
+
+        // Read the next chunk while the current one is sent.
+        const uint32_t next = min_blocks(block_count, half_blocks);
+        if (next > 0 && read_block(first_lba, halves[half ^ 1], next))
+            ok = false;
+
+        usb_bulk_wait();
+        half ^= 1;
+        chunk = next;
+    }
+
+    return ok;
+}
+
+bool scsi_transfer_write(uint32_t first_lba, uint32_t block_count, uint8_t* buffer, uint32_t half_blocks) {
+    uint8_t* const halves[2] = {buffer, buffer + half_blocks * SCSI_BLOCK_SIZE};
+    uint32_t half = 0;
+    bool ok = true;
+
+    uint32_t chunk = min_blocks(block_count, half_blocks);
+    if (chunk > 0) {
+        usb_receive_bulk_async(halves[half], chunk * SCSI_BLOCK_SIZE);
+        usb_bulk_wait();
+    }
+
+    while (block_count > 0) {
+        // Receive the next chunk while the current one is written.
+        const uint32_t next = min_blocks(block_count - chunk, half_blocks);
+        if (next > 0)
+            usb_receive_bulk_async(halves[half ^ 1], next * SCSI_BLOCK_SIZE);
+
+        if (write_block(first_lba, halves[half], chunk))
+            ok = false;
+
+        first_lba += chunk;
+        block_count -= chunk;
+
+        if (next > 0)
+            usb_bulk_wait();
+        half ^= 1;
+        chunk = next;
+    }
+
+    return ok;
+}
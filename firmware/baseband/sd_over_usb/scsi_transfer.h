@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SCSI_TRANSFER_H__
+#define __SCSI_TRANSFER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCSI_BLOCK_SIZE 512
+
+/* Bulk transfers used by the data phase, implemented in scsi.c.
+ * A transfer runs in the background until usb_bulk_wait() returns,
+ * only one transfer is in flight at a time. */
+void usb_send_bulk_async(void* const data, const uint32_t length);
+void usb_receive_bulk_async(void* const data, const uint32_t length);
+void usb_bulk_wait(void);
+
+/* READ(10)/WRITE(10) data phases. The buffer is split in two halves of
+ * half_blocks blocks each: the SD card fills (or drains) one half with a
+ * multi-block command while the USB controller DMAs the other.
+ * Returns false if an SD command failed, the data phase is still
+ * completed so the host stays in sync. */
+bool scsi_transfer_read(uint32_t first_lba, uint32_t block_count, uint8_t* buffer, uint32_t half_blocks);
+bool scsi_transfer_write(uint32_t first_lba, uint32_t block_count, uint8_t* buffer, uint32_t half_blocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCSI_TRANSFER_H__ */
@@ -22,6 +22,7 @@
 #include "spectrum_collector.hpp"
 
 #include "dsp_fft.hpp"
+#include "dsp_spectrum.hpp"
 
 #include "utility.hpp"
 #include "event_m4.hpp"
@@ -39,6 +40,14 @@ void SpectrumCollector::on_message(const Message* const message) {
             set_state(*reinterpret_cast<const SpectrumStreamingConfigMessage*>(message));
             break;
 
+        case Message::ID::SpectrumDetectorConfig:
+            detector.configure(*reinterpret_cast<const SpectrumDetectorConfigMessage*>(message));
+            break;
+
+        case Message::ID::WaterfallPalette:
+            set_palette(*reinterpret_cast<const WaterfallPaletteMessage*>(message));
+            break;
+
         default:
             break;
     }
@@ -61,6 +70,23 @@ void SpectrumCollector::start() {
 void SpectrumCollector::stop() {
     streaming = false;
     fifo.reset_in();
+    if (rows)
+        rows->fifo.reset_in();
+}
+
+void SpectrumCollector::set_palette(const WaterfallPaletteMessage& message) {
+    if (!message.lut) {
+        rows.reset();
+        return;
+    }
+
+    if (!rows)
+        rows = std::make_unique<WaterfallRows>();
+    std::copy(message.lut, message.lut + rows->palette.size(), rows->palette.begin());
+    rows->fifo.reset();
+
+    WaterfallRowsConfigMessage config{&rows->fifo, message.tag};
+    shared_memory.application_queue.push(config);
 }
 
 void SpectrumCollector::set_decimation_factor(
@@ -93,7 +119,8 @@ void SpectrumCollector::feed(
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
     // Called from baseband processing thread.
     if (streaming && !channel_spectrum_request_update) {
-        fft_swap(data, channel_spectrum);
+        // Windowed here in Q15 rather than convolving the bins afterwards.
+        dsp::spectrum::fft_swap_hamming(data, channel_spectrum);
         channel_spectrum_sampling_rate = data.sampling_rate;
         channel_spectrum_request_update = true;
         EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
@@ -140,15 +167,31 @@ void SpectrumCollector::update() {
         spectrum.channel_filter_high_frequency = channel_filter_high_frequency;
         spectrum.channel_filter_transition = channel_filter_transition;
         for (size_t i = 0; i < spectrum.db.size(); i++) {
-            const auto corrected_sample = spectrum_window_hamming_3(channel_spectrum, i);
-            const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-            const float db = mag2_to_dbv_norm(mag2);
-            constexpr float mag_scale = 5.0f;
-            const unsigned int v = (db * mag_scale) + 255.0f;
-            spectrum.db[i] = std::max(0U, std::min(255U, v));
+            spectrum.db[i] = dsp::spectrum::mag2_to_db_8bit(magnitude_squared(channel_spectrum[i]));
         }
+        if (detector.enabled())
+            detector.execute(spectrum);
         fifo.in(spectrum);
+        if (rows)
+            push_row(spectrum);
     }
 
     channel_spectrum_request_update = false;
 }
+
+/* Colors a waterfall line here so the application only has to blit it.
+ * When the ring is full the line is dropped, as with the spectrum FIFO. */
+void SpectrumCollector::push_row(const ChannelSpectrum& spectrum) {
+    auto row = rows->fifo.in_slot();
+    if (!row)
+        return;
+
+    // Negative frequencies on the left, as the FFT output is unshifted.
+    constexpr size_t half = WaterfallRow::width / 2;
+    for (size_t i = 0; i < WaterfallRow::width; i++) {
+        const auto bin = spectrum.db[(i < half) ? (spectrum.db.size() - half + i) : (i - half)];
+        row->bins[i] = bin;
+        row->pixels[i] = rows->palette[bin];
+    }
+    rows->fifo.commit_in();
+}
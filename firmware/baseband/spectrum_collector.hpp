@@ -29,9 +29,11 @@
 #include "complex.hpp"
 
 #include "block_decimator.hpp"
+#include "cfar_detector.hpp"
 
 #include <cstdint>
 #include <array>
+#include <memory>
 
 #include "message.hpp"
 
@@ -48,9 +50,18 @@ class SpectrumCollector {
         const int32_t filter_transition);
 
    private:
+    /* Only allocated once the application asks for colored rows. */
+    struct WaterfallRows {
+        std::array<uint16_t, WaterfallPaletteMessage::size> palette{};
+        WaterfallRow data[1 << WaterfallRowsConfigMessage::fifo_k]{};
+        WaterfallRowFIFO fifo{data, WaterfallRowsConfigMessage::fifo_k};
+    };
+
     BlockDecimator<complex16_t, 256> channel_spectrum_decimator{1};
     ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k]{};
     ChannelSpectrumFIFO fifo{fifo_data, ChannelSpectrumConfigMessage::fifo_k};
+    CFARDetector detector{};
+    std::unique_ptr<WaterfallRows> rows{};
 
     volatile bool channel_spectrum_request_update{false};
     bool streaming{false};
@@ -66,6 +77,9 @@ class SpectrumCollector {
     void start();
     void stop();
 
+    void set_palette(const WaterfallPaletteMessage& message);
+    void push_row(const ChannelSpectrum& spectrum);
+
     void update();
 };
 
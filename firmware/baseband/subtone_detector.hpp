@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SUBTONE_DETECTOR_H__
+#define __SUBTONE_DETECTOR_H__
+
+#include "message.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace subtone {
+
+/* Standard CTCSS tones in 0.01 Hz, the 50 numbered tones of tone_key.cpp. */
+constexpr std::array<uint16_t, 50> ctcss_tones{
+    6700, 6930, 7190, 7440, 7700, 7970, 8250, 8540, 8850, 9150,
+    9480, 9740, 10000, 10350, 10720, 11090, 11480, 11880, 12300, 12730,
+    13180, 13650, 14130, 14620, 15140, 15670, 15980, 16220, 16550, 16790,
+    17130, 17380, 17730, 17990, 18350, 18620, 18990, 19280, 19660, 19950,
+    20350, 20650, 21070, 21810, 22570, 22910, 23360, 24180, 25030, 25410};
+
+/* Standard DCS codes. */
+constexpr std::array<uint16_t, 104> dcs_codes{
+    0023, 0025, 0026, 0031, 0032, 0036, 0043, 0047, 0051, 0053, 0054, 0065, 0071,
+    0072, 0073, 0074, 0114, 0115, 0116, 0122, 0125, 0131, 0132, 0134, 0143, 0145,
+    0152, 0155, 0156, 0162, 0165, 0172, 0174, 0205, 0212, 0223, 0225, 0226, 0243,
+    0244, 0245, 0246, 0251, 0252, 0255, 0261, 0263, 0265, 0266, 0271, 0274, 0306,
+    0311, 0315, 0325, 0331, 0332, 0343, 0346, 0351, 0356, 0364, 0365, 0371, 0411,
+    0412, 0413, 0423, 0431, 0432, 0445, 0446, 0452, 0454, 0455, 0462, 0464, 0465,
+    0466, 0503, 0506, 0516, 0523, 0526, 0532, 0546, 0565, 0606, 0612, 0624, 0627,
+    0631, 0632, 0654, 0662, 0664, 0703, 0712, 0723, 0731, 0732, 0734, 0743, 0754
+};
+
+/* A DCS word is a (23,12) Golay codeword sent LSB first at 134.4 bps and
+ * repeated for as long as the carrier is up: 9 code bits, the fixed bits
+ * "100" and 11 parity bits. */
+constexpr uint32_t dcs_generator = 0xc75;
+constexpr uint32_t dcs_word_mask = 0x7fffff;
+constexpr float dcs_bit_rate = 134.4f;
+
+/* Remainder of the word divided by the generator, zero for codewords. */
+constexpr uint32_t dcs_syndrome(uint32_t word) {
+    for (int bit = 22; bit >= 11; bit--) {
+        if (word & (1u << bit))
+            word ^= dcs_generator << (bit - 11);
+    }
+    return word;
+}
+
+constexpr uint32_t dcs_encode(const uint32_t code) {
+    const uint32_t data = 0x800 | (code & 0x1ff);
+    return data | (dcs_syndrome(data << 11) << 12);
+}
+
+/* Goertzel filters for all CTCSS tones, run over one block of samples. */
+class CTCSSBank {
+   public:
+    void configure(const float sample_rate) {
+        for (size_t k = 0; k < ctcss_tones.size(); k++)
+            coefficient[k] = 2.0f * std::cos(2.0f * pi * (ctcss_tones[k] / 100.0f) / sample_rate);
+        reset();
+    }
+
+    void reset() {
+        s1.fill(0);
+        s2.fill(0);
+        energy = 0;
+        count = 0;
+    }
+
+    void feed(const float x) {
+        for (size_t k = 0; k < ctcss_tones.size(); k++) {
+            const float s0 = x + coefficient[k] * s1[k] - s2[k];
+            s2[k] = s1[k];
+            s1[k] = s0;
+        }
+        energy += x * x;
+        count++;
+    }
+
+    size_t samples() const {
+        return count;
+    }
+
+    /* Index of the tone dominating the block, or -1. A pure tone of amplitude
+     * A gives a power of (A N / 2)^2 against a block energy of A^2 N / 2, so
+     * the purity is close to 1 for a clean tone and about 2 / N for noise. */
+    int32_t decide() const {
+        if (energy <= min_energy || count == 0)
+            return -1;
+
+        size_t best = 0;
+        float best_power = 0;
+        float second_power = 0;
+        for (size_t k = 0; k < ctcss_tones.size(); k++) {
+            const float power = s1[k] * s1[k] + s2[k] * s2[k] - coefficient[k] * s1[k] * s2[k];
+            if (power > best_power) {
+                second_power = best_power;
+                best_power = power;
+                best = k;
+            } else if (power > second_power) {
+                second_power = power;
+            }
+        }
+
+        const float purity = best_power / (energy * count / 2);
+        if (purity < min_purity || best_power < second_power * min_ratio)
+            return -1;
+
+        return best;
+    }
+
+   private:
+    static constexpr float pi = 3.14159265358979f;
+    static constexpr float min_energy = 1e-6f;
+    static constexpr float min_purity = 0.2f;
+    static constexpr float min_ratio = 4.0f;
+
+    std::array<float, ctcss_tones.size()> coefficient{};
+    std::array<float, ctcss_tones.size()> s1{};
+    std::array<float, ctcss_tones.size()> s2{};
+    float energy{0};
+    size_t count{0};
+};
+
+/* Two Goertzel banks over overlapping blocks, so a decision on a full block
+ * comes every half block. A tone is confirmed after agreeing decisions and
+ * dropped after several decisions without it. */
+class CTCSSDetector {
+   public:
+    static constexpr size_t confirm_decisions = 2;
+    static constexpr size_t loss_decisions = 3;
+
+    void configure(const float sample_rate, const size_t block_length) {
+        block = block_length;
+        for (auto& bank : banks)
+            bank.configure(sample_rate);
+        started = false;
+        confirmed_ = -1;
+        candidate = -1;
+        candidate_count = 0;
+        misses = 0;
+    }
+
+    /* Returns true when a decision was made on this sample. */
+    bool feed(const float x) {
+        banks[0].feed(x);
+        if (started)
+            banks[1].feed(x);
+        else if (banks[0].samples() == block / 2)
+            started = true;
+
+        for (auto& bank : banks) {
+            if (bank.samples() == block) {
+                decide(bank.decide());
+                bank.reset();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Index into ctcss_tones of the confirmed tone, or -1. */
+    int32_t confirmed() const {
+        return confirmed_;
+    }
+
+   private:
+    std::array<CTCSSBank, 2> banks{};
+    size_t block{0};
+    bool started{false};
+    int32_t confirmed_{-1};
+    int32_t candidate{-1};
+    size_t candidate_count{0};
+    size_t misses{0};
+
+    void decide(const int32_t tone) {
+        if (tone == candidate) {
+            candidate_count++;
+        } else {
+            candidate = tone;
+            candidate_count = 1;
+        }
+
+        if (tone >= 0 && tone == confirmed_) {
+            misses = 0;
+        } else if (candidate >= 0 && candidate_count >= confirm_decisions) {
+            confirmed_ = candidate;
+            misses = 0;
+        } else if (confirmed_ >= 0 && ++misses >= loss_decisions) {
+            confirmed_ = -1;
+        }
+    }
+};
+
+/* Slices the audio into bits with a simple transition-tracking bit clock and
+ * checks every 23 bit window for a DCS codeword. Since the word repeats,
+ * every window of a steady code is a rotation of it; the code is named after
+ * the lowest standard code among the rotations, so the result doesn't depend
+ * on where reception started. The complement of every standard word is a
+ * rotation of another standard word (023 inverted is 047), so inverted codes
+ * are reported under that name. */
+class DCSDetector {
+   public:
+    static constexpr size_t confirm_bits = 23;
+    static constexpr size_t loss_bits = 46;
+
+    void configure(const float sample_rate) {
+        bit_step = dcs_bit_rate / sample_rate;
+        phase = 0;
+        level = false;
+        word = 0;
+        bits = 0;
+        last_match = -1;
+        run = 0;
+        confirmed_ = -1;
+        since_confirmed = 0;
+    }
+
+    void feed(const float x) {
+        const bool new_level = x > 0;
+        if (new_level != level) {
+            // Pull the clock so transitions fall on bit boundaries.
+            const float error = (phase < 0.5f) ? phase : phase - 1.0f;
+            phase -= error * clock_gain;
+            if (phase < 0)
+                phase += 1.0f;
+            level = new_level;
+        }
+
+        const float previous = phase;
+        phase += bit_step;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
+        if (previous < 0.5f && phase >= 0.5f)
+            on_bit(level);
+    }
+
+    /* Confirmed code, or -1. */
+    int32_t confirmed() const {
+        return confirmed_;
+    }
+
+    /* Standard code contained in the window, or -1. */
+    static int32_t match(const uint32_t window) {
+        if (dcs_syndrome(window) != 0)
+            return -1;
+
+        int32_t lowest = -1;
+        uint32_t r = window;
+        for (size_t n = 0; n < 23; n++) {
+            const uint32_t code = r & 0x1ff;
+            if (((r >> 9) & 7) == 4 && is_standard(code) && (lowest < 0 || code < uint32_t(lowest)))
+                lowest = code;
+            r = ((r >> 1) | (r << 22)) & dcs_word_mask;
+        }
+        return lowest;
+    }
+
+   private:
+    static constexpr float clock_gain = 0.5f;
+
+    float bit_step{0};
+    float phase{0};
+    bool level{false};
+    uint32_t word{0};
+    size_t bits{0};
+    int32_t last_match{-1};
+    size_t run{0};
+    int32_t confirmed_{-1};
+    size_t since_confirmed{0};
+
+    static bool is_standard(const uint32_t code) {
+        for (const auto c : dcs_codes) {
+            if (c == code)
+                return true;
+        }
+        return false;
+    }
+
+    void on_bit(const bool bit) {
+        word = (word >> 1) | (bit ? (1u << 22) : 0);
+        if (bits < 23) {
+            bits++;
+            return;
+        }
+
+        const auto code = match(word);
+        if (code >= 0 && code == last_match) {
+            run++;
+        } else {
+            last_match = code;
+            run = 1;
+        }
+
+        if (code >= 0 && code == confirmed_) {
+            since_confirmed = 0;
+        } else if (code >= 0 && run >= confirm_bits) {
+            confirmed_ = code;
+            since_confirmed = 0;
+        } else if (confirmed_ >= 0 && ++since_confirmed >= loss_bits) {
+            confirmed_ = -1;
+        }
+    }
+};
+
+/* CTCSS and DCS detection on demodulated NFM audio that has been low pass
+ * filtered to the sub-tone band and decimated to sample_rate. Only confident
+ * changes are reported. */
+class SubToneDetector {
+   public:
+    static constexpr uint32_t sample_rate = 1500;
+    static constexpr size_t ctcss_block_length = sample_rate / 2;
+
+    SubToneDetector() {
+        ctcss.configure(sample_rate, ctcss_block_length);
+        dcs.configure(sample_rate);
+    }
+
+    /* Returns true when report() changed. */
+    bool execute(const float sample) {
+        dc += (sample - dc) * dc_alpha;
+        const float x = sample - dc;
+
+        ctcss.feed(x);
+        dcs.feed(x);
+
+        auto type = CodedSquelchMessage::Type::None;
+        uint32_t value = 0;
+        if (dcs.confirmed() >= 0) {
+            type = CodedSquelchMessage::Type::DCS;
+            value = dcs.confirmed();
+        } else if (ctcss.confirmed() >= 0) {
+            type = CodedSquelchMessage::Type::CTCSS;
+            value = ctcss_tones[ctcss.confirmed()];
+        }
+
+        if (type == type_ && value == value_)
+            return false;
+
+        type_ = type;
+        value_ = value;
+        return true;
+    }
+
+    CodedSquelchMessage report() const {
+        return {type_, value_};
+    }
+
+   private:
+    /* Slow DC tracker; FM demodulation leaves the carrier offset as DC. */
+    static constexpr float dc_alpha = 0.004f;
+
+    CTCSSDetector ctcss{};
+    DCSDetector dcs{};
+    float dc{0};
+    CodedSquelchMessage::Type type_{CodedSquelchMessage::Type::None};
+    uint32_t value_{0};
+};
+
+} /* namespace subtone */
+
+#endif /*__SUBTONE_DETECTOR_H__*/
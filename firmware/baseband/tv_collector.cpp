@@ -22,22 +22,10 @@
 
 #include "tv_collector.hpp"
 
-#include "dsp_fft.hpp"
-
-#include "utility.hpp"
-#include "event_m4.hpp"
 #include "portapack_shared_memory.hpp"
 
-#include "event_m4.hpp"
-
-#include <algorithm>
-
 void TvCollector::on_message(const Message* const message) {
     switch (message->id) {
-        case Message::ID::UpdateSpectrum:
-            update();
-            break;
-
         case Message::ID::SpectrumStreamingConfig:
             set_state(*reinterpret_cast<const SpectrumStreamingConfigMessage*>(message));
             break;
@@ -57,7 +45,7 @@ void TvCollector::set_state(const SpectrumStreamingConfigMessage& message) {
 
 void TvCollector::start() {
     streaming = true;
-    ChannelSpectrumConfigMessage message{&fifo};
+    TvLinesConfigMessage message{&fifo};
     shared_memory.application_queue.push(message);
 }
 
@@ -66,51 +54,31 @@ void TvCollector::stop() {
     fifo.reset_in();
 }
 
-void TvCollector::set_decimation_factor(
-    const size_t decimation_factor) {
-    channel_spectrum_decimator.set_factor(decimation_factor);
+void TvCollector::feed(const buffer_c8_t& buffer) {
+    // Called from baseband processing thread. Sync runs even while not
+    // streaming, so the picture is locked as soon as it is shown.
+    sync.feed(buffer, [this](const size_t row) {
+        if (streaming)
+            this->on_row(row);
+    });
 }
 
-/* TODO: Refactor to register task with idle thread?
- * It's sad that the idle thread has to call all the way back here just to
- * perform the deferred task on the buffer of data we prepared.
- */
-
-void TvCollector::feed(
-    const buffer_c16_t& channel) {
-    // Called from baseband processing thread.
-    channel_spectrum_decimator.feed(channel, [this](const buffer_c16_t& data) { this->post_message(data); });
-}
-
-void TvCollector::post_message(const buffer_c16_t& data) {
-    // Called from baseband processing thread.
-    float re, im;
-    float mag;
-    if (streaming && !channel_spectrum_request_update) {
-        for (size_t i = 0; i < 256; i++) {
-            re = (float)(data.p[i].real());
-            im = (float)(data.p[i].imag());
-            mag = __builtin_sqrtf((re * re) + (im * im));
-            channel_spectrum[i] = {mag, mag};
-        }
-        channel_spectrum_sampling_rate = data.sampling_rate;
-        channel_spectrum_request_update = true;
-        EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+void TvCollector::on_row(const size_t row) {
+    auto line = fifo.in_slot();
+    if (!line)
+        return;
+
+    TvLineSync::Line gray;
+    sync.render(gray);
+    line->y = row;
+    for (size_t x = 0; x < gray.size(); x++) {
+        const uint16_t g = gray[x];
+        line->pixels[x] = ((g >> 3) << 11) | ((g >> 2) << 5) | (g >> 3);
     }
-}
+    fifo.commit_in();
 
-void TvCollector::update() {
-    // Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
-    if (streaming && channel_spectrum_request_update) {
-        ChannelSpectrum spectrum;
-        spectrum.sampling_rate = channel_spectrum_sampling_rate;
-        for (size_t i = 0; i < spectrum.db.size(); i++) {
-            const auto corrected_sample = channel_spectrum[i].real();
-            const unsigned int v = corrected_sample + 127.0f;
-            spectrum.db[i] = std::max(0U, std::min(255U, v));
-        }
-        fifo.in(spectrum);
+    if (streaming && (fifo.len() == ready_lines)) {
+        TvLinesReadyMessage message{};
+        shared_memory.application_queue.push(message);
     }
-
-    channel_spectrum_request_update = false;
 }
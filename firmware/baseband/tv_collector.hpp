@@ -24,41 +24,37 @@
 #define __TV_COLLECTOR_H__
 
 #include "dsp_types.hpp"
-#include "complex.hpp"
-
-#include "block_decimator.hpp"
+#include "tv_line_sync.hpp"
 
 #include <cstdint>
 #include <array>
 
 #include "message.hpp"
 
+/* Hands the application ready to draw picture lines. The ring holds
+ * about 2 ms of lines, so the application is woken when it is half
+ * full rather than waiting for the next frame sync. While it is full
+ * lines are skipped, and each one carries its row, so the picture
+ * stays in place and is just refreshed less often. */
 class TvCollector {
    public:
     void on_message(const Message* const message);
 
-    void set_decimation_factor(const size_t decimation_factor);
-
-    void feed(
-        const buffer_c16_t& channel);
+    void feed(const buffer_c8_t& buffer);
 
    private:
-    BlockDecimator<complex16_t, 256> channel_spectrum_decimator{1};
-    ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k]{};
-    ChannelSpectrumFIFO fifo{fifo_data, ChannelSpectrumConfigMessage::fifo_k};
+    TvLineSync sync{};
+    TvLine fifo_data[1 << TvLinesConfigMessage::fifo_k]{};
+    TvLineFIFO fifo{fifo_data, TvLinesConfigMessage::fifo_k};
+    static constexpr size_t ready_lines = (1 << TvLinesConfigMessage::fifo_k) / 2;
 
-    volatile bool channel_spectrum_request_update{false};
     bool streaming{false};
-    std::array<std::complex<float>, 256> channel_spectrum{};
-    uint32_t channel_spectrum_sampling_rate{0};
-
-    void post_message(const buffer_c16_t& data);
 
     void set_state(const SpectrumStreamingConfigMessage& message);
     void start();
     void stop();
 
-    void update();
+    void on_row(const size_t row);
 };
 
 #endif /*__TV_COLLECTOR_H__*/
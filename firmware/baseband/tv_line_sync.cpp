@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "tv_line_sync.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+/* Alpha max plus beta min, close enough to |x| for a picture. */
+uint8_t TvLineSync::envelope(const complex8_t sample) {
+    const int32_t i = std::abs(sample.real());
+    const int32_t q = std::abs(sample.imag());
+    const auto hi = std::max(i, q);
+    const auto lo = std::min(i, q);
+    return std::min<int32_t>(hi + ((lo * 3) >> 3), 255);
+}
+
+bool TvLineSync::execute(const uint8_t level) {
+    if ((pos >= 0) && (pos < static_cast<int32_t>(samples.size())))
+        samples[pos] = level;
+    line_peak = std::max<int32_t>(line_peak, level);
+
+    if (level > threshold) {
+        if (!in_pulse) {
+            in_pulse = true;
+            pulse_width = 0;
+            pulse_start = pos;
+        }
+        pulse_width++;
+    } else if (in_pulse) {
+        in_pulse = false;
+        on_pulse_end();
+    }
+
+    pos++;
+    if (pos < line_length)
+        return false;
+    pos -= line_length;
+    return on_line_end();
+}
+
+void TvLineSync::on_pulse_end() {
+    if (pulse_width >= broad_min) {
+        // First broad pulse of the vertical interval.
+        if (lines_since_field >= min_field_lines) {
+            v_lock = std::min(v_lock + 1, lock_max);
+            field_line = 0;
+            lines_since_field = 0;
+        }
+        return;
+    }
+
+    if ((pulse_width < hsync_min) || (pulse_width > hsync_max))
+        return;
+
+    // Where the leading edge fell relative to the expected line start.
+    auto error = pulse_start;
+    if (error >= line_length / 2)
+        error -= line_length;
+
+    if (line_locked()) {
+        // Equalizing pulses sit half a line away and are ignored here.
+        if (std::abs(error) > lock_window)
+            return;
+        pos -= error / 4;
+    } else {
+        pos -= error;
+    }
+
+    if (!line_synced) {
+        line_synced = true;
+        h_lock = std::min(h_lock + 1, lock_max);
+    }
+}
+
+bool TvLineSync::on_line_end() {
+    if (!line_synced)
+        h_lock = std::max<int32_t>(h_lock - 1, 0);
+    line_synced = false;
+
+    // Tips and black level follow slowly, so one noisy line does little.
+    int32_t porch = 0;
+    for (size_t i = porch_start; i < porch_end; i++)
+        porch += samples[i];
+    porch /= static_cast<int32_t>(porch_end - porch_start);
+
+    peak += (line_peak - peak) / 8;
+    black += (porch - black) / 8;
+    threshold = (peak + black + 1) / 2;
+    line_peak = 0;
+
+    const auto line = field_line;
+    field_line++;
+    lines_since_field++;
+    if (field_line >= field_lines) {
+        // No vertical sync, keep rolling.
+        field_line = 0;
+        v_lock = std::max<int32_t>(v_lock - 1, 0);
+    }
+
+    if ((line < first_visible_line) || ((line - first_visible_line) & 1))
+        return false;
+    row = (line - first_visible_line) / 2;
+    return row < rows;
+}
+
+void TvLineSync::render(Line& line) const {
+    // White is about an eighth of the black level in negative modulation.
+    const int32_t range = std::max<int32_t>(black - black / 8, 1);
+    const int32_t gain_q8 = (255 << 8) / range;
+
+    constexpr uint32_t step_q16 = (active_length << 16) / width;
+    uint32_t p = active_start << 16;
+    for (size_t x = 0; x < width; x++, p += step_q16) {
+        const auto i = p >> 16;
+        const int32_t f = p & 0xffff;
+        const int32_t a = samples[i];
+        const int32_t b = samples[i + 1];
+        const int32_t v = a + (((b - a) * f) >> 16);
+        line[x] = std::clamp(((black - v) * gain_q8) >> 8, 0, 255);
+    }
+}
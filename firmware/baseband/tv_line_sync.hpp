@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TV_LINE_SYNC_H__
+#define __TV_LINE_SYNC_H__
+
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Line and field sync for negative modulated AM video (PAL timing) sampled
+ * at 2 MHz. Sync tips are the strongest carrier, so pulses are found above
+ * a threshold halfway between the tips and the black level of the back
+ * porch. Horizontal sync pulls a line flywheel that keeps running through
+ * the half-line pulses of the vertical interval and through dropouts; the
+ * first broad pulse of the vertical interval restarts the field.
+ *
+ * Every other line of the visible part of a field is a row; when a row has
+ * been received render() resamples its active part to 240 pixels. */
+class TvLineSync {
+   public:
+    static constexpr uint32_t sampling_rate = 2000000;
+    static constexpr size_t width = 240;
+    static constexpr size_t rows = 144;
+
+    using Line = std::array<uint8_t, width>;
+
+    /* Calls on_row(row) for each row as it is completed. */
+    template <typename F>
+    void feed(const buffer_c8_t& buffer, F on_row) {
+        for (size_t i = 0; i < buffer.count; i++) {
+            if (execute(envelope(buffer.p[i])))
+                on_row(row);
+        }
+    }
+
+    /* The row just completed, white 255. */
+    void render(Line& line) const;
+
+    bool line_locked() const {
+        return h_lock >= lock_threshold;
+    }
+
+    bool field_locked() const {
+        return v_lock > 0;
+    }
+
+   private:
+    static constexpr size_t samples_per_us = sampling_rate / 1000000;
+    static constexpr int32_t line_length = sampling_rate / 15625;  // 64 us
+    static constexpr int32_t hsync_min = 3 * samples_per_us;       // 4.7 us nominal
+    static constexpr int32_t hsync_max = 8 * samples_per_us;
+    static constexpr int32_t broad_min = 20 * samples_per_us;  // 27.3 us nominal
+    static constexpr size_t porch_start = 13 * samples_per_us / 2;
+    static constexpr size_t porch_end = 10 * samples_per_us;
+    static constexpr size_t active_start = 21 * samples_per_us / 2;
+    static constexpr size_t active_length = 52 * samples_per_us;
+    static constexpr int32_t lock_window = line_length / 8;
+    static constexpr int32_t lock_threshold = 4;
+    static constexpr int32_t lock_max = 8;
+    static constexpr size_t field_lines = 313;
+    static constexpr size_t first_visible_line = 22;
+    static constexpr size_t min_field_lines = 200;
+
+    std::array<uint8_t, line_length + line_length / 4> samples{};
+    int32_t pos{0};
+
+    int32_t peak{0};
+    int32_t line_peak{0};
+    int32_t black{0};
+    int32_t threshold{255};
+
+    bool in_pulse{false};
+    int32_t pulse_width{0};
+    int32_t pulse_start{0};
+    bool line_synced{false};
+    int32_t h_lock{0};
+
+    size_t field_line{0};
+    size_t lines_since_field{0};
+    int32_t v_lock{0};
+    size_t row{0};
+
+    static uint8_t envelope(const complex8_t sample);
+
+    /* True when the sample completed a row. */
+    bool execute(const uint8_t level);
+    void on_pulse_end();
+    bool on_line_end();
+};
+
+#endif /*__TV_LINE_SYNC_H__*/
@@ -21,6 +21,8 @@
 
 #include "bmpfile.hpp"
 
+#include <algorithm>
+
 bool BMPFile::is_loaded() {
     return is_opened;
 }
@@ -49,6 +51,7 @@ BMPFile::~BMPFile() {
 // closes file
 void BMPFile::close() {
     is_opened = false;
+    invalidate_cache();
     bmpimage.close();
 }
 
@@ -56,6 +59,7 @@ void BMPFile::close() {
 bool BMPFile::create(const std::filesystem::path& file, uint32_t x, uint32_t y) {
     is_opened = false;
     is_read_ony = true;
+    invalidate_cache();
     bmpimage.close();  // if already open, close before open a new
     if (file_exists(file)) {
         delete_file(file);  // overwrite
@@ -95,6 +99,7 @@ bool BMPFile::create(const std::filesystem::path& file, uint32_t x, uint32_t y)
 bool BMPFile::open(const std::filesystem::path& file, bool readonly) {
     is_opened = false;
     is_read_ony = true;
+    invalidate_cache();
     bmpimage.close();  // if already open, close before open a new
 
     auto result = bmpimage.open(file, readonly, false);
@@ -160,24 +165,121 @@ bool BMPFile::read_next_px(ui::Color& px, bool seek = true) {
     uint8_t buffer[4];
     auto res = bmpimage.read(buffer, byte_per_px);
     if (res.is_error()) return false;
+    px = decode_px(buffer);
+    if (seek) advance_curr_px();
+    return true;
+}
+
+// converts one pixel of file data to a color
+ui::Color BMPFile::decode_px(const uint8_t* p) {
     switch (type) {
         case 0:  // R5G6B5
+            return ui::Color((uint16_t)p[0] | ((uint16_t)p[1] << 8));
         case 3:  // A1R5G5B5
-            if (!type)
-                px = ui::Color((uint16_t)buffer[0] | ((uint16_t)buffer[1] << 8));
-            else
-                px = ui::Color(((uint16_t)buffer[0] & 0x1F) | ((uint16_t)buffer[0] & 0xE0) << 1 | ((uint16_t)buffer[1] & 0x7F) << 9);
-            break;
+            return ui::Color(((uint16_t)p[0] & 0x1F) | ((uint16_t)p[0] & 0xE0) << 1 | ((uint16_t)p[1] & 0x7F) << 9);
         case 1:  // 24
+        case 2:  // 32
         default:
-            px = ui::Color(buffer[2], buffer[1], buffer[0]);
+            return ui::Color(p[2], p[1], p[0]);
+    }
+}
 
-            break;
-        case 2:  // 32
-            px = ui::Color(buffer[2], buffer[1], buffer[0]);
-            break;
+// converts one pixel of file data to 8 bit components, for averaging
+void BMPFile::decode_rgb(const uint8_t* p, uint32_t& r, uint32_t& g, uint32_t& b) {
+    if (byte_per_px == 2) {
+        const uint16_t v = decode_px(p).v;
+        r = (v >> 8) & 0xF8;
+        g = (v >> 3) & 0xFC;
+        b = (v << 3) & 0xF8;
+    } else {
+        r = p[2];
+        g = p[1];
+        b = p[0];
     }
-    if (seek) advance_curr_px();
+}
+
+// file position of the first pixel of a row
+size_t BMPFile::row_pos(uint32_t y) {
+    const uint32_t file_row = is_bottomup() ? get_real_height() - y - 1 : y;
+    return bmp_header.image_data + file_row * byte_per_row;
+}
+
+// returns n bytes of the file at pos, refilling the cache if needed. n must be
+// at most cache_size - sector_size. nullptr on read error or past the end.
+const uint8_t* BMPFile::cached(size_t pos, size_t n) {
+    if (pos >= cache_pos && pos + n <= cache_pos + cache_len)
+        return &cache[pos - cache_pos];
+
+    if (cache.empty()) cache.resize(cache_size);
+
+    // Rows of a bottom up file are read towards the start of the file, so
+    // keep the window ending just after the request rather than starting at it.
+    size_t start;
+    if (is_bottomup()) {
+        const size_t end = (pos + n + sector_size - 1) / sector_size * sector_size;
+        start = (end > cache_size) ? end - cache_size : 0;
+    } else {
+        start = pos / sector_size * sector_size;
+    }
+
+    cache_len = 0;
+    const auto saved_pos = bmpimage.tell();  // keep the per pixel api's position
+    if (bmpimage.seek(start).is_error()) return nullptr;
+    auto res = bmpimage.read(cache.data(), cache_size);
+    bmpimage.seek(saved_pos);
+    if (res.is_error()) return nullptr;
+    cache_pos = start;
+    cache_len = *res;
+
+    if (pos + n > cache_pos + cache_len) return nullptr;
+    return &cache[pos - cache_pos];
+}
+
+// reads one output row: count pixels from row y, starting at column x and taking
+// every step'th pixel (nearest downscaling). box averages each step x step block
+// instead. pixels past the right edge are white. return false on read error
+bool BMPFile::read_row(uint32_t x, uint32_t y, ui::Color* line, uint32_t count, uint32_t step, bool box) {
+    if (!is_opened || y >= get_real_height()) return false;
+    if (step == 0) step = 1;
+    const uint32_t width = bmp_header.width;
+    const size_t stride = step * byte_per_px;
+
+    uint32_t i = 0;
+    while (i < count) {
+        const uint32_t sx = x + i * step;
+        if (sx >= width) break;
+
+        if (box && step > 1) {
+            const uint32_t w = std::min(step, width - sx);
+            const uint32_t h = std::min(step, get_real_height() - y);
+            uint32_t sum_r = 0, sum_g = 0, sum_b = 0;
+            for (uint32_t dy = 0; dy < h; dy++) {
+                const uint8_t* p = cached(row_pos(y + dy) + sx * byte_per_px, w * byte_per_px);
+                if (!p) return false;
+                for (uint32_t dx = 0; dx < w; dx++, p += byte_per_px) {
+                    uint32_t r, g, b;
+                    decode_rgb(p, r, g, b);
+                    sum_r += r;
+                    sum_g += g;
+                    sum_b += b;
+                }
+            }
+            const uint32_t n = w * h;
+            line[i++] = ui::Color(sum_r / n, sum_g / n, sum_b / n);
+            continue;
+        }
+
+        // as many output pixels as fit in one cache window, converted in bulk
+        uint32_t n = std::min(count - i, (width - 1 - sx) / step + 1);
+        n = std::max<uint32_t>(std::min<uint32_t>(n, (cache_size - sector_size) / stride), 1);
+        const uint8_t* p = cached(row_pos(y) + sx * byte_per_px, (n - 1) * stride + byte_per_px);
+        if (!p) return false;
+        for (uint32_t k = 0; k < n; k++, p += stride)
+            line[i++] = decode_px(p);
+    }
+
+    for (; i < count; i++)
+        line[i] = ui::Color::white();
     return true;
 }
 
@@ -221,6 +323,7 @@ bool BMPFile::write_next_px(ui::Color& px) {
             buffer[3] = 255;
             break;
     }
+    invalidate_cache();
     auto res = bmpimage.write(buffer, byte_per_px);
     if (res.is_error()) return false;
     advance_curr_px();
@@ -261,6 +364,7 @@ bool BMPFile::expand_y(uint32_t new_y) {
     uint32_t old_height = get_real_height();
     if (new_y < old_height) return true;  // already bigger
     if (is_read_ony) return false;        // can't expand
+    invalidate_cache();
     uint32_t delta = (new_y - old_height) * byte_per_row;
     bmp_header.size += delta;
     bmp_header.data_size += delta;
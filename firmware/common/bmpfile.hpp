@@ -24,6 +24,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "file.hpp"
 #include "bmp.hpp"
@@ -42,6 +43,7 @@ class BMPFile {
     uint32_t getbpr() { return byte_per_row; };
 
     bool read_next_px(ui::Color& px, bool seek);
+    bool read_row(uint32_t x, uint32_t y, ui::Color* line, uint32_t count, uint32_t step = 1, bool box = false);
     bool write_next_px(ui::Color& px);
     uint32_t get_real_height();
     uint32_t get_width();
@@ -51,6 +53,11 @@ class BMPFile {
 
    private:
     bool advance_curr_px(uint32_t num);
+    size_t row_pos(uint32_t y);
+    const uint8_t* cached(size_t pos, size_t n);
+    ui::Color decode_px(const uint8_t* p);
+    void decode_rgb(const uint8_t* p, uint32_t& r, uint32_t& g, uint32_t& b);
+    void invalidate_cache() { cache_len = 0; };
     bool is_opened = false;
     bool is_read_ony = true;
 
@@ -65,6 +72,14 @@ class BMPFile {
     uint32_t curry = 0;
     ui::Color bg{};
     bool use_bg = false;
+
+    // read_row() reads through this, a sector aligned window of the file. It is
+    // refilled ahead of the read position, in the direction rows are stored.
+    static constexpr size_t cache_size = 2048;
+    static constexpr size_t sector_size = 512;
+    std::vector<uint8_t> cache{};
+    size_t cache_pos = 0;
+    size_t cache_len = 0;
 };
 
 #endif
\ No newline at end of file
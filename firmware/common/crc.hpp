@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <limits>
 #include <array>
+#include <type_traits>
 
 /* Inspired by
  * http://www.barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
@@ -40,6 +41,66 @@
  *
  */
 
+/* Byte-at-a-time lookup tables, generated at compile time. Each table
+ * holds the remainder produced by shifting one byte (MSB first) through
+ * the polynomial division, so a whole byte costs one lookup instead of
+ * eight conditional XORs. With Slices > 1, table k gives the effect of
+ * the same byte followed by k zero bytes, which lets four input bytes be
+ * folded in with independent lookups ("slice-by-4").
+ */
+template <size_t Width>
+struct CRCTableEntry {
+    using type = typename std::conditional<
+        (Width <= 8), uint8_t,
+        typename std::conditional<(Width <= 16), uint16_t, uint32_t>::type>::type;
+};
+
+template <size_t Width, uint32_t Polynomial, size_t Slices = 1>
+struct CRCTable {
+    static_assert(Width >= 8 && Width <= 32, "CRC table width must be 8 to 32 bits");
+
+    using entry_type = typename CRCTableEntry<Width>::type;
+    using table_type = std::array<std::array<entry_type, 256>, Slices>;
+
+    static constexpr uint32_t mask = (static_cast<uint32_t>(2) << (Width - 1)) - 1;
+    static constexpr uint32_t top_bit = static_cast<uint32_t>(1) << (Width - 1);
+
+    static constexpr table_type generate() {
+        table_type table{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t remainder = i << (Width - 8);
+            for (size_t bit = 0; bit < 8; bit++) {
+                remainder = (remainder & top_bit) ? ((remainder << 1) ^ Polynomial) : (remainder << 1);
+            }
+            table[0][i] = static_cast<entry_type>(remainder & mask);
+        }
+        for (size_t slice = 1; slice < Slices; slice++) {
+            for (uint32_t i = 0; i < 256; i++) {
+                const uint32_t previous = table[slice - 1][i];
+                const uint32_t remainder = (previous << 8) ^ table[0][(previous >> (Width - 8)) & 0xff];
+                table[slice][i] = static_cast<entry_type>(remainder & mask);
+            }
+        }
+        return table;
+    }
+
+    static constexpr table_type value = generate();
+};
+
+constexpr std::array<uint8_t, 256> make_crc_reflect_table() {
+    std::array<uint8_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t reflection = 0;
+        for (size_t bit = 0; bit < 8; bit++) {
+            reflection |= ((i >> bit) & 1) << (7 - bit);
+        }
+        table[i] = static_cast<uint8_t>(reflection);
+    }
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 256> crc_reflect_table = make_crc_reflect_table();
+
 template <size_t Width, bool RevIn = false, bool RevOut = false>
 class CRC {
    public:
@@ -52,6 +113,7 @@ class CRC {
         : truncated_polynomial{truncated_polynomial},
           initial_remainder{initial_remainder},
           final_xor_value{final_xor_value},
+          table{lookup_table(truncated_polynomial)},
           remainder{initial_remainder} {
     }
 
@@ -59,6 +121,11 @@ class CRC {
         return initial_remainder;
     }
 
+    /* True when bytes go through a lookup table rather than bit by bit. */
+    bool table_driven() const {
+        return table != nullptr;
+    }
+
     void reset(value_type new_initial_remainder) {
         remainder = new_initial_remainder;
     }
@@ -85,14 +152,40 @@ class CRC {
     }
 
     void process_byte(const uint8_t byte) {
-        process_bits(byte, 8);
+        if (table) {
+            remainder = process_byte_table(remainder & mask(), byte);
+        } else {
+            process_bits(byte, 8);
+        }
     }
 
     void process_bytes(const void* const data, const size_t length) {
-        const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
-        for (size_t i = 0; i < length; i++) {
-            process_byte(p[i]);
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+        if (!table) {
+            for (size_t i = 0; i < length; i++) {
+                process_bits(p[i], 8);
+            }
+            return;
         }
+
+        value_type r = remainder & mask();
+        size_t n = length;
+        if (slices() == 4) {
+            for (; n >= 4; n -= 4, p += 4) {
+                r ^= (static_cast<value_type>(input(p[0])) << 24) |
+                     (static_cast<value_type>(input(p[1])) << 16) |
+                     (static_cast<value_type>(input(p[2])) << 8) |
+                     static_cast<value_type>(input(p[3]));
+                r = table[3 * 256 + (r >> 24)] ^
+                    table[2 * 256 + ((r >> 16) & 0xff)] ^
+                    table[1 * 256 + ((r >> 8) & 0xff)] ^
+                    table[r & 0xff];
+            }
+        }
+        for (; n > 0; n--, p++) {
+            r = process_byte_table(r, *p);
+        }
+        remainder = r;
     }
 
     template <size_t N>
@@ -105,9 +198,12 @@ class CRC {
     }
 
    private:
+    using entry_type = typename CRCTableEntry<Width>::type;
+
     const value_type truncated_polynomial;
     const value_type initial_remainder;
     const value_type final_xor_value;
+    const entry_type* const table;
     value_type remainder;
 
     static constexpr size_t width() {
@@ -119,10 +215,36 @@ class CRC {
     }
 
     static constexpr value_type mask() {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wshift-count-overflow"
-        return (~(~(0UL) << width()));
-#pragma GCC diagnostic pop
+        return (static_cast<value_type>(2) << (width() - 1)) - 1;
+    }
+
+    /* Only slice CRC-32: the three extra 1 KiB tables are not worth it
+     * for the short 8/16-bit packet checksums. */
+    static constexpr size_t slices() {
+        return (Width == 32) ? 4 : 1;
+    }
+
+    /* Tables exist for the polynomials in use in the firmware; anything
+     * else still works, bit by bit. Only the tables a given width can
+     * select are instantiated. */
+    static constexpr const entry_type* lookup_table(const value_type polynomial) {
+        if constexpr (Width == 32) {
+            if (polynomial == 0x04c11db7) return CRCTable<32, 0x04c11db7, 4>::value[0].data();
+        } else if constexpr (Width == 16) {
+            if (polynomial == 0x1021) return CRCTable<16, 0x1021>::value[0].data();
+            if (polynomial == 0x6f63) return CRCTable<16, 0x6f63>::value[0].data();
+        } else if constexpr (Width == 8) {
+            if (polynomial == 0x01) return CRCTable<8, 0x01>::value[0].data();
+        }
+        return nullptr;
+    }
+
+    static uint8_t input(const uint8_t byte) {
+        return RevIn ? crc_reflect_table[byte] : byte;
+    }
+
+    value_type process_byte_table(const value_type r, const uint8_t byte) const {
+        return ((r << 8) ^ table[((r >> (width() - 8)) ^ input(byte)) & 0xff]) & mask();
     }
 
     static value_type reflect(value_type x) {
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CRC_ENGINE_H__
+#define __CRC_ENGINE_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include <hal.h>
+
+/* LPC43xx CRC engine peripheral. The engine implements CRC-CCITT
+ * (0x1021), CRC-16 (0x8005) and CRC-32 (0x04c11db7), MSB first, with
+ * optional bit reversal of input and sum and optional complement of the
+ * sum. CRCEngine mirrors the CRC<> interface for the configurations the
+ * engine can compute, so it can stand in for CRC<> on long buffers.
+ *
+ * The engine is a single shared peripheral: only one CRCEngine may be
+ * in use at a time, and a CRCEngine must not be shared between the two
+ * cores. Construction and reset() reprogram MODE and SEED. Constructing
+ * one for a configuration supports() rejects halts.
+ */
+template <size_t Width, bool RevIn = false, bool RevOut = false>
+class CRCEngine {
+   public:
+    using value_type = uint32_t;
+
+    CRCEngine(
+        const value_type truncated_polynomial,
+        const value_type initial_remainder = 0,
+        const value_type final_xor_value = 0)
+        : initial_remainder{initial_remainder},
+          mode{mode_for(truncated_polynomial, final_xor_value)} {
+        if (!supports(truncated_polynomial, final_xor_value))
+            chDbgPanic("CRCEngine");
+        reset();
+    }
+
+    /* True if the engine can produce this CRC<Width, RevIn, RevOut>. */
+    static constexpr bool supports(
+        const value_type truncated_polynomial,
+        const value_type final_xor_value = 0) {
+        return poly_select(truncated_polynomial) >= 0 &&
+               (final_xor_value == 0 || final_xor_value == mask());
+    }
+
+    void reset(value_type new_initial_remainder) {
+        registers().MODE = mode;
+        registers().SEED = new_initial_remainder;
+    }
+
+    void reset() {
+        reset(initial_remainder);
+    }
+
+    void process_byte(const uint8_t byte) {
+        registers().WR_DATA8 = byte;
+    }
+
+    void process_bytes(const void* const data, const size_t length) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+        size_t n = length;
+
+        for (; n > 0 && (reinterpret_cast<uintptr_t>(p) & 3); n--) {
+            process_byte(*p++);
+        }
+
+        /* The engine shifts words in from bit 31. Bit reversal of a
+         * little-endian word already puts byte 0's LSB first; without it
+         * the bytes must be swapped so byte 0's MSB goes first. */
+        const uint32_t* w = reinterpret_cast<const uint32_t*>(p);
+        for (; n >= 4; n -= 4) {
+            registers().WR_DATA32 = RevIn ? *w++ : __REV(*w++);
+        }
+
+        p = reinterpret_cast<const uint8_t*>(w);
+        for (; n > 0; n--) {
+            process_byte(*p++);
+        }
+    }
+
+    value_type checksum() const {
+        return registers().SUM & mask();
+    }
+
+   private:
+    struct Registers {
+        volatile uint32_t MODE;
+        volatile uint32_t SEED;
+        union {
+            volatile uint32_t SUM;
+            volatile uint32_t WR_DATA32;
+            volatile uint16_t WR_DATA16;
+            volatile uint8_t WR_DATA8;
+        };
+    };
+
+    static constexpr uintptr_t base_address = 0x40087000;
+
+    static constexpr uint32_t mode_bit_rvs_wr = (1U << 2);
+    static constexpr uint32_t mode_bit_rvs_sum = (1U << 4);
+    static constexpr uint32_t mode_cmpl_sum = (1U << 5);
+
+    const value_type initial_remainder;
+    const uint32_t mode;
+
+    static Registers& registers() {
+        return *reinterpret_cast<Registers*>(base_address);
+    }
+
+    static constexpr value_type mask() {
+        return (static_cast<value_type>(2) << (Width - 1)) - 1;
+    }
+
+    static constexpr int poly_select(const value_type truncated_polynomial) {
+        if (Width == 16 && truncated_polynomial == 0x1021) return 0;
+        if (Width == 16 && truncated_polynomial == 0x8005) return 1;
+        if (Width == 32 && truncated_polynomial == 0x04c11db7) return 2;
+        return -1;
+    }
+
+    static constexpr uint32_t mode_for(
+        const value_type truncated_polynomial,
+        const value_type final_xor_value) {
+        return static_cast<uint32_t>(poly_select(truncated_polynomial) & 3) |
+               (RevIn ? mode_bit_rvs_wr : 0) |
+               (RevOut ? mode_bit_rvs_sum : 0) |
+               (final_xor_value ? mode_cmpl_sum : 0);
+    }
+};
+
+#endif /*__CRC_ENGINE_H__*/
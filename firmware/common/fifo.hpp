@@ -123,6 +123,28 @@ class FIFO {
         return len;
     }
 
+    /* In-place access for elements too big to copy through the stack: fill
+     * the slot from in_slot() and publish it with commit_in(); read with
+     * peek() and release with skip_n(). */
+    T* in_slot() {
+        return is_full() ? nullptr : &_data[_in & mask()];
+    }
+
+    void commit_in() {
+        smp_wmb();
+        _in += 1;
+    }
+
+    const T* peek(const size_t index = 0) const {
+        return (index < len()) ? &_data[(_out + index) & mask()] : nullptr;
+    }
+
+    void skip_n(size_t n) {
+        n = std::min(n, len());
+        smp_wmb();
+        _out += n;
+    }
+
     bool skip() {
         if (is_empty()) {
             return false;
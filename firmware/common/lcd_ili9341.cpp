@@ -631,6 +631,23 @@ void ILI9341::draw_pixels(
     io.lcd_write_pixels(colors, count);
 }
 
+void ILI9341::draw_pixels_reference(
+    const ui::Rect r,
+    const ui::Color* const colors,
+    const size_t count) {
+    lcd_start_ram_write(r);
+    io.lcd_write_pixels_reference(colors, count);
+}
+
+void ILI9341::draw_pixel_rows(
+    const ui::Rect r,
+    const ui::Color* const* const rows) {
+    lcd_start_ram_write(r);
+    for (ui::Coord y = 0; y < r.height(); y++) {
+        io.lcd_write_pixels(rows[y], r.width());
+    }
+}
+
 void ILI9341::read_pixels(
     const ui::Rect r,
     ui::ColorRGB888* const colors,
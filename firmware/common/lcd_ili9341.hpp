@@ -154,6 +154,11 @@ class ILI9341 {
     ui::Rect screen_rect() { return {0, 0, width(), height()}; }
 
     void draw_pixels(const ui::Rect r, const ui::Color* const colors, const size_t count);
+    /* draw_pixels through the write loop it used before unrolling (lcdbench). */
+    void draw_pixels_reference(const ui::Rect r, const ui::Color* const colors, const size_t count);
+    /* Writes r.height() separate rows of r.width() pixels through a single
+     * RAM write window. */
+    void draw_pixel_rows(const ui::Rect r, const ui::Color* const* const rows);
     void read_pixels(const ui::Rect r, ui::ColorRGB888* const colors, const size_t count);
 
    private:
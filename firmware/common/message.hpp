@@ -135,6 +135,15 @@ class Message {
         NoaaAptRxStatusData = 78,
         NoaaAptRxImageData = 79,
         FSKPacket = 80,
+        SpectrumDetectorConfig = 81,
+        WarmRestart = 82,
+        RDSGroup = 83,
+        StereoPilot = 84,
+        WaterfallPalette = 85,
+        WaterfallRowsConfig = 86,
+        AudioTapConfig = 87,
+        TvLinesConfig = 88,
+        TvLinesReady = 89,
         MAX
     };
 
@@ -186,12 +195,18 @@ class BasebandStatisticsMessage : public Message {
 struct ChannelStatistics {
     int32_t max_db;
     size_t count;
+    uint32_t retune_epoch;  // shared_memory.retune_epoch the samples were taken in
+    bool settled;           // true once the front end settled after that retune
 
     constexpr ChannelStatistics(
         int32_t max_db = -120,
-        size_t count = 0)
+        size_t count = 0,
+        uint32_t retune_epoch = 0,
+        bool settled = false)
         : max_db{max_db},
-          count{count} {
+          count{count},
+          retune_epoch{retune_epoch},
+          settled{settled} {
     }
 };
 
@@ -275,6 +290,29 @@ class SpectrumStreamingConfigMessage : public Message {
     Mode mode{Mode::Stopped};
 };
 
+class SpectrumDetectorConfigMessage : public Message {
+   public:
+    constexpr SpectrumDetectorConfigMessage(
+        uint8_t threshold,
+        uint8_t guard_bins,
+        uint8_t training_bins,
+        uint8_t edge_bins,
+        uint8_t dc_bins)
+        : Message{ID::SpectrumDetectorConfig},
+          threshold{threshold},
+          guard_bins{guard_bins},
+          training_bins{training_bins},
+          edge_bins{edge_bins},
+          dc_bins{dc_bins} {
+    }
+
+    uint8_t threshold;      // Above local noise, 0 disables the detector
+    uint8_t guard_bins;     // Each side of the cell under test
+    uint8_t training_bins;  // Each side, beyond the guard bins
+    uint8_t edge_bins;      // Ignored at each edge of the slice
+    uint8_t dc_bins;        // Ignored each side of the center (DC spike)
+};
+
 class WidebandSpectrumConfigMessage : public Message {
    public:
     constexpr WidebandSpectrumConfigMessage(
@@ -305,12 +343,37 @@ class AudioSpectrumMessage : public Message {
     AudioSpectrum* data{nullptr};
 };
 
+/* Turns the AudioSpectrum frames of the baseband on or off, for basebands
+ * where nobody is looking at them by default. */
+class AudioTapConfigMessage : public Message {
+   public:
+    constexpr AudioTapConfigMessage(
+        const bool enabled)
+        : Message{ID::AudioTapConfig},
+          enabled{enabled} {
+    }
+
+    bool enabled;
+};
+
+struct SpectrumDetection {
+    uint8_t bin;    // Peak bin in frequency order, 128 is the center frequency
+    uint8_t width;  // In bins
+    uint8_t power;  // Peak, same scale as ChannelSpectrum::db
+    uint8_t snr;    // Peak above the local noise estimate
+};
+
 struct ChannelSpectrum {
     std::array<uint8_t, 256> db{{0}};
     uint32_t sampling_rate{0};
     int32_t channel_filter_low_frequency{0};
     int32_t channel_filter_high_frequency{0};
     int32_t channel_filter_transition{0};
+
+    // Filled in when the spectrum detector is enabled.
+    uint8_t noise_floor{0};
+    uint8_t detection_count{0};
+    std::array<SpectrumDetection, 16> detections{};
 };
 
 using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
@@ -328,6 +391,84 @@ class ChannelSpectrumConfigMessage : public Message {
     ChannelSpectrumFIFO* fifo{nullptr};
 };
 
+/* A waterfall line colored on the M4, bins kept in screen order alongside
+ * the RGB565 pixels for the history. */
+struct WaterfallRow {
+    static constexpr size_t width = 240;
+
+    std::array<uint8_t, width> bins{};
+    std::array<uint16_t, width> pixels{};
+};
+
+using WaterfallRowFIFO = FIFO<WaterfallRow>;
+
+/* A line of the AM TV picture, synced and colored on the M4. */
+struct TvLine {
+    static constexpr size_t width = 240;
+
+    uint16_t y{0};
+    std::array<uint16_t, width> pixels{};
+};
+
+using TvLineFIFO = FIFO<TvLine>;
+
+class TvLinesConfigMessage : public Message {
+   public:
+    static constexpr size_t fifo_k = 4;
+
+    constexpr TvLinesConfigMessage(
+        TvLineFIFO* fifo)
+        : Message{ID::TvLinesConfig},
+          fifo{fifo} {
+    }
+
+    TvLineFIFO* fifo{nullptr};
+};
+
+/* Sent when the line ring fills to half, so lines are drawn between
+ * frame syncs too. */
+class TvLinesReadyMessage : public Message {
+   public:
+    constexpr TvLinesReadyMessage()
+        : Message{ID::TvLinesReady} {
+    }
+};
+
+/* Gradient for coloring waterfall rows; the collector copies it before
+ * returning, nullptr turns the rows off again. */
+class WaterfallPaletteMessage : public Message {
+   public:
+    static constexpr size_t size = 256;
+
+    constexpr WaterfallPaletteMessage(
+        const uint16_t* lut,
+        const uint32_t tag)
+        : Message{ID::WaterfallPalette},
+          lut{lut},
+          tag{tag} {
+    }
+
+    const uint16_t* lut{nullptr};
+    /* Echoed in the WaterfallRowsConfigMessage answering this one. */
+    uint32_t tag{0};
+};
+
+class WaterfallRowsConfigMessage : public Message {
+   public:
+    static constexpr size_t fifo_k = 3;
+
+    constexpr WaterfallRowsConfigMessage(
+        WaterfallRowFIFO* fifo,
+        const uint32_t tag)
+        : Message{ID::WaterfallRowsConfig},
+          fifo{fifo},
+          tag{tag} {
+    }
+
+    WaterfallRowFIFO* fifo{nullptr};
+    uint32_t tag{0};
+};
+
 class AISPacketMessage : public Message {
    public:
     constexpr AISPacketMessage(
@@ -486,17 +627,54 @@ class FSKRxPacketMessage : public Message {
     FskPacketData* packet{nullptr};
 };
 
+/* Sent by the baseband only when the detected sub-tone changes. */
 class CodedSquelchMessage : public Message {
    public:
+    enum class Type : uint32_t {
+        None = 0,   // No sub-tone (any more)
+        CTCSS = 1,  // value: tone frequency in 0.01 Hz
+        DCS = 2,    // value: DCS code, e.g. 023 (octal)
+    };
+
     constexpr CodedSquelchMessage(
-        const uint32_t value)
+        const Type type = Type::None,
+        const uint32_t value = 0)
         : Message{ID::CodedSquelch},
+          type{type},
           value{value} {
     }
 
+    Type type;
     uint32_t value;
 };
 
+/* A received RDS group. Bit n of valid is set when block n passed its
+ * checkword; block C may have been sent with offset C'. */
+class RDSGroupMessage : public Message {
+   public:
+    constexpr RDSGroupMessage(
+        const std::array<uint16_t, 4> blocks = {},
+        const uint8_t valid = 0)
+        : Message{ID::RDSGroup},
+          blocks{blocks},
+          valid{valid} {
+    }
+
+    std::array<uint16_t, 4> blocks;
+    uint8_t valid;
+};
+
+class StereoPilotMessage : public Message {
+   public:
+    constexpr StereoPilotMessage(
+        const bool locked = false)
+        : Message{ID::StereoPilot},
+          locked{locked} {
+    }
+
+    bool locked;
+};
+
 class ShutdownMessage : public Message {
    public:
     constexpr ShutdownMessage()
@@ -504,6 +682,15 @@ class ShutdownMessage : public Message {
     }
 };
 
+/* Restarts the processor of a baseband image that was shut down but left
+ * resident, without unpacking the image or resetting the M4. */
+class WarmRestartMessage : public Message {
+   public:
+    constexpr WarmRestartMessage()
+        : Message{ID::WarmRestart} {
+    }
+};
+
 class ERTPacketMessage : public Message {
    public:
     constexpr ERTPacketMessage(
@@ -758,7 +945,7 @@ struct CaptureConfig {
             return 0;
         } else {
             const size_t percent = baseband_bytes_dropped * 100U / baseband_bytes_received;
-            return std::max(1U, percent);
+            return std::max<size_t>(1U, percent);
         }
     }
 };
@@ -70,6 +70,20 @@ class MessageQueue {
         }
     }
 
+    /* Like handle(), but stops before the next message once keep_going()
+     * returns false. Returns true if the queue was drained. */
+    template <typename HandlerFn, typename ContinueFn>
+    bool handle_while(HandlerFn handler, ContinueFn keep_going) {
+        std::array<uint8_t, Message::MAX_SIZE> message_buffer;
+        while (Message* const message = peek(message_buffer)) {
+            if (!keep_going())
+                return false;
+            handler(message);
+            skip();
+        }
+        return true;
+    }
+
     bool is_empty() const {
         return fifo.is_empty();
     }
@@ -185,21 +185,29 @@ class IO {
         if (dark_cover_enabled) {
             pixel.v = DARKENED_PIXEL(pixel.v, brightness);
         }
-        auto v = pixel.v;
-        n >>= 3;
+        const auto v = pixel.v;
+        lcd_write_data_unrolled8(n, [v]() { return v; });
+    }
+
+    void lcd_write_pixels(const ui::Color* const pixels, size_t n) {
+        if (dark_cover_enabled) {
+            for (size_t i = 0; i < n; i++) {
+                lcd_write_pixel(pixels[i]);
+            }
+            return;
+        }
+
+        auto p = pixels;
+        lcd_write_data_unrolled8(n, [&p]() { return (p++)->v; });
+        n &= 7;
         while (n--) {
-            lcd_write_data(v);
-            lcd_write_data(v);
-            lcd_write_data(v);
-            lcd_write_data(v);
-            lcd_write_data(v);
-            lcd_write_data(v);
-            lcd_write_data(v);
-            lcd_write_data(v);
+            lcd_write_data((p++)->v);
         }
     }
 
-    void lcd_write_pixels(const ui::Color* const pixels, size_t n) {
+    /* The one pixel per pass loop lcd_write_pixels used to be, kept so
+     * lcdbench can time both on the same burst. */
+    void lcd_write_pixels_reference(const ui::Color* const pixels, size_t n) {
         for (size_t i = 0; i < n; i++) {
             lcd_write_pixel(pixels[i]);
         }
@@ -399,6 +407,22 @@ class IO {
         lcd_wr_deassert(); /* Complete write operation */
     }
 
+    /* Writes next() eight times per pass for n / 8 passes; the remainder is left to the caller. */
+    template <typename Next>
+    __attribute__((always_inline)) void lcd_write_data_unrolled8(size_t n, Next next) {
+        n >>= 3;
+        while (n--) {
+            lcd_write_data(next());
+            lcd_write_data(next());
+            lcd_write_data(next());
+            lcd_write_data(next());
+            lcd_write_data(next());
+            lcd_write_data(next());
+            lcd_write_data(next());
+            lcd_write_data(next());
+        }
+    }
+
     uint32_t lcd_read_data() {
         // NOTE: Assumes ADDR=1 from command phase.
         dir_read();
@@ -152,7 +152,7 @@ struct misc_config_t {
     bool config_sdcard_high_speed_io : 1;
     bool config_disable_config_mode : 1;
     bool beep_on_packets : 1;
-    bool UNUSED_6 : 1;
+    bool wav_peak_files : 1;
     bool UNUSED_7 : 1;
 
     uint8_t PLACEHOLDER_1;
@@ -649,6 +649,10 @@ bool config_sdcard_high_speed_io() {
     return data->misc_config.config_sdcard_high_speed_io;
 }
 
+bool config_wav_peak_files() {
+    return data->misc_config.wav_peak_files;
+}
+
 bool stealth_mode() {
     return data->ui_config.stealth_mode;
 }
@@ -730,6 +734,10 @@ void set_beep_on_packets(bool v) {
     data->misc_config.beep_on_packets = v;
 }
 
+void set_config_wav_peak_files(bool v) {
+    data->misc_config.wav_peak_files = v;
+}
+
 void set_config_sdcard_high_speed_io(bool v, bool save) {
     if (v) {
         /* 200MHz / (2 * 2) = 50MHz */
@@ -80,6 +80,10 @@ struct SharedMemory {
     void clear_baseband_ready() { baseband_ready = false; }
     void set_baseband_ready() { baseband_ready = true; }
 
+    // Bumped by the M0 after every retune. Channel statistics are tagged with
+    // it, so apps can tell measurements of the new frequency from stale ones.
+    uint32_t volatile retune_epoch{0};
+
     uint8_t volatile request_m4_performance_counter{0};
     uint8_t volatile m4_performance_counter{0};
     uint16_t volatile m4_stack_usage{0};
@@ -380,7 +380,8 @@ Text::Text(
 }
 
 void Text::set(std::string_view value) {
-    text = std::string{value};
+    // Reuses the storage of the previous text when it is large enough.
+    text.assign(value.data(), value.size());
     set_dirty();
 }
 
@@ -72,6 +72,9 @@ FRESULT f_truncate(FIL*) {
 FRESULT f_unlink(const TCHAR*) {
     return FR_OK;
 }
+FRESULT f_utime(const TCHAR*, const FILINFO*) {
+    return FR_OK;
+}
 FRESULT f_write(FIL*, const void*, UINT, UINT*) {
     return FR_OK;
 }
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "crc.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string check_string = "123456789";
+
+std::vector<uint8_t> test_pattern(size_t length) {
+    std::vector<uint8_t> data(length);
+    uint32_t state = 0x12345678;
+    for (auto& b : data) {
+        state = state * 1664525 + 1013904223;
+        b = static_cast<uint8_t>(state >> 24);
+    }
+    return data;
+}
+
+/* Reference result, fed strictly bit by bit through process_bits. */
+template <typename TCRC>
+uint32_t bitwise_checksum(TCRC crc, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++)
+        crc.process_bits(data[i], 8);
+    return crc.checksum();
+}
+
+template <typename TCRC>
+uint32_t table_checksum(TCRC crc, const uint8_t* data, size_t length) {
+    crc.process_bytes(data, length);
+    return crc.checksum();
+}
+
+template <typename TCRC>
+void check_identical(const TCRC& crc) {
+    const auto data = test_pattern(1031);
+
+    for (size_t length : {0, 1, 3, 4, 5, 7, 8, 64, 1031}) {
+        CAPTURE(length);
+        CHECK_EQ(table_checksum(crc, data.data(), length),
+                 bitwise_checksum(crc, data.data(), length));
+    }
+
+    TCRC bytes{crc};
+    for (size_t i = 0; i < data.size(); i++)
+        bytes.process_byte(data[i]);
+    CHECK_EQ(bytes.checksum(), bitwise_checksum(crc, data.data(), data.size()));
+}
+
+template <typename TCRC>
+uint32_t check_value(TCRC crc) {
+    crc.process_bytes(check_string.data(), check_string.size());
+    return crc.checksum();
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("CRC");
+
+TEST_CASE("Catalogue check values should match.") {
+    CHECK_EQ(check_value(CRC<32>{0x04c11db7, 0xffffffff, 0xffffffff}), 0xfc891918);
+    CHECK_EQ(check_value(CRC<32>{0x04c11db7, 0xffffffff, 0x00000000}), 0x0376e6e7);
+    CHECK_EQ(check_value(CRC<32, true, true>{0x04c11db7, 0xffffffff, 0xffffffff}), 0xcbf43926);
+    CHECK_EQ(check_value(CRC<16>{0x1021, 0xffff, 0x0000}), 0x29b1);
+    CHECK_EQ(check_value(CRC<16>{0x1021, 0x1d0f, 0x0000}), 0xe5cc);
+    CHECK_EQ(check_value(CRC<16, true, true>{0x1021, 0xffff, 0xffff}), 0x906e);
+    CHECK_EQ(check_value(CRC<16, true, true>{0x8005, 0x0000, 0x0000}), 0xbb3d);
+    CHECK_EQ(check_value(CRC<8>{0x07}), 0xf4);
+}
+
+TEST_CASE("Polynomials in use should be table driven.") {
+    CHECK(CRC<32>{0x04c11db7, 0xffffffff, 0xffffffff}.table_driven());
+    CHECK(CRC<32, true, true>{0x04c11db7, 0xffffffff, 0xffffffff}.table_driven());
+    CHECK(CRC<16>{0x1021, 0xffff, 0x1d0f}.table_driven());
+    CHECK(CRC<16>{0x6f63}.table_driven());
+    CHECK(CRC<8>{0x01, 0x00}.table_driven());
+    CHECK_FALSE(CRC<16>{0x8005}.table_driven());
+}
+
+TEST_CASE("Table driven results should be bit identical.") {
+    SUBCASE("CRC-32") { check_identical(CRC<32>{0x04c11db7, 0xffffffff, 0xffffffff}); }
+    SUBCASE("CRC-32 reflected") { check_identical(CRC<32, true, true>{0x04c11db7, 0xffffffff, 0xffffffff}); }
+    SUBCASE("CRC-32 reflected input only") { check_identical(CRC<32, true, false>{0x04c11db7, 0x12345678, 0}); }
+    SUBCASE("ERT CCITT") { check_identical(CRC<16>{0x1021, 0xffff, 0x1d0f}); }
+    SUBCASE("AIS FCS") { check_identical(CRC<16>{0x1021, 0xffff, 0xffff}); }
+    SUBCASE("AX.25") { check_identical(CRC<16, true, true>{0x1021, 0xffff, 0xffff}); }
+    SUBCASE("ERT BCH") { check_identical(CRC<16>{0x6f63}); }
+    SUBCASE("TPMS") { check_identical(CRC<8>{0x01, 0x00}); }
+}
+
+TEST_CASE("Mixing bits and bytes should match the bitwise result.") {
+    const auto data = test_pattern(37);
+    CRC<32> mixed{0x04c11db7, 0xffffffff, 0xffffffff};
+    CRC<32> reference{0x04c11db7, 0xffffffff, 0xffffffff};
+
+    mixed.process_bits(0x15, 5);
+    reference.process_bits(0x15, 5);
+    mixed.process_bytes(data.data(), data.size());
+    for (auto b : data)
+        reference.process_bits(b, 8);
+    mixed.process_bit(true);
+    reference.process_bit(true);
+    mixed.process_byte(0xa5);
+    reference.process_bits(0xa5, 8);
+
+    CHECK_EQ(mixed.checksum(), reference.checksum());
+}
+
+TEST_CASE("Reset should restart the checksum.") {
+    CRC<32, true, true> crc{0x04c11db7, 0xffffffff, 0xffffffff};
+    crc.process_bytes(check_string.data(), 4);
+    crc.reset();
+    crc.process_bytes(check_string.data(), check_string.size());
+    CHECK_EQ(crc.checksum(), 0xcbf43926);
+}
+
+TEST_CASE("Table driven CRC-32 should match bitwise over a large buffer.") {
+    const auto data = test_pattern(256 * 1024);
+    CRC<32> crc{0x04c11db7, 0xffffffff, 0xffffffff};
+
+    CHECK_EQ(table_checksum(crc, data.data(), data.size()),
+             bitwise_checksum(crc, data.data(), data.size()));
+}
+
+/* Reports throughput only, wall-clock time is too noisy to assert on.
+ * Run with: application_test -tc="Benchmark*" --no-skip */
+TEST_CASE("Benchmark table driven against bitwise CRC-32." * doctest::skip()) {
+    const auto data = test_pattern(256 * 1024);
+    CRC<32> crc{0x04c11db7, 0xffffffff, 0xffffffff};
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto bitwise = bitwise_checksum(crc, data.data(), data.size());
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto table = table_checksum(crc, data.data(), data.size());
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const auto bitwise_us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    const auto table_us = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+    MESSAGE("bitwise ", bitwise_us, " us, table ", table_us, " us for ", data.size(), " bytes");
+    CHECK_EQ(table, bitwise);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "dispatch_stats.hpp"
+
+using namespace dispatch_stats;
+
+TEST_SUITE_BEGIN("Dispatch stats");
+
+TEST_CASE("Handler times should land in 4x wide buckets.") {
+    CHECK_EQ(bucket_of(0), 0);
+    CHECK_EQ(bucket_of(31), 0);
+    CHECK_EQ(bucket_of(32), 1);
+    CHECK_EQ(bucket_of(127), 1);
+    CHECK_EQ(bucket_of(2000), 3);
+    CHECK_EQ(bucket_of(8192), 5);
+    CHECK_EQ(bucket_of(UINT32_MAX), bucket_count - 1);
+}
+
+TEST_CASE("Histogram should keep the worst time and saturate counts.") {
+    Histogram histogram;
+    histogram.add(10);
+    histogram.add(5000);
+    histogram.add(100);
+
+    CHECK_EQ(histogram.total(), 3);
+    CHECK_EQ(histogram.count(0), 1);
+    CHECK_EQ(histogram.count(1), 1);
+    CHECK_EQ(histogram.count(4), 1);
+    CHECK_EQ(histogram.worst_us(), 5000);
+
+    for (size_t i = 0; i < 70000; i++)
+        histogram.add(1);
+    CHECK_EQ(histogram.count(0), UINT16_MAX);
+}
+
+TEST_CASE("Stats should track sources and messages separately.") {
+    Stats<4> stats;
+    stats.add(Source::FrameSync, 3000);
+    stats.add_message(2, 40);
+    stats.add_message(4, 40); /* Out of range, ignored. */
+    stats.add_deferral();
+
+    CHECK_EQ(stats.source(Source::FrameSync).total(), 1);
+    CHECK_EQ(stats.source(Source::Encoder).total(), 0);
+    CHECK_EQ(stats.message(2).worst_us(), 40);
+    CHECK_EQ(stats.message(3).total(), 0);
+    CHECK_EQ(stats.deferrals(), 1);
+
+    stats.reset();
+    CHECK_EQ(stats.source(Source::FrameSync).total(), 0);
+    CHECK_EQ(stats.source(Source::FrameSync).worst_us(), 0);
+    CHECK_EQ(stats.message(2).total(), 0);
+    CHECK_EQ(stats.message(2).worst_us(), 0);
+    CHECK_EQ(stats.deferrals(), 0);
+}
+
+TEST_SUITE_END();
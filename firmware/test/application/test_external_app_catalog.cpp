@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "external_app_catalog.hpp"
+#include "mock_file.hpp"
+
+namespace {
+
+external_app_catalog_entry make_entry(external_app_kind kind, const std::u16string& name, uint32_t size, uint16_t time = 0x1234) {
+    external_app_catalog_entry entry{};
+    entry.set_file_name(name);
+    entry.kind = kind;
+    entry.file_size = size;
+    entry.file_date = 0x5821;
+    entry.file_time = time;
+    entry.menu_location = 1;
+    entry.desired_menu_position = -1;
+    entry.icon_color = 0xffe0;
+    entry.bitmap_data[0] = 0xaa;
+    return entry;
+}
+
+bool find(ExternalAppCatalog& catalog, const external_app_catalog_entry& entry) {
+    return catalog.find(entry.kind, entry.path().native(), entry.file_size, entry.file_date, entry.file_time) != nullptr;
+}
+
+MockFile write_catalog(std::initializer_list<external_app_catalog_entry> entries) {
+    ExternalAppCatalog catalog;
+    for (const auto& entry : entries)
+        catalog.update(entry);
+
+    MockFile f{""};
+    REQUIRE(catalog.write(f));
+    f.seek(0);
+    return f;
+}
+
+const auto ais = make_entry(external_app_kind::Application, u"ais_rx.ppma", 8000);
+const auto afsk = make_entry(external_app_kind::Application, u"afsk_rx.ppma", 9000);
+const auto pacman = make_entry(external_app_kind::Standalone, u"pacman.ppmp", 20000);
+
+}  // namespace
+
+TEST_SUITE_BEGIN("External app catalog");
+
+TEST_CASE("Entry names should round trip.") {
+    external_app_catalog_entry entry{};
+    CHECK(entry.set_file_name(u"shoppingcart_lock.ppma"));
+    CHECK(entry.path() == std::filesystem::path{u"shoppingcart_lock.ppma"});
+
+    std::u16string longest(external_app_catalog_entry::max_file_name, u'a');
+    CHECK(entry.set_file_name(longest));
+    CHECK(entry.path().native() == longest);
+
+    CHECK_FALSE(entry.set_file_name(longest + u"b"));
+}
+
+TEST_CASE("A written catalog should read back.") {
+    auto f = write_catalog({ais, afsk, pacman});
+    ExternalAppCatalog catalog;
+    REQUIRE(catalog.read(f));
+
+    REQUIRE_EQ(catalog.size(), 3);
+    CHECK(catalog.entries()[1].path() == std::filesystem::path{u"afsk_rx.ppma"});
+    CHECK_EQ(catalog.entries()[2].kind, external_app_kind::Standalone);
+    CHECK_EQ(catalog.entries()[2].bitmap_data[0], 0xaa);
+    CHECK_FALSE(catalog.changed());
+}
+
+TEST_CASE("Invalid catalogs should be rejected.") {
+    ExternalAppCatalog catalog;
+
+    SUBCASE("empty file") {
+        MockFile f{""};
+        CHECK_FALSE(catalog.read(f));
+    }
+
+    SUBCASE("truncated") {
+        auto f = write_catalog({ais, afsk});
+        f.data_.resize(f.data_.size() - 1);
+        CHECK_FALSE(catalog.read(f));
+    }
+
+    SUBCASE("count beyond the file") {
+        auto f = write_catalog({ais, afsk});
+        f.data_[8] = 3;
+        CHECK_FALSE(catalog.read(f));
+    }
+
+    SUBCASE("count beyond the limit") {
+        MockFile f{""};
+        const ExternalAppCatalog::Header header{
+            ExternalAppCatalog::magic,
+            ExternalAppCatalog::version,
+            sizeof(external_app_catalog_entry),
+            ExternalAppCatalog::max_entries + 1};
+        f.write(&header, sizeof(header));
+        f.seek(0);
+        CHECK_FALSE(catalog.read(f));
+    }
+
+    SUBCASE("other version") {
+        auto f = write_catalog({ais});
+        f.data_[4] = ExternalAppCatalog::version + 1;
+        CHECK_FALSE(catalog.read(f));
+    }
+
+    CHECK_EQ(catalog.size(), 0);
+}
+
+TEST_CASE("Unchanged files should be found.") {
+    auto f = write_catalog({ais, afsk, pacman});
+    ExternalAppCatalog catalog;
+    REQUIRE(catalog.read(f));
+
+    CHECK(find(catalog, ais));
+    CHECK(find(catalog, afsk));
+    CHECK(find(catalog, pacman));
+    catalog.prune();
+
+    CHECK_EQ(catalog.size(), 3);
+    CHECK_FALSE(catalog.changed());
+}
+
+TEST_CASE("Lookups should not depend on directory order.") {
+    auto f = write_catalog({ais, afsk, pacman});
+    ExternalAppCatalog catalog;
+    REQUIRE(catalog.read(f));
+
+    CHECK(find(catalog, pacman));
+    CHECK(find(catalog, ais));
+    CHECK(find(catalog, afsk));
+    CHECK_FALSE(catalog.changed());
+}
+
+TEST_CASE("A stamp or kind mismatch should miss.") {
+    auto f = write_catalog({ais});
+    ExternalAppCatalog catalog;
+    REQUIRE(catalog.read(f));
+
+    auto resized = ais;
+    resized.file_size++;
+    CHECK_FALSE(find(catalog, resized));
+
+    auto touched = ais;
+    touched.file_time++;
+    CHECK_FALSE(find(catalog, touched));
+
+    auto standalone = ais;
+    standalone.kind = external_app_kind::Standalone;
+    CHECK_FALSE(find(catalog, standalone));
+
+    auto prefix = make_entry(external_app_kind::Application, u"ais_rx.ppm", ais.file_size, ais.file_time);
+    CHECK_FALSE(find(catalog, prefix));
+}
+
+TEST_CASE("Changed files should replace their entry.") {
+    auto f = write_catalog({ais, afsk});
+    ExternalAppCatalog catalog;
+    REQUIRE(catalog.read(f));
+
+    auto updated = afsk;
+    updated.file_size = 9500;
+    updated.icon_color = 0x001f;
+
+    CHECK(find(catalog, ais));
+    CHECK_FALSE(find(catalog, updated));
+    catalog.update(updated);
+    catalog.prune();
+
+    REQUIRE_EQ(catalog.size(), 2);
+    CHECK_EQ(catalog.entries()[1].file_size, 9500);
+    CHECK_EQ(catalog.entries()[1].icon_color, 0x001f);
+    CHECK(catalog.changed());
+}
+
+TEST_CASE("Removed files should be pruned and added files appended.") {
+    auto f = write_catalog({ais, afsk});
+    ExternalAppCatalog catalog;
+    REQUIRE(catalog.read(f));
+
+    CHECK(find(catalog, afsk));
+    catalog.update(pacman);
+    catalog.prune();
+
+    REQUIRE_EQ(catalog.size(), 2);
+    CHECK(catalog.entries()[0].path() == std::filesystem::path{u"afsk_rx.ppma"});
+    CHECK(catalog.entries()[1].path() == std::filesystem::path{u"pacman.ppmp"});
+    CHECK(catalog.changed());
+
+    MockFile out{""};
+    REQUIRE(catalog.write(out));
+    out.seek(0);
+    ExternalAppCatalog reread;
+    REQUIRE(reread.read(out));
+    CHECK(find(reread, afsk));
+    CHECK(find(reread, pacman));
+    CHECK_FALSE(find(reread, ais));
+}
+
+TEST_CASE("A full catalog should refuse new files.") {
+    ExternalAppCatalog catalog;
+    for (size_t i = 0; i < ExternalAppCatalog::max_entries; i++) {
+        auto entry = make_entry(external_app_kind::Application, u"app.ppma", 1000 + i);
+        entry.file_name[0] = u'a' + (i % 26);
+        entry.file_name[1] = u'a' + (i / 26);
+        REQUIRE(catalog.update(entry));
+    }
+
+    CHECK_FALSE(catalog.update(pacman));
+    CHECK_EQ(catalog.size(), ExternalAppCatalog::max_entries);
+
+    SUBCASE("but still replace changed ones") {
+        auto entry = catalog.entries()[0];
+        entry.file_size++;
+        CHECK(catalog.update(entry));
+        CHECK_EQ(catalog.entries()[0].file_size, entry.file_size);
+    }
+}
+
+TEST_SUITE_END();
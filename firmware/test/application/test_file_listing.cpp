@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "file_listing.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("FileListing");
+
+TEST_CASE("Sort should put directories first, then order by name.") {
+    FileListing listing{1024};
+    listing.add("b.txt", 10, false);
+    listing.add("zeta", 0, true);
+    listing.add("a.txt", 20, false);
+    listing.add("ALPHA", 0, true);
+    listing.sort();
+
+    REQUIRE_EQ(listing.size(), 4);
+    CHECK_EQ(listing.name(0), "ALPHA");
+    CHECK_EQ(listing.name(1), "zeta");
+    CHECK_EQ(listing.name(2), "a.txt");
+    CHECK_EQ(listing.name(3), "b.txt");
+    CHECK(listing[0].is_directory);
+    CHECK_EQ(listing[2].size, 20);
+    CHECK_EQ(listing[3].size, 10);
+}
+
+TEST_CASE("Thousands of entries should sort correctly.") {
+    FileListing listing{64 * 1024};
+    constexpr size_t count = 3000;
+
+    // Reverse order is the worst case for sorted insertion.
+    for (size_t i = count; i > 0; i--) {
+        char name[16];
+        snprintf(name, sizeof(name), "CAP_%05zu.C16", i);
+        REQUIRE(listing.add(name, i, false));
+    }
+    listing.sort();
+
+    REQUIRE_EQ(listing.size(), count);
+    for (size_t i = 1; i < count; i++)
+        CHECK_LT(listing.name(i - 1), listing.name(i));
+    CHECK_EQ(listing.name(0), "CAP_00001.C16");
+    CHECK_EQ(listing[count - 1].size, count);
+}
+
+TEST_CASE("Records should be compact.") {
+    FileListing listing{1024};
+    listing.add("12345678", 0, false);
+    listing.add("1234", 0, false);
+
+    CHECK_EQ(sizeof(FileListing::Entry), 8);
+    CHECK_EQ(listing.memory_used(), 2 * sizeof(FileListing::Entry) + 12);
+}
+
+TEST_CASE("Entries beyond the budget should overflow the listing.") {
+    FileListing listing{3 * (sizeof(FileListing::Entry) + 4)};
+    CHECK(listing.add("aaaa", 1, false));
+    CHECK(listing.add("bbbb", 2, false));
+    CHECK(listing.add("cccc", 3, false));
+    CHECK_FALSE(listing.overflowed());
+
+    CHECK_FALSE(listing.add("dddd", 4, false));
+    CHECK(listing.overflowed());
+    CHECK_FALSE(listing.add("e", 5, false));
+    CHECK_EQ(listing.size(), 3);
+
+    listing.clear();
+    CHECK_FALSE(listing.overflowed());
+    CHECK(listing.empty());
+}
+
+TEST_CASE("Names longer than a record can hold should be skipped.") {
+    FileListing listing{4096};
+    CHECK(listing.add("a", 0, false));
+    CHECK_FALSE(listing.add(std::string(256, 'x'), 0, false));
+    CHECK_FALSE(listing.overflowed());
+    CHECK(listing.add(std::string(255, 'y'), 0, false));
+    CHECK_EQ(listing.size(), 2);
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("PageSelector");
+
+TEST_CASE("Pages should follow each other in sorted order.") {
+    constexpr size_t count = 2000;
+    constexpr size_t page_size = 20;
+
+    // Directory order unrelated to the sort order, a few directories mixed in.
+    std::vector<std::string> names;
+    for (size_t i = 0; i < count; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "CAP_%05zu.C16", (i * 7919) % count);
+        names.push_back(name);
+    }
+    const auto is_directory = [](size_t i) { return (i % 97) == 0; };
+
+    FileListing reference{64 * 1024};
+    for (size_t i = 0; i < count; i++)
+        reference.add(names[i], i, is_directory(i));
+    reference.sort();
+
+    ListingKey after{};
+    size_t index = 0;
+    for (size_t page = 0; index < count; page++) {
+        PageSelector selector{page_size, page ? &after : nullptr};
+        for (size_t i = 0; i < count; i++)
+            selector.offer(names[i], i, is_directory(i));
+
+        REQUIRE_FALSE(selector.items().empty());
+        for (const auto& item : selector.items()) {
+            REQUIRE_LT(index, count);
+            CHECK_EQ(item.name, reference.name(index));
+            CHECK_EQ(item.is_directory, reference[index].is_directory);
+            CHECK_EQ(item.size, reference[index].size);
+            index++;
+        }
+
+        if (!selector.full())
+            break;
+        after = selector.last_key();
+    }
+
+    CHECK_EQ(index, count);
+}
+
+TEST_CASE("The last page should be short.") {
+    const ListingKey after{"b", false};
+    PageSelector selector{4, &after};
+    for (const auto name : {"c", "a", "d", "b"})
+        selector.offer(name, 0, false);
+
+    CHECK_FALSE(selector.full());
+    REQUIRE_EQ(selector.items().size(), 2);
+    CHECK_EQ(selector.items()[0].name, "c");
+    CHECK_EQ(selector.items()[1].name, "d");
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("PageBookmarks");
+
+TEST_CASE("Page 0 should start from the beginning.") {
+    PageBookmarks<int> bookmarks{4};
+    bookmarks.record(1, 100);
+
+    auto nearest = bookmarks.nearest(0);
+    CHECK_EQ(nearest.first, 0);
+    CHECK(nearest.second == nullptr);
+}
+
+TEST_CASE("Nearest should return the closest page at or before.") {
+    PageBookmarks<int> bookmarks{8};
+    for (size_t page = 1; page <= 5; page++)
+        bookmarks.record(page, page * 100);
+
+    auto nearest = bookmarks.nearest(3);
+    CHECK_EQ(nearest.first, 3);
+    REQUIRE(nearest.second != nullptr);
+    CHECK_EQ(*nearest.second, 300);
+
+    nearest = bookmarks.nearest(9);
+    CHECK_EQ(nearest.first, 5);
+    CHECK_EQ(*nearest.second, 500);
+}
+
+TEST_CASE("A full set of bookmarks should thin out.") {
+    PageBookmarks<int> bookmarks{4};
+    for (size_t page = 1; page <= 20; page++)
+        bookmarks.record(page, page * 100);
+
+    CHECK_LE(bookmarks.size(), 4);
+    CHECK_EQ(bookmarks.stride(), 8);
+
+    for (size_t page = 0; page <= 20; page++) {
+        auto nearest = bookmarks.nearest(page);
+        CHECK_LE(nearest.first, page);
+        CHECK_LT(page - nearest.first, bookmarks.stride());
+        if (nearest.second)
+            CHECK_EQ(*nearest.second, nearest.first * 100);
+    }
+}
+
+TEST_SUITE_END();
@@ -460,4 +460,111 @@ SCENARIO("It calls on_read_progress while reading.") {
     }
 }
 
+namespace {
+/* Builds "line N\n" lines for N in [0, count). */
+std::string make_lines(uint32_t count) {
+    std::string content;
+    for (uint32_t i = 0; i < count; ++i)
+        content += "line " + std::to_string(i) + "\n";
+    return content;
+}
+
+std::string expected_line(uint32_t i) {
+    return "line " + std::to_string(i) + "\n";
+}
+}  // namespace
+
+SCENARIO("Random access in a large file.") {
+    GIVEN("A file with many lines") {
+        constexpr uint32_t count = 20000;
+        MockFile f{make_lines(count)};
+        auto w = wrap_buffer(f);
+
+        REQUIRE_EQ(w.line_count(), count);
+
+        WHEN("Building the line index") {
+            THEN("the index size should stay bounded.") {
+                CHECK(w.index_size() > 1);
+                CHECK(w.index_size() <= 128);
+            }
+        }
+
+        WHEN("Jumping around the file") {
+            for (uint32_t line : {19999u, 5u, 12345u, 777u, 18000u, 0u, 9999u}) {
+                auto str = w.get_text(line, 0, 20);
+                REQUIRE(str);
+                CHECK_EQ(*str, expected_line(line));
+            }
+        }
+
+        WHEN("Reading lines in the newline cache") {
+            w.get_text(15000, 0, 20);
+            auto reads = w.block_reads();
+            auto str = w.get_text(15001, 0, 20);
+
+            THEN("it should cost at most one block read.") {
+                REQUIRE(str);
+                CHECK_EQ(*str, expected_line(15001));
+                CHECK(w.block_reads() - reads <= 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Editing keeps the line index valid.") {
+    GIVEN("A file with many lines") {
+        constexpr uint32_t count = 5000;
+        MockFile f{make_lines(count)};
+        auto w = wrap_buffer(f);
+
+        WHEN("Inserting a line near the start") {
+            w.insert_line(10);
+
+            THEN("lines after it should be shifted.") {
+                REQUIRE_EQ(w.line_count(), count + 1);
+                CHECK_EQ(*w.get_text(4000, 0, 20), expected_line(3999));
+                CHECK_EQ(*w.get_text(11, 0, 20), expected_line(10));
+                CHECK_EQ(*w.get_text(10, 0, 20), "\n");
+            }
+        }
+
+        WHEN("Deleting a line near the start") {
+            w.delete_line(20);
+
+            THEN("lines after it should be shifted.") {
+                REQUIRE_EQ(w.line_count(), count - 1);
+                CHECK_EQ(*w.get_text(4000, 0, 20), expected_line(4001));
+                CHECK_EQ(*w.get_text(20, 0, 20), expected_line(21));
+            }
+        }
+
+        WHEN("Replacing a line with several lines") {
+            auto range = w.line_range(3000);
+            REQUIRE(range);
+            w.replace_range(*range, "a\nb\nc\n");
+
+            THEN("the line index should match a fresh scan.") {
+                auto fresh = wrap_buffer(f);
+                REQUIRE_EQ(w.line_count(), fresh.line_count());
+                for (uint32_t line : {0u, 2999u, 3000u, 3002u, 3003u, 4500u, w.line_count() - 1}) {
+                    auto a = w.get_text(line, 0, 20);
+                    auto b = fresh.get_text(line, 0, 20);
+                    REQUIRE(a);
+                    REQUIRE(b);
+                    CHECK_EQ(*a, *b);
+                }
+            }
+        }
+
+        WHEN("Removing the trailing newline") {
+            w.replace_range({(uint32_t)w.size() - 1, (uint32_t)w.size()}, "");
+
+            THEN("the last line should still count.") {
+                CHECK_EQ(w.line_count(), count);
+                CHECK_EQ(*w.get_text(count - 1, 0, 20), "line 4999");
+            }
+        }
+    }
+}
+
 TEST_SUITE_END();
\ No newline at end of file
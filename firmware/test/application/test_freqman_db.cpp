@@ -21,6 +21,9 @@
 
 #include "doctest.h"
 #include "freqman_db.hpp"
+#include "mock_file.hpp"
+
+#include <vector>
 
 TEST_SUITE_BEGIN("Freqman Parsing");
 
@@ -266,3 +269,146 @@ TEST_CASE("It can parse frequency step") {
 */
 
 TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("Freqman List");
+
+TEST_CASE("It round trips entries through the compact form.") {
+    freqman_entry e{
+        .frequency_a = 146'520'000,
+        .frequency_b = 146'000'000,
+        .description = "Calling",
+        .type = freqman_type::HamRadio,
+        .modulation = 1,
+        .bandwidth = 2,
+        .tone = 3,
+    };
+    FreqmanList list;
+    list.push_back(e);
+
+    REQUIRE_EQ(list.size(), 1);
+    CHECK(list.entry(0) == e);
+    CHECK_EQ(list.description(0), "Calling");
+}
+
+TEST_CASE("It interns repeated descriptions.") {
+    FreqmanList list;
+    list.push_back(freqman_entry{.frequency_a = 1, .description = "PMR446", .type = freqman_type::Single});
+    list.push_back(freqman_entry{.frequency_a = 2, .description = "PMR446", .type = freqman_type::Single});
+    list.push_back(freqman_entry{.frequency_a = 3, .description = "Marine", .type = freqman_type::Single});
+    list.push_back(freqman_entry{.frequency_a = 4, .description = "PMR446", .type = freqman_type::Single});
+
+    CHECK_EQ(list.arena_size(), 12);
+    CHECK_EQ(list.description(3), "PMR446");
+    CHECK_EQ(list.description(2), "Marine");
+}
+
+TEST_CASE("It erases entries.") {
+    FreqmanList list;
+    list.push_back(freqman_entry{.frequency_a = 1, .description = "A", .type = freqman_type::Single});
+    list.push_back(freqman_entry{.frequency_a = 2, .description = "B", .type = freqman_type::Single});
+
+    list.erase(0);
+    REQUIRE_EQ(list.size(), 1);
+    CHECK_EQ(list[0].frequency_a, 2);
+    CHECK_EQ(list.description(0), "B");
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("Freqman Index");
+
+namespace {
+const freqman_index_stamp stamp{1234, 0x5678, 0x9abc};
+
+std::vector<freqman_entry> make_entries() {
+    return {
+        {.frequency_a = 100, .description = "one", .type = freqman_type::Single, .modulation = 1, .bandwidth = 0},
+        {.frequency_a = 200, .frequency_b = 300, .description = "two", .type = freqman_type::Range, .step = 4},
+        {.description = "raw line", .type = freqman_type::Raw},
+        {.frequency_a = 400, .frequency_b = 500, .type = freqman_type::HamRadio, .modulation = 2, .tone = 7},
+        {.frequency_a = 600, .description = "four", .type = freqman_type::Single},
+    };
+}
+}  // namespace
+
+TEST_CASE("It round trips entries through an index.") {
+    auto entries = make_entries();
+    MockFile f{""};
+    REQUIRE(write_freqman_index(f, stamp, entries));
+
+    FreqmanList list;
+    f.seek(0);
+    REQUIRE(read_freqman_index(f, stamp, list, {.max_entries = 0}));
+
+    // Raw lines aren't indexed.
+    REQUIRE_EQ(list.size(), 4);
+    CHECK(list.entry(0) == entries[0]);
+    CHECK_EQ(list[1].frequency_b, 300);
+    CHECK_EQ(list[1].step, 4);
+    CHECK_EQ(list.description(1), "two");
+    CHECK_EQ(list[2].tone, 7);
+    CHECK(list.description(2).empty());
+    CHECK_EQ(list.description(3), "four");
+}
+
+TEST_CASE("It inherits modulation and bandwidth when reading an index.") {
+    auto entries = make_entries();
+    MockFile f{""};
+    REQUIRE(write_freqman_index(f, stamp, entries));
+
+    FreqmanList list;
+    f.seek(0);
+    REQUIRE(read_freqman_index(f, stamp, list, {.max_entries = 0}));
+
+    CHECK_EQ(list[1].modulation, 1);
+    CHECK_EQ(list[1].bandwidth, 0);
+    CHECK_EQ(list[3].modulation, 2);
+}
+
+TEST_CASE("It applies load options when reading an index.") {
+    auto entries = make_entries();
+    MockFile f{""};
+    REQUIRE(write_freqman_index(f, stamp, entries));
+
+    SUBCASE("Filtering types") {
+        FreqmanList list;
+        f.seek(0);
+        REQUIRE(read_freqman_index(f, stamp, list, {.max_entries = 0, .load_ranges = false, .load_hamradios = false}));
+        REQUIRE_EQ(list.size(), 2);
+        CHECK_EQ(list[0].frequency_a, 100);
+        CHECK_EQ(list[1].frequency_a, 600);
+    }
+
+    SUBCASE("Limiting entries") {
+        FreqmanList list;
+        f.seek(0);
+        REQUIRE(read_freqman_index(f, stamp, list, {.max_entries = 2}));
+        CHECK_EQ(list.size(), 2);
+    }
+}
+
+TEST_CASE("It rejects a stale index.") {
+    auto entries = make_entries();
+    MockFile f{""};
+    REQUIRE(write_freqman_index(f, stamp, entries));
+
+    FreqmanList list;
+    f.seek(0);
+    CHECK_FALSE(read_freqman_index(f, {stamp.size + 1, stamp.date, stamp.time}, list, {}));
+    f.seek(0);
+    CHECK_FALSE(read_freqman_index(f, {stamp.size, stamp.date, static_cast<uint16_t>(stamp.time + 1)}, list, {}));
+}
+
+TEST_CASE("It rejects a truncated index.") {
+    auto entries = make_entries();
+    MockFile f{""};
+    REQUIRE(write_freqman_index(f, stamp, entries));
+    f.data_.resize(f.data_.size() - 1);
+
+    FreqmanList list;
+    f.seek(0);
+    CHECK_FALSE(read_freqman_index(f, stamp, list, {}));
+    CHECK(list.empty());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "external/wardrivemap/geo_index.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ui::external_app::wardrivemap;
+
+namespace {
+
+struct Position {
+    float lat;
+    float lon;
+};
+
+GeoGrid make_grid(const std::vector<Position>& positions) {
+    GeoGrid grid;
+    for (const auto& p : positions)
+        grid.count(p.lat, p.lon);
+    grid.build();
+    for (size_t n = 0; n < positions.size(); n++)
+        grid.place(n, positions[n].lat, positions[n].lon);
+    return grid;
+}
+
+struct Listing {
+    std::vector<std::string> new_names{};
+    bool rebuild{false};
+    ListingPrefix::Known known{};
+};
+
+/* What GeoIndex::update() makes of a directory listing. */
+Listing list(const ListingPrefix::Known known, const std::vector<std::string>& names) {
+    Listing result;
+    ListingPrefix prefix{known};
+    for (const auto& name : names) {
+        const auto kind = prefix.add(name);
+        if (kind == ListingPrefix::Name::Changed) {
+            result.rebuild = true;
+            return result;
+        }
+        if (kind == ListingPrefix::Name::New)
+            result.new_names.push_back(name);
+    }
+    result.rebuild = !prefix.complete();
+    result.known = prefix.known();
+    return result;
+}
+
+const std::vector<std::string> captures{"A.TXT", "B.TXT", "C.TXT"};
+
+ListingPrefix::Known indexed() {
+    return list({0, name_hash_basis}, captures).known;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("Geo index");
+
+TEST_CASE("Cell keys should round trip to the south west corner.") {
+    const auto key = cell_key(47.51f, 19.04f);
+    CHECK(cell_lat(key) == doctest::Approx(47.5f));
+    CHECK(cell_lon(key) == doctest::Approx(19.0f));
+
+    CHECK(cell_key(-33.87f, 151.21f) != cell_key(-33.87f, -151.21f));
+    CHECK(cell_key(0.01f, 0.01f) == cell_key(0.1f, 0.1f));
+    CHECK(cell_key(-100.0f, 0.0f) == cell_key(-90.0f, 0.0f));
+}
+
+TEST_CASE("Only usable positions should be indexed.") {
+    CHECK(has_position(47.5f, 19.0f));
+    CHECK(has_position(-33.8f, -70.6f));
+    CHECK_FALSE(has_position(0, 19.0f));
+    CHECK_FALSE(has_position(47.5f, 0));
+    CHECK_FALSE(has_position(400, 400));
+}
+
+TEST_CASE("The name hash should depend on names and their order.") {
+    const auto ab = name_hash(name_hash(name_hash_basis, "A.TXT"), "B.TXT");
+    const auto ba = name_hash(name_hash(name_hash_basis, "B.TXT"), "A.TXT");
+    CHECK(ab != ba);
+    CHECK(ab == name_hash(name_hash(name_hash_basis, "A.TXT"), "B.TXT"));
+    CHECK(name_hash(name_hash_basis, "") == name_hash_basis);
+}
+
+TEST_CASE("Records should be bucketed by cell in record order.") {
+    const auto grid = make_grid({
+        {47.51f, 19.04f},  // Budapest
+        {48.20f, 16.37f},  // Vienna
+        {47.52f, 19.05f},  // Budapest, same cell
+        {-33.87f, 151.21f},
+        {47.49f, 19.06f},  // Budapest, the cell south of it
+    });
+
+    CHECK(grid.size() == 5);
+    REQUIRE(grid.cells().size() == 4);
+
+    const auto budapest = cell_key(47.51f, 19.04f);
+    bool found = false;
+    for (size_t i = 0; i < grid.cells().size(); i++) {
+        const auto& cell = grid.cells()[i];
+        if (i > 0)
+            CHECK(grid.cells()[i - 1].key < cell.key);
+        if (cell.key == budapest) {
+            found = true;
+            REQUIRE(cell.count == 2);
+            CHECK(grid.records(cell)[0] == 0);
+            CHECK(grid.records(cell)[1] == 2);
+        }
+    }
+    CHECK(found);
+}
+
+TEST_CASE("An empty grid should have no cells.") {
+    const auto grid = make_grid({});
+    CHECK(grid.size() == 0);
+    CHECK(grid.cells().empty());
+}
+
+TEST_CASE("A first listing should append every file.") {
+    const auto result = list({0, name_hash_basis}, captures);
+    CHECK_FALSE(result.rebuild);
+    CHECK(result.new_names == captures);
+    CHECK(result.known.files == 3);
+}
+
+TEST_CASE("An unchanged listing should append nothing.") {
+    const auto result = list(indexed(), captures);
+    CHECK_FALSE(result.rebuild);
+    CHECK(result.new_names.empty());
+    CHECK(result.known.files == indexed().files);
+    CHECK(result.known.hash == indexed().hash);
+}
+
+TEST_CASE("Files appended to a listing should be the only ones appended.") {
+    const auto result = list(indexed(), {"A.TXT", "B.TXT", "C.TXT", "D.TXT", "E.TXT"});
+    CHECK_FALSE(result.rebuild);
+    CHECK(result.new_names == std::vector<std::string>{"D.TXT", "E.TXT"});
+    CHECK(result.known.files == 5);
+
+    // And the next listing picks up from there.
+    CHECK(list(result.known, {"A.TXT", "B.TXT", "C.TXT", "D.TXT", "E.TXT"}).new_names.empty());
+}
+
+TEST_CASE("A deleted file should rebuild the index.") {
+    CHECK(list(indexed(), {"A.TXT", "C.TXT"}).rebuild);
+    CHECK(list(indexed(), {"A.TXT", "B.TXT"}).rebuild);
+    CHECK(list(indexed(), {}).rebuild);
+
+    // Even when a new file takes its place in the count.
+    CHECK(list(indexed(), {"A.TXT", "C.TXT", "D.TXT"}).rebuild);
+}
+
+TEST_CASE("A renamed file should rebuild the index.") {
+    CHECK(list(indexed(), {"A.TXT", "X.TXT", "C.TXT"}).rebuild);
+    CHECK(list(indexed(), {"A.TXT", "B.TXT", "X.TXT", "D.TXT"}).rebuild);
+}
+
+TEST_SUITE_END();
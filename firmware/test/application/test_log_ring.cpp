@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "log_ring.hpp"
+
+#include <string>
+
+namespace {
+
+std::string read_all(LogRing& ring, size_t chunk) {
+    std::string text;
+    uint8_t buffer[64];
+    while (true) {
+        const auto count = ring.read(buffer, std::min(chunk, sizeof(buffer)));
+        if (count == 0)
+            break;
+        text.append(reinterpret_cast<const char*>(buffer), count);
+    }
+    return text;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("LogRing");
+
+TEST_CASE("Lines come out in order with their parts joined.") {
+    LogRing ring{64};
+    CHECK(ring.empty());
+    CHECK_EQ(ring.next_file(), -1);
+
+    REQUIRE(ring.push(0, {"a", "bc", "\r\n"}));
+    REQUIRE(ring.push(0, {"def\r\n"}));
+    CHECK_EQ(ring.used(), 2 * LogRing::header_size + 10);
+    CHECK_EQ(ring.next_file(), 0);
+
+    CHECK_EQ(read_all(ring, 64), "abc\r\ndef\r\n");
+    CHECK(ring.empty());
+}
+
+TEST_CASE("A read stops where the next file begins.") {
+    LogRing ring{64};
+    ring.push(1, {"one"});
+    ring.push(1, {"two"});
+    ring.push(2, {"three"});
+
+    uint8_t buffer[32];
+    CHECK_EQ(ring.next_file(), 1);
+    CHECK_EQ(ring.read(buffer, sizeof(buffer)), 6);
+    CHECK_EQ(ring.next_file(), 2);
+    CHECK_EQ(ring.read(buffer, sizeof(buffer)), 5);
+    CHECK(ring.empty());
+}
+
+TEST_CASE("Lines may be split over reads.") {
+    LogRing ring{64};
+    ring.push(3, {"0123456789"});
+    ring.push(4, {"xyz"});
+
+    uint8_t buffer[16];
+    CHECK_EQ(ring.read(buffer, 4), 4);
+    CHECK_EQ(ring.next_file(), 3);
+    CHECK_EQ(ring.read(buffer, sizeof(buffer)), 6);
+    CHECK_EQ(std::string(reinterpret_cast<const char*>(buffer), 6), "456789");
+    CHECK_EQ(ring.next_file(), 4);
+}
+
+TEST_CASE("Lines that don't fit are dropped whole.") {
+    LogRing ring{16};
+    CHECK(ring.push(0, {"0123456789"}));
+    CHECK_FALSE(ring.push(0, {"abc"}));
+    CHECK_EQ(ring.used(), LogRing::header_size + 10);
+    CHECK_EQ(read_all(ring, 64), "0123456789");
+}
+
+TEST_CASE("Text wraps around the end of the ring.") {
+    LogRing ring{20};
+    std::string expected;
+    for (char c = 'a'; c <= 'z'; c++) {
+        const std::string line(5, c);
+        REQUIRE(ring.push(c & 1, {line}));
+        CHECK_EQ(ring.next_file(), c & 1);
+        CHECK_EQ(read_all(ring, 3), line);
+    }
+    CHECK(ring.empty());
+}
+
+TEST_SUITE_END();
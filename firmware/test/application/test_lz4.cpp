@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "lz4.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/* Byte for byte transcription of the Cortex-M0 unlz4_len routine (lz4.S)
+ * that used to unpack the baseband images. It trusts its input, always reads
+ * a match offset after the final literals (2 bytes past the block) and then
+ * copies at least 4 bytes past the end of the output, so both buffers need
+ * slack. */
+void unlz4_len_reference(const uint8_t* src, uint8_t* dst, uint32_t length) {
+    const uint8_t* const end = src + length;
+    auto get_length = [&src](uint32_t len) {
+        if (len == 0x0f) {
+            uint8_t b;
+            do {
+                b = *src++;
+                len += b;
+            } while (b == 0xff);
+        }
+        return len;
+    };
+
+    do {
+        const uint8_t token = *src++;
+        uint32_t len = token >> 4;
+        if (len) {
+            len = get_length(len);
+            while (len--)
+                *dst++ = *src++;
+        }
+        const uint8_t* match = dst - (src[0] | (src[1] << 8));
+        src += 2;
+        len = get_length(token & 0x0f) + 4;
+        while (len--)
+            *dst++ = *match++;
+    } while (src < end);
+}
+
+/* Minimal greedy LZ4 block compressor, enough to produce valid blocks with
+ * long literal runs, long matches and overlapping matches. */
+std::vector<uint8_t> compress_block(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> out;
+    std::vector<int32_t> table(4096, -1);
+
+    auto put_length = [&out](size_t len) {
+        for (; len >= 255; len -= 255)
+            out.push_back(255);
+        out.push_back(len);
+    };
+    auto hash = [&in](size_t i) {
+        uint32_t v;
+        std::memcpy(&v, &in[i], 4);
+        return (v * 2654435761u) >> 20;
+    };
+    auto emit = [&](size_t lit_start, size_t lit_len, size_t offset, size_t match_len) {
+        const size_t ml = match_len ? match_len - 4 : 0;
+        out.push_back(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15));
+        if (lit_len >= 15)
+            put_length(lit_len - 15);
+        out.insert(out.end(), in.begin() + lit_start, in.begin() + lit_start + lit_len);
+        if (match_len) {
+            out.push_back(offset & 0xff);
+            out.push_back(offset >> 8);
+            if (ml >= 15)
+                put_length(ml - 15);
+        }
+    };
+
+    /* As in the reference format, the last 5 bytes are always literals and
+     * no match starts in the last 12 bytes. */
+    const size_t match_limit = in.size() > 12 ? in.size() - 12 : 0;
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i < match_limit) {
+        const auto h = hash(i);
+        const int32_t candidate = table[h];
+        table[h] = i;
+        if (candidate >= 0 && i - candidate <= 0xffff && std::memcmp(&in[candidate], &in[i], 4) == 0) {
+            size_t len = 4;
+            while (i + len < in.size() - 5 && in[candidate + len] == in[i + len])
+                len++;
+            emit(anchor, i - anchor, i - candidate, len);
+            i += len;
+            anchor = i;
+        } else {
+            i++;
+        }
+    }
+    emit(anchor, in.size() - anchor, 0, 0);
+    return out;
+}
+
+/* Something resembling a firmware image: code-like repeats, zero runs and
+ * incompressible tables. */
+std::vector<uint8_t> test_image(size_t length) {
+    std::vector<uint8_t> data;
+    uint32_t state = 0x2468ace0;
+    auto next = [&state]() {
+        state = state * 1664525 + 1013904223;
+        return state >> 24;
+    };
+    while (data.size() < length) {
+        switch (next() & 3) {
+            case 0:
+                data.insert(data.end(), 8 + (next() & 63), 0);
+                break;
+            case 1:
+                for (size_t n = 16 + (next() & 127); n; n--)
+                    data.push_back(next());
+                break;
+            default:
+                if (data.size() > 64) {
+                    const size_t back = 1 + (next() << 2) % (data.size() < 4096 ? data.size() : 4096);
+                    for (size_t n = 8 + (next() & 31); n; n--)
+                        data.push_back(data[data.size() - back]);
+                } else {
+                    data.push_back(next());
+                }
+                break;
+        }
+    }
+    data.resize(length);
+    return data;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("LZ4 block decoder");
+
+TEST_CASE("It should decode a literal only block.") {
+    const std::vector<uint8_t> block{0x50, 'h', 'e', 'l', 'l', 'o'};
+    uint8_t out[8]{};
+    REQUIRE_EQ(lz4::decode_block(block.data(), block.size(), out, sizeof(out)), 5);
+    CHECK_EQ(std::memcmp(out, "hello", 5), 0);
+}
+
+TEST_CASE("It should decode overlapping matches.") {
+    /* "ab" followed by a match of 10 at offset 2, then the final literal. */
+    const std::vector<uint8_t> block{0x26, 'a', 'b', 0x02, 0x00, 0x10, 'c'};
+    uint8_t out[16]{};
+    REQUIRE_EQ(lz4::decode_block(block.data(), block.size(), out, sizeof(out)), 13);
+    CHECK_EQ(std::memcmp(out, "ababababababc", 13), 0);
+}
+
+TEST_CASE("It should match the lz4.S routine.") {
+    for (const size_t size : {16u, 1000u, 65536u}) {
+        const auto image = test_image(size);
+        auto block = compress_block(image);
+
+        std::vector<uint8_t> expected(size + 32, 0);
+        std::vector<uint8_t> padded_block = block;
+        padded_block.resize(block.size() + 4, 0);
+        unlz4_len_reference(padded_block.data(), expected.data(), block.size());
+        REQUIRE(std::equal(image.begin(), image.end(), expected.begin()));
+
+        std::vector<uint8_t> decoded(size);
+        CHECK_EQ(lz4::decode_block(block.data(), block.size(), decoded.data(), decoded.size()), size);
+        CHECK(decoded == image);
+    }
+}
+
+TEST_CASE("It should reject blocks that overrun the output.") {
+    const auto image = test_image(4096);
+    const auto block = compress_block(image);
+    std::vector<uint8_t> decoded(image.size() - 1);
+    CHECK_EQ(lz4::decode_block(block.data(), block.size(), decoded.data(), decoded.size()), 0);
+}
+
+TEST_CASE("It should reject truncated blocks.") {
+    const auto image = test_image(4096);
+    const auto block = compress_block(image);
+    std::vector<uint8_t> decoded(image.size());
+    for (const size_t cut : {1u, 2u, 3u, 100u})
+        CHECK_NE(lz4::decode_block(block.data(), block.size() - cut, decoded.data(), decoded.size()), image.size());
+}
+
+TEST_CASE("It should reject offsets before the start of the output.") {
+    const std::vector<uint8_t> block{0x10, 'a', 0x02, 0x00, 0x00};
+    uint8_t out[16]{};
+    CHECK_EQ(lz4::decode_block(block.data(), block.size(), out, sizeof(out)), 0);
+
+    const std::vector<uint8_t> zero_offset{0x10, 'a', 0x00, 0x00, 0x00};
+    CHECK_EQ(lz4::decode_block(zero_offset.data(), zero_offset.size(), out, sizeof(out)), 0);
+}
+
+TEST_CASE("It should decode a large block like the lz4.S routine.") {
+    const auto image = test_image(64 * 1024);
+    const auto block = compress_block(image);
+    std::vector<uint8_t> padded_block = block;
+    padded_block.resize(block.size() + 4, 0);
+
+    std::vector<uint8_t> reference(image.size() + 32);
+    unlz4_len_reference(padded_block.data(), reference.data(), block.size());
+
+    std::vector<uint8_t> out(image.size());
+    CHECK_EQ(lz4::decode_block(block.data(), block.size(), out.data(), out.size()), image.size());
+    CHECK(std::equal(image.begin(), image.end(), out.begin()));
+    CHECK(std::equal(out.begin(), out.end(), reference.begin()));
+}
+
+/* Reports throughput only, wall-clock time is too noisy to assert on. The
+ * M0 assembly can't run on the host, so its transcription stands in for it.
+ * Run with: application_test -tc="Benchmark*" --no-skip */
+TEST_CASE("Benchmark the decoder against the lz4.S routine." * doctest::skip()) {
+    constexpr size_t size = 256 * 1024;
+    constexpr size_t rounds = 20;
+    const auto image = test_image(size);
+    const auto block = compress_block(image);
+    std::vector<uint8_t> padded_block = block;
+    padded_block.resize(block.size() + 4, 0);
+    std::vector<uint8_t> decoded(size + 32);
+
+    const auto mb_per_s = [](std::chrono::steady_clock::duration elapsed) {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        return us ? double(size * rounds) / us : 0.0;
+    };
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < rounds; n++)
+        unlz4_len_reference(padded_block.data(), decoded.data(), block.size());
+    const auto t1 = std::chrono::steady_clock::now();
+    size_t length = 0;
+    for (size_t n = 0; n < rounds; n++)
+        length = lz4::decode_block(block.data(), block.size(), decoded.data(), size);
+    const auto t2 = std::chrono::steady_clock::now();
+
+    MESSAGE("lz4.S ", mb_per_s(t1 - t0), " MB/s, decode_block ", mb_per_s(t2 - t1), " MB/s");
+    CHECK_EQ(length, size);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "startup_trace.hpp"
+
+using startup_trace::Stage;
+using startup_trace::Trace;
+
+TEST_SUITE_BEGIN("Startup trace");
+
+TEST_CASE("Stages should be timed from the start of the switch.") {
+    Trace trace;
+    trace.begin(1000, {'P', 'N', 'F', 'M'});
+    trace.mark(Stage::ImageLocated, 1010);
+    trace.mark(Stage::ImageDecompressed, 1500);
+    trace.mark(Stage::M4Reset, 1510);
+
+    CHECK(trace.active());
+    CHECK_EQ(trace.elapsed(Stage::ImageLocated), 10);
+    CHECK_EQ(trace.elapsed(Stage::ImageDecompressed), 500);
+    CHECK_EQ(trace.elapsed(Stage::M4Reset), 510);
+    CHECK_FALSE(trace.reached(Stage::BasebandReady));
+    CHECK_EQ(trace.tag()[1], 'N');
+}
+
+TEST_CASE("Only the first paint should close the trace.") {
+    Trace trace;
+    trace.begin(0, {'P', 'A', 'M', 'A'});
+    trace.mark(Stage::FirstPaint, 300);
+    trace.mark(Stage::FirstPaint, 600);
+
+    CHECK_FALSE(trace.active());
+    CHECK_EQ(trace.elapsed(Stage::FirstPaint), 300);
+
+    /* Stages after the trace closed are ignored. */
+    trace.mark(Stage::BasebandReady, 700);
+    CHECK_FALSE(trace.reached(Stage::BasebandReady));
+}
+
+TEST_CASE("Timer wraparound should not affect elapsed times.") {
+    Trace trace;
+    trace.begin(0xffffff00, {'P', 'W', 'F', 'M'});
+    trace.mark(Stage::M4Reset, 0x00000100);
+    CHECK_EQ(trace.elapsed(Stage::M4Reset), 0x200);
+}
+
+TEST_CASE("Worst case times should be kept across switches.") {
+    Trace trace;
+    trace.begin(0, {'P', 'N', 'F', 'M'});
+    trace.mark(Stage::BasebandReady, 900);
+    trace.begin(1000, {'P', 'A', 'M', 'A'});
+    trace.mark(Stage::BasebandReady, 1400);
+
+    CHECK_EQ(trace.switches(), 2);
+    CHECK_EQ(trace.elapsed(Stage::BasebandReady), 400);
+    CHECK_EQ(trace.worst(Stage::BasebandReady), 900);
+}
+
+TEST_SUITE_END();
@@ -142,3 +142,42 @@ TEST_CASE("trim returns empty for only whitespace.") {
 TEST_CASE("trim empty returns empty.") {
     CHECK(trim("").empty());
 }
+
+TEST_CASE("FixedString matches the std::string formatting.") {
+    FixedString<64> str;
+    str.append_dec_int(-42).append(' ').append_dec_uint(1'234'567'890);
+    CHECK_EQ(str.view(), "-42 1234567890");
+
+    str.clear();
+    str.append_dec_uint(7, 4).append_dec_uint(7, 3, '0').append_dec_int(-7, 4).append_dec_int(-7, 4, '0');
+    CHECK_EQ(str.view(), to_string_dec_uint(7, 4) + to_string_dec_uint(7, 3, '0') + to_string_dec_int(-7, 4) + to_string_dec_int(-7, 4, '0'));
+
+    str.clear();
+    str.append_hex(0xBEEFu, 6).append_hex(uint8_t{0x0A});
+    CHECK_EQ(str.view(), "00BEEF0A");
+
+    str.clear();
+    str.append_short_freq(1'234'567'890);
+    CHECK_EQ(str.view(), to_string_short_freq(1'234'567'890));
+
+    uint8_t bytes[] = {0x00, 0x7F, 0xA5};
+    str.clear();
+    str.append_hex_array(bytes, sizeof(bytes));
+    CHECK_EQ(str.view(), "007FA5");
+    CHECK_EQ(to_string_hex_array(bytes, sizeof(bytes)), "007FA5");
+}
+
+TEST_CASE("FixedString drops what doesn't fit.") {
+    FixedString<8> str;
+    CHECK(str.view().empty());
+    CHECK_EQ(str.c_str()[0], '\0');
+
+    str.append("TIMER: ").append_dec_int(1234);
+    CHECK_EQ(str.view(), "TIMER: 1");
+    CHECK_EQ(std::string{str.c_str()}, "TIMER: 1");
+    CHECK(str.truncated());
+
+    str.clear();
+    CHECK_FALSE(str.truncated());
+    CHECK_EQ(str.append("ok").view(), "ok");
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "dirty_registers.hpp"
+#include "tuning.hpp"
+
+namespace {
+
+enum class TestRegister : uint8_t {
+    A = 0,
+    B = 1,
+    C = 2,
+    D = 3,
+};
+
+constexpr uint8_t first_if_device = 0;
+constexpr uint8_t second_if_device = 1;
+
+/* Stand-ins for the RFFC507x and MAX283x that log every
+ * SPI-level operation into a RegisterWriteTrace. */
+struct MockFirstIF {
+    RegisterWriteTrace& trace;
+    bool enabled{false};
+    size_t invalidations{0};
+
+    void invalidate() {
+        invalidations++;
+    }
+
+    void disable() {
+        enabled = false;
+        trace.record(first_if_device, 0x15, 0);
+    }
+
+    void enable() {
+        enabled = true;
+        trace.record(first_if_device, 0x15, 1);
+    }
+
+    void set_frequency(const rf::Frequency f) {
+        trace.record(first_if_device, 0x0f, f / 1000000);
+    }
+};
+
+struct MockSecondIF {
+    RegisterWriteTrace& trace;
+    size_t invalidations{0};
+
+    void invalidate() {
+        invalidations++;
+    }
+
+    bool set_frequency(const rf::Frequency f) {
+        trace.record(second_if_device, 17, f / 1000000);
+        return true;
+    }
+};
+
+}  // namespace
+
+TEST_SUITE_BEGIN("DirtyRegisters");
+
+TEST_CASE("mark_changed should only mark registers that differ.") {
+    DirtyRegisters<TestRegister, 4> dirty;
+    std::array<uint16_t, 4> before{1, 2, 3, 4};
+    std::array<uint16_t, 4> after{1, 5, 3, 6};
+
+    dirty.mark_changed(before, after);
+
+    CHECK(dirty);
+    CHECK_FALSE(dirty.test(TestRegister::A));
+    CHECK(dirty.test(TestRegister::B));
+    CHECK_FALSE(dirty.test(TestRegister::C));
+    CHECK(dirty.test(TestRegister::D));
+}
+
+TEST_CASE("mark_changed with identical maps should mark nothing.") {
+    DirtyRegisters<TestRegister, 4> dirty;
+    std::array<uint16_t, 4> values{1, 2, 3, 4};
+
+    dirty.mark_changed(values, values);
+
+    CHECK_FALSE(dirty);
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("RegisterWriteTrace");
+
+TEST_CASE("Trace should not record until enabled.") {
+    RegisterWriteTrace trace;
+    trace.record(0, 1, 2);
+    CHECK_EQ(trace.count(), 0);
+
+    trace.enable();
+    trace.record(0, 1, 2);
+    REQUIRE_EQ(trace.count(), 1);
+    CHECK_EQ(trace[0].reg_num, 1);
+    CHECK_EQ(trace[0].value, 2);
+}
+
+TEST_CASE("Trace should count writes beyond capacity.") {
+    RegisterWriteTrace trace;
+    trace.enable();
+    for (size_t i = 0; i < RegisterWriteTrace::capacity + 3; i++)
+        trace.record(0, 0, i);
+
+    CHECK_EQ(trace.count(), RegisterWriteTrace::capacity + 3);
+    CHECK_EQ(trace.size(), RegisterWriteTrace::capacity);
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("Tuning plans");
+
+TEST_CASE("Plan should match tuning config.") {
+    const rf::Frequency f = 433'920'000;
+    const auto config = tuning::config::create(f);
+    const auto plan = tuning::create_plan(f);
+
+    CHECK(plan.is_valid());
+    CHECK_EQ(plan.frequency, f);
+    CHECK_EQ(plan.first_lo_frequency, config.first_lo_frequency);
+    CHECK_EQ(plan.second_lo_frequency, config.second_lo_frequency);
+    CHECK(plan.rf_path_band == config.rf_path_band);
+    CHECK_EQ(plan.mixer_invert, config.mixer_invert);
+}
+
+TEST_CASE("PlanCache should hit on repeated frequencies.") {
+    tuning::PlanCache cache;
+
+    for (size_t pass = 0; pass < 3; pass++) {
+        for (rf::Frequency f = 446'006'250; f < 446'200'000; f += 12'500) {
+            const auto& plan = cache.get(f);
+            CHECK_EQ(plan.frequency, f);
+        }
+    }
+
+    CHECK_EQ(cache.misses(), 16);
+    CHECK_EQ(cache.hits(), 32);
+}
+
+TEST_CASE("PlanCache should not return plans for other frequencies.") {
+    tuning::PlanCache cache;
+    const rf::Frequency a = 100'000'000;
+    const rf::Frequency b = a + 1000 * tuning::PlanCache::entry_count * tuning::PlanCache::entry_count;
+
+    CHECK_EQ(cache.get(a).frequency, a);
+    CHECK_EQ(cache.get(b).frequency, b);
+    CHECK_EQ(cache.get(a).frequency, a);
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("Retune register traffic");
+
+SCENARIO("Retune should only program what changed.") {
+    RegisterWriteTrace trace;
+    trace.enable();
+    MockFirstIF first_if{trace};
+    MockSecondIF second_if{trace};
+    tuning::State state;
+
+    GIVEN("an unknown tuner state") {
+        const auto plan = tuning::create_plan(100'000'000);
+        REQUIRE(tuning::retune(plan, state, first_if, second_if));
+
+        THEN("everything should be programmed") {
+            CHECK_EQ(trace.count(first_if_device), 3);
+            CHECK_EQ(trace.count(second_if_device), 1);
+            CHECK(first_if.enabled);
+        }
+
+        WHEN("retuning to the same frequency") {
+            trace.clear();
+            REQUIRE(tuning::retune(plan, state, first_if, second_if));
+
+            THEN("nothing should be written") {
+                CHECK_EQ(trace.count(), 0);
+                CHECK_EQ(first_if.invalidations, 1);
+                CHECK_EQ(second_if.invalidations, 1);
+            }
+        }
+
+        WHEN("retuning within the low band") {
+            trace.clear();
+            REQUIRE(tuning::retune(tuning::create_plan(101'000'000), state, first_if, second_if));
+
+            THEN("both LOs should be reprogrammed once") {
+                CHECK_EQ(trace.count(first_if_device), 3);
+                CHECK_EQ(trace.count(second_if_device), 1);
+            }
+        }
+
+        WHEN("retuning to the mid band") {
+            trace.clear();
+            REQUIRE(tuning::retune(tuning::create_plan(2'400'000'000), state, first_if, second_if));
+
+            THEN("the first IF should only be disabled") {
+                CHECK_EQ(trace.count(first_if_device), 1);
+                CHECK_EQ(trace.count(second_if_device), 1);
+                CHECK_FALSE(first_if.enabled);
+            }
+
+            AND_WHEN("retuning within the mid band") {
+                trace.clear();
+                REQUIRE(tuning::retune(tuning::create_plan(2'450'000'000), state, first_if, second_if));
+
+                THEN("the first IF should not be touched") {
+                    CHECK_EQ(trace.count(first_if_device), 0);
+                    CHECK_EQ(trace.count(second_if_device), 1);
+                }
+            }
+        }
+
+        WHEN("the state is invalidated") {
+            state.invalidate();
+            trace.clear();
+            REQUIRE(tuning::retune(plan, state, first_if, second_if));
+
+            THEN("everything should be programmed again") {
+                CHECK_EQ(trace.count(first_if_device), 3);
+                CHECK_EQ(trace.count(second_if_device), 1);
+            }
+
+            THEN("the drivers should rewrite every register") {
+                CHECK_EQ(first_if.invalidations, 2);
+                CHECK_EQ(second_if.invalidations, 2);
+            }
+        }
+    }
+
+    GIVEN("an out of range frequency") {
+        const auto plan = tuning::create_plan(8'000'000'000);
+
+        THEN("retune should fail without writing anything") {
+            CHECK_FALSE(tuning::retune(plan, state, first_if, second_if));
+            CHECK_EQ(trace.count(), 0);
+        }
+    }
+}
+
+TEST_SUITE_END();
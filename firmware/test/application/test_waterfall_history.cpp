@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "waterfall_history.hpp"
+
+#include <vector>
+
+using Line = WaterfallHistory::Line;
+
+static Line make_line(const uint32_t seed, const bool noisy) {
+    Line line;
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < line.size(); i++) {
+        x = x * 1103515245u + 12345u;
+        line[i] = noisy ? (x >> 16) : ((i / 20 + seed) * 16);
+    }
+    return line;
+}
+
+static Line quantised(Line line) {
+    for (auto& bin : line)
+        bin &= WaterfallHistory::quantise_mask;
+    return line;
+}
+
+TEST_SUITE_BEGIN("Waterfall history");
+
+TEST_CASE("Packing should round trip and shrink runs.") {
+    for (const bool noisy : {false, true}) {
+        const auto line = make_line(7, noisy);
+        std::array<uint8_t, WaterfallHistory::max_packed_size> packed;
+        const auto size = WaterfallHistory::pack(line.data(), line.size(), packed.data());
+        CHECK(size <= WaterfallHistory::max_packed_size);
+        if (!noisy)
+            CHECK(size < 40);
+
+        Line out{};
+        REQUIRE(WaterfallHistory::unpack(packed.data(), size, out.data(), out.size()));
+        CHECK(out == line);
+    }
+}
+
+TEST_CASE("Unpacking should reject truncated or oversized data.") {
+    const auto line = make_line(3, false);
+    std::array<uint8_t, WaterfallHistory::max_packed_size> packed;
+    const auto size = WaterfallHistory::pack(line.data(), line.size(), packed.data());
+
+    Line out{};
+    CHECK_FALSE(WaterfallHistory::unpack(packed.data(), size - 1, out.data(), out.size()));
+    CHECK_FALSE(WaterfallHistory::unpack(packed.data(), size, out.data(), out.size() - 1));
+}
+
+TEST_CASE("Lines should be returned newest first, quantised.") {
+    WaterfallHistory history{4096};
+    for (uint32_t n = 0; n < 5; n++)
+        history.push(make_line(n, true));
+
+    REQUIRE_EQ(history.size(), 5);
+    Line line;
+    REQUIRE(history.get(0, line));
+    CHECK(line == quantised(make_line(4, true)));
+    REQUIRE(history.get(4, line));
+    CHECK(line == quantised(make_line(0, true)));
+    CHECK_FALSE(history.get(5, line));
+}
+
+TEST_CASE("Full history should evict the oldest lines in order.") {
+    WaterfallHistory history{2048};
+    std::vector<Line> evicted;
+    history.on_evict = [&evicted](const Line& line) { evicted.push_back(line); };
+
+    constexpr uint32_t pushed = 200;
+    for (uint32_t n = 0; n < pushed; n++)
+        history.push(make_line(n, n % 3 == 0));
+
+    /* Every line is either held or was evicted, oldest first. */
+    REQUIRE_EQ(evicted.size() + history.size(), pushed);
+    for (size_t n = 0; n < evicted.size(); n++)
+        CHECK(evicted[n] == quantised(make_line(n, n % 3 == 0)));
+
+    for (size_t age = 0; age < history.size(); age++) {
+        const uint32_t n = pushed - 1 - age;
+        Line line;
+        REQUIRE(history.get(age, line));
+        CHECK(line == quantised(make_line(n, n % 3 == 0)));
+    }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "wav_peaks.hpp"
+
+#include <vector>
+
+using namespace wav_peaks;
+
+TEST_SUITE_BEGIN("WAV peaks");
+
+TEST_CASE("Levels should be picked by samples per pixel.") {
+    CHECK_EQ(level_block(0), 256);
+    CHECK_EQ(level_block(1), 65536);
+    CHECK_EQ(level_for(1), -1);
+    CHECK_EQ(level_for(255), -1);
+    CHECK_EQ(level_for(256), 0);
+    CHECK_EQ(level_for(65535), 0);
+    CHECK_EQ(level_for(65536), 1);
+    CHECK_EQ(level_for(1000000), 1);
+}
+
+TEST_CASE("Peak should track min and max and merge.") {
+    Peak a;
+    CHECK(a.empty());
+    a.add(int16_t{-5});
+    a.add(int16_t{12});
+    CHECK_FALSE(a.empty());
+    CHECK_EQ(a.min, -5);
+    CHECK_EQ(a.max, 12);
+
+    Peak b;
+    b.add(int16_t{-300});
+    a.add(b);
+    CHECK_EQ(a.min, -300);
+    CHECK_EQ(a.max, 12);
+}
+
+TEST_CASE("Accumulator should emit one peak per block plus a partial one.") {
+    BlockAccumulator acc{4};
+    std::vector<Peak> peaks;
+    Peak out;
+    for (int16_t s = 0; s < 10; s++) {
+        if (acc.add(static_cast<int16_t>(s * (s % 2 ? -1 : 1)), out))
+            peaks.push_back(out);
+    }
+    if (acc.flush(out))
+        peaks.push_back(out);
+
+    REQUIRE_EQ(peaks.size(), 3);
+    CHECK_EQ(peaks[0].min, -3);
+    CHECK_EQ(peaks[0].max, 2);
+    CHECK_EQ(peaks[1].min, -7);
+    CHECK_EQ(peaks[1].max, 6);
+    CHECK_EQ(peaks[2].min, -9);
+    CHECK_EQ(peaks[2].max, 8);
+    CHECK_FALSE(acc.flush(out));
+}
+
+TEST_CASE("Accumulating peaks should equal accumulating their samples.") {
+    BlockAccumulator fine{3};
+    BlockAccumulator coarse{2};
+    BlockAccumulator direct{6};
+    Peak fine_out, coarse_out, direct_out;
+    bool have_coarse = false;
+
+    for (int16_t s = 0; s < 6; s++) {
+        const int16_t sample = (s * 37) % 11 - 5;
+        if (fine.add(sample, fine_out))
+            have_coarse = coarse.add(fine_out, coarse_out);
+        direct.add(sample, direct_out);
+    }
+    REQUIRE(have_coarse);
+    CHECK_EQ(coarse_out.min, direct_out.min);
+    CHECK_EQ(coarse_out.max, direct_out.max);
+}
+
+TEST_SUITE_END();
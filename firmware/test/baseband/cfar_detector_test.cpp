@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "cfar_detector.hpp"
+#include "doctest.h"
+
+namespace {
+
+constexpr uint8_t noise_level = 40;
+
+/* Sets a bin given in frequency order (0 = lowest frequency, 128 = DC). */
+void set_bin(ChannelSpectrum& spectrum, const size_t bin, const uint8_t value) {
+    spectrum.db[(bin + 128) % 256] = value;
+}
+
+ChannelSpectrum make_spectrum() {
+    ChannelSpectrum spectrum{};
+    for (size_t i = 0; i < spectrum.db.size(); i++)
+        spectrum.db[i] = noise_level + (i % 3);
+    return spectrum;
+}
+
+CFARDetector make_detector(const uint8_t threshold) {
+    CFARDetector detector;
+    detector.configure(SpectrumDetectorConfigMessage{threshold, 2, 8, 2, 6});
+    return detector;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("CFARDetector");
+
+TEST_CASE("Detector should be disabled until configured with a threshold.") {
+    CFARDetector detector;
+    CHECK_FALSE(detector.enabled());
+    CHECK(make_detector(10).enabled());
+}
+
+TEST_CASE("Noise alone should produce no detections.") {
+    auto detector = make_detector(10);
+    auto spectrum = make_spectrum();
+
+    detector.execute(spectrum);
+
+    CHECK_EQ(spectrum.detection_count, 0);
+    CHECK(spectrum.noise_floor >= noise_level);
+    CHECK(spectrum.noise_floor <= noise_level + 2);
+}
+
+TEST_CASE("Every emitter in the slice should be reported.") {
+    auto detector = make_detector(10);
+    auto spectrum = make_spectrum();
+    set_bin(spectrum, 30, 90);
+    set_bin(spectrum, 100, 70);
+    set_bin(spectrum, 200, 120);
+
+    detector.execute(spectrum);
+
+    REQUIRE_EQ(spectrum.detection_count, 3);
+    CHECK_EQ(spectrum.detections[0].bin, 30);
+    CHECK_EQ(spectrum.detections[0].power, 90);
+    CHECK_EQ(spectrum.detections[1].bin, 100);
+    CHECK_EQ(spectrum.detections[2].bin, 200);
+    CHECK_EQ(spectrum.detections[2].power, 120);
+    CHECK(spectrum.detections[2].snr >= 120 - noise_level - 2);
+}
+
+TEST_CASE("Adjacent bins should merge into one wide detection.") {
+    auto detector = make_detector(10);
+    auto spectrum = make_spectrum();
+    set_bin(spectrum, 60, 80);
+    set_bin(spectrum, 61, 95);
+    set_bin(spectrum, 62, 85);
+
+    detector.execute(spectrum);
+
+    REQUIRE_EQ(spectrum.detection_count, 1);
+    CHECK_EQ(spectrum.detections[0].bin, 61);
+    CHECK_EQ(spectrum.detections[0].width, 3);
+    CHECK_EQ(spectrum.detections[0].power, 95);
+}
+
+TEST_CASE("DC spike and edge bins should be ignored.") {
+    auto detector = make_detector(10);
+    auto spectrum = make_spectrum();
+    set_bin(spectrum, 128, 200);
+    set_bin(spectrum, 124, 200);
+    set_bin(spectrum, 0, 200);
+    set_bin(spectrum, 255, 200);
+
+    detector.execute(spectrum);
+
+    CHECK_EQ(spectrum.detection_count, 0);
+}
+
+TEST_CASE("Weakest detections should be dropped when the list is full.") {
+    auto detector = make_detector(10);
+    auto spectrum = make_spectrum();
+    // 20 emitters spaced out so their training cells don't overlap
+    for (size_t n = 0; n < 20; n++)
+        set_bin(spectrum, 4 + n * 6, 80 + n);
+
+    detector.execute(spectrum);
+
+    REQUIRE_EQ(spectrum.detection_count, spectrum.detections.size());
+    for (size_t n = 0; n < spectrum.detection_count; n++)
+        CHECK(spectrum.detections[n].power >= 84);
+}
+
+TEST_SUITE_END();
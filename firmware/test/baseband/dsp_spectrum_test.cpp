@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_spectrum.hpp"
+#include "doctest.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/* The float computation SpectrumCollector used to do per bin. */
+int reference_db(const float mag2) {
+    const float db = 10.0f * std::log10(mag2 / (32768.0f * 32768.0f));
+    return std::clamp(static_cast<int>(std::floor(db * 5.0f + 255.0f)), 0, 255);
+}
+
+}  // namespace
+
+TEST_CASE("mag2_to_db_8bit follows the dBV scale within a level") {
+    for (float mag2 = 1.0f; mag2 < 1.0e10f; mag2 *= 1.037f) {
+        const int db = dsp::spectrum::mag2_to_db_8bit(mag2);
+        CHECK(std::abs(db - reference_db(mag2)) <= 1);
+    }
+}
+
+TEST_CASE("mag2_to_db_8bit clamps to the byte range") {
+    CHECK(dsp::spectrum::mag2_to_db_8bit(0.0f) == 0);
+    CHECK(dsp::spectrum::mag2_to_db_8bit(1.0e-20f) == 0);
+    CHECK(dsp::spectrum::mag2_to_db_8bit(32768.0f * 32768.0f) == 255);
+    CHECK(dsp::spectrum::mag2_to_db_8bit(1.0e12f) == 255);
+}
+
+TEST_CASE("Windowed samples match the three point Hamming on the bins") {
+    constexpr size_t N = 256;
+    std::array<complex16_t, N> samples;
+    for (size_t i = 0; i < N; i++) {
+        // Two tones, one off bin centre, and some deterministic jitter.
+        const float phase_a = 2.0f * M_PI * 17.3f * i / N;
+        const float phase_b = 2.0f * M_PI * -61.0f * i / N;
+        const int16_t jitter = static_cast<int16_t>((i * 7919) % 97) - 48;
+        samples[i] = {
+            static_cast<int16_t>(12000 * std::cos(phase_a) + 3000 * std::cos(phase_b) + jitter),
+            static_cast<int16_t>(12000 * std::sin(phase_a) + 3000 * std::sin(phase_b) - jitter)};
+    }
+
+    std::array<std::complex<float>, N> plain;
+    std::array<std::complex<float>, N> windowed;
+    for (size_t k = 0; k < N; k++) {
+        plain[k] = 0;
+        windowed[k] = 0;
+        for (size_t i = 0; i < N; i++) {
+            const auto twiddle = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * ((i * k) % N) / N));
+            const auto w = dsp::spectrum::hamming_256(samples[i], i);
+            plain[k] += std::complex<float>(samples[i].real(), samples[i].imag()) * twiddle;
+            windowed[k] += std::complex<float>(w.real(), w.imag()) * twiddle;
+        }
+    }
+
+    float peak = 0;
+    for (const auto& bin : plain)
+        peak = std::max(peak, std::abs(bin));
+
+    for (size_t i = 0; i < N; i++) {
+        const auto expected = plain[i] * 0.54f - (plain[(i - 1) & (N - 1)] + plain[(i + 1) & (N - 1)]) * 0.23f;
+        CHECK(std::abs(windowed[i] - expected) < peak * 1.0e-3f + 256.0f);
+    }
+}
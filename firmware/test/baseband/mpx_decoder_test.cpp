@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "mpx_decoder.hpp"
+#include "doctest.h"
+#include "noise.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace mpx;
+
+namespace {
+
+constexpr float fs = MPXDecoder::sample_rate;
+constexpr size_t block_size = 128;
+constexpr double two_pi = 6.283185307179586;
+
+/* Four 0A-like groups spelling a programme service name. */
+std::array<std::array<uint16_t, 4>, 4> test_groups() {
+    const char name[] = "PORTAPCK";
+    std::array<std::array<uint16_t, 4>, 4> groups{};
+    for (size_t segment = 0; segment < 4; segment++) {
+        groups[segment] = {
+            0xc201,
+            uint16_t(0x0408 | segment),
+            0xe0cd,
+            uint16_t((name[segment * 2] << 8) | name[segment * 2 + 1])};
+    }
+    return groups;
+}
+
+/* Differentially encoded biphase chips for the groups, repeated. */
+std::vector<int8_t> rds_chips(const size_t repeats) {
+    constexpr std::array<uint32_t, 4> offsets{RDSOffset::A, RDSOffset::B, RDSOffset::C, RDSOffset::D};
+    const auto groups = test_groups();
+
+    std::vector<int8_t> chips;
+    bool encoded = false;
+    for (size_t r = 0; r < repeats; r++) {
+        for (const auto& group : groups) {
+            for (size_t b = 0; b < 4; b++) {
+                const auto block = rds_encode(group[b], offsets[b]);
+                for (int bit = 25; bit >= 0; bit--) {
+                    encoded ^= (block >> bit) & 1;
+                    chips.push_back(encoded ? 1 : -1);
+                    chips.push_back(encoded ? -1 : 1);
+                }
+            }
+        }
+    }
+    return chips;
+}
+
+struct Multiplex {
+    float left_hz{1000.0f};
+    float left{0.4f};
+    float right{0.0f};
+    float pilot{0.09f};
+    float rds{0.04f};
+    float noise{0.02f};
+    double pilot_phase{0.7};
+    double rds_phase{0.0};
+    std::vector<int8_t> chips{rds_chips(8)};
+    Noise random{};
+
+    /* Normalised multiplex at sample n, mono and L-R at 90% of deviation.
+     * The pilot and the subcarriers are sines, as broadcast. */
+    float operator()(const size_t n) {
+        const double t = n / double(fs);
+        const float l = left * std::sin(two_pi * left_hz * t);
+        const float r = right * std::sin(two_pi * 400.0 * t);
+        const double theta = two_pi * pilot_hz * t + pilot_phase;
+        const int8_t chip = chips[size_t(t * rds_chip_rate) % chips.size()];
+        return 0.45f * (l + r) + 0.45f * (l - r) * std::sin(2 * theta) + pilot * std::sin(theta) + rds * chip * std::sin(3 * theta + rds_phase) + random(noise);
+    }
+};
+
+struct Run {
+    std::vector<int16_t> side{};
+    std::vector<RDSGroupMessage> groups{};
+    bool stereo{false};
+};
+
+template <typename Signal>
+Run run(MPXDecoder& decoder, const float seconds, Signal& signal) {
+    Run result;
+    std::array<int16_t, block_size> mpx;
+    std::array<int16_t, block_size> side;
+    const size_t blocks = seconds * fs / block_size;
+    for (size_t b = 0; b < blocks; b++) {
+        for (size_t i = 0; i < block_size; i++)
+            mpx[i] = std::clamp(signal(b * block_size + i) * 32768.0f, -32768.0f, 32767.0f);
+
+        if (decoder.execute({mpx.data(), mpx.size(), MPXDecoder::sample_rate}, {side.data(), side.size(), MPXDecoder::sample_rate}))
+            result.groups.push_back(decoder.group());
+        result.side.insert(result.side.end(), side.begin(), side.end());
+    }
+    result.stereo = decoder.stereo();
+    return result;
+}
+
+/* Amplitude of a tone in the last samples of a signal, normalised. */
+float tone_amplitude(const std::vector<int16_t>& signal, const float hz, const size_t samples) {
+    double i = 0, q = 0;
+    for (size_t n = signal.size() - samples; n < signal.size(); n++) {
+        i += signal[n] * std::cos(two_pi * hz * n / fs);
+        q += signal[n] * std::sin(two_pi * hz * n / fs);
+    }
+    return 2 * std::sqrt(i * i + q * q) / samples / 32768.0;
+}
+
+/* Amplitude of the part of a tone in phase with sin(2 pi hz t), signed. */
+float tone_in_phase(const std::vector<int16_t>& signal, const float hz, const size_t samples) {
+    double q = 0;
+    for (size_t n = signal.size() - samples; n < signal.size(); n++)
+        q += signal[n] * std::sin(two_pi * hz * n / fs);
+    return 2 * q / samples / 32768.0;
+}
+
+size_t good_groups(const Run& run) {
+    const auto groups = test_groups();
+    size_t good = 0;
+    for (const auto& message : run.groups) {
+        if (message.valid != 0xf)
+            continue;
+        for (const auto& group : groups) {
+            if (message.blocks == group)
+                good++;
+        }
+    }
+    return good;
+}
+
+/* Blocks marked valid that don't match what was sent. */
+size_t wrong_blocks(const Run& run) {
+    const auto groups = test_groups();
+    size_t wrong = 0;
+    for (const auto& message : run.groups) {
+        const auto& sent = groups[message.blocks[1] & 3];
+        for (size_t b = 0; b < 4; b++) {
+            if ((message.valid & (1 << b)) && message.blocks[b] != sent[b])
+                wrong++;
+        }
+    }
+    return wrong;
+}
+
+} /* namespace */
+
+TEST_SUITE_BEGIN("RDS blocks");
+
+TEST_CASE("The syndrome of an encoded block should be its offset word.") {
+    for (const auto offset : {RDSOffset::A, RDSOffset::B, RDSOffset::C, RDSOffset::Cprime, RDSOffset::D}) {
+        for (uint32_t data : {0x0000u, 0xc201u, 0x1234u, 0xffffu})
+            CHECK(rds_syndrome(rds_encode(data, offset)) == offset);
+    }
+}
+
+TEST_CASE("Groups should be found in a bit stream starting mid block.") {
+    RDSGroupSync sync;
+    sync.reset();
+    const auto chips = rds_chips(3);
+
+    std::vector<RDSGroupMessage> groups;
+    bool previous = false;
+    for (size_t n = 37 * 2; n < chips.size(); n += 2) {
+        const bool encoded = chips[n] > 0;
+        if (sync.feed(encoded != previous))
+            groups.push_back(sync.group());
+        previous = encoded;
+    }
+
+    REQUIRE(groups.size() >= 10);
+    for (const auto& group : groups)
+        CHECK(group.valid == 0xf);
+    CHECK(groups.back().blocks == test_groups()[3]);
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("MPXDecoder");
+
+TEST_CASE("The pilot should switch stereo on, and its absence keep it off.") {
+    MPXDecoder with_pilot;
+    Multiplex stereo;
+    CHECK(run(with_pilot, 0.5f, stereo).stereo);
+
+    MPXDecoder without_pilot;
+    Multiplex mono;
+    mono.pilot = 0;
+    mono.rds = 0;
+    CHECK_FALSE(run(without_pilot, 0.5f, mono).stereo);
+}
+
+TEST_CASE("L-R should be recovered at the scale of the mono signal.") {
+    MPXDecoder decoder;
+    Multiplex signal;
+    const auto result = run(decoder, 1.0f, signal);
+    REQUIRE(result.stereo);
+
+    // L-R is 0.45 * left, boosted for the CIC droop the test signal lacks.
+    const float expected = 0.45f * signal.left * MPXDecoder::side_gain / 2.0f;
+    CHECK(tone_amplitude(result.side, signal.left_hz, fs / 2) == doctest::Approx(expected).epsilon(0.05));
+    // L-R, not R-L.
+    CHECK(tone_in_phase(result.side, signal.left_hz, fs / 2) > expected * 0.95f);
+    CHECK(tone_amplitude(result.side, 400.0f, fs / 2) < expected * 0.02f);
+}
+
+TEST_CASE("RDS groups should be decoded with the subcarrier in phase or in quadrature.") {
+    for (const double rds_phase : {0.0, two_pi / 4}) {
+        MPXDecoder decoder;
+        Multiplex signal;
+        signal.rds_phase = rds_phase;
+        const auto result = run(decoder, 3.0f, signal);
+        CHECK(good_groups(result) >= 25);
+        CHECK(wrong_blocks(result) == 0);
+    }
+}
+
+TEST_CASE("RDS should be decoded from a mono station without a pilot.") {
+    MPXDecoder decoder;
+    Multiplex signal;
+    signal.pilot = 0;
+    const auto result = run(decoder, 3.0f, signal);
+    CHECK(good_groups(result) >= 25);
+}
+
+/* Reports the decoding cost only, wall-clock time is too noisy to assert
+ * on. MPX_FILE names a recording of the multiplex as raw 16-bit little
+ * endian samples at MPXDecoder::sample_rate; without one a synthesized
+ * multiplex is timed. Run with: baseband_test -tc="Benchmark*" --no-skip */
+TEST_CASE("Benchmark decoding a multiplex." * doctest::skip()) {
+    std::vector<int16_t> mpx;
+    const char* const path = std::getenv("MPX_FILE");
+    if (path) {
+        FILE* const file = std::fopen(path, "rb");
+        REQUIRE(file != nullptr);
+        int16_t sample;
+        while (std::fread(&sample, sizeof(sample), 1, file) == 1)
+            mpx.push_back(sample);
+        std::fclose(file);
+    } else {
+        Multiplex signal;
+        mpx.resize(4 * size_t(fs));
+        for (size_t n = 0; n < mpx.size(); n++)
+            mpx[n] = std::clamp(signal(n) * 32768.0f, -32768.0f, 32767.0f);
+    }
+
+    const size_t blocks = mpx.size() / block_size;
+    REQUIRE(blocks > 0);
+
+    MPXDecoder decoder;
+    std::array<int16_t, block_size> side;
+    size_t groups = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < blocks; b++)
+        groups += decoder.execute({&mpx[b * block_size], block_size, MPXDecoder::sample_rate}, {side.data(), side.size(), MPXDecoder::sample_rate});
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double seconds = blocks * block_size / double(fs);
+    const std::string source = path ? path : "synthesized";
+    MESSAGE(source, ": ", elapsed.count() * 1e6 / blocks, " us per ", block_size,
+            " sample block, ", seconds / elapsed.count(), "x real time, ", groups, " groups");
+}
+
+TEST_SUITE_END();
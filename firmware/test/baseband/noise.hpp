@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TEST_NOISE_H__
+#define __TEST_NOISE_H__
+
+#include <cstdint>
+
+/* Repeatable white noise for the detector and decoder tests. */
+struct Noise {
+    uint32_t state{0x1234567};
+
+    /* Roughly uniform in [-amplitude, amplitude]. */
+    float operator()(const float amplitude) {
+        state = state * 1664525 + 1013904223;
+        return amplitude * ((int32_t)state / 2147483648.0f);
+    }
+};
+
+#endif /*__TEST_NOISE_H__*/
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "retune_settle_detector.hpp"
+#include "dsp_types.hpp"
+#include "doctest.h"
+
+#include <array>
+
+namespace {
+
+constexpr uint32_t sampling_rate = 48000;  // 48 samples per ms
+constexpr size_t block_size = 16;
+
+std::array<complex16_t, block_size> make_block(const int16_t level) {
+    std::array<complex16_t, block_size> block;
+    for (size_t i = 0; i < block_size; i++)
+        block[i] = {static_cast<int16_t>((i & 1) ? level : -level), 0};
+    return block;
+}
+
+bool feed(RetuneSettleDetector& detector, std::array<complex16_t, block_size>& block, const uint32_t epoch) {
+    const buffer_c16_t buffer{block.data(), block.size(), sampling_rate};
+    return detector.feed(buffer, epoch);
+}
+
+}  // namespace
+
+TEST_CASE("settle detector waits for the guard time") {
+    RetuneSettleDetector detector;
+    auto block = make_block(1000);
+
+    // 1ms guard = 48 samples = 3 blocks.
+    CHECK_FALSE(feed(detector, block, 1));
+    CHECK_FALSE(feed(detector, block, 1));
+    CHECK(feed(detector, block, 1));
+    CHECK(detector.settled());
+    CHECK(detector.epoch() == 1);
+}
+
+TEST_CASE("settle detector restarts on a new epoch") {
+    RetuneSettleDetector detector;
+    auto block = make_block(1000);
+
+    for (size_t i = 0; i < 4; i++) feed(detector, block, 1);
+    REQUIRE(detector.settled());
+
+    CHECK_FALSE(feed(detector, block, 2));
+    CHECK_FALSE(detector.settled());
+    CHECK(detector.epoch() == 2);
+}
+
+TEST_CASE("settle detector waits for stable power") {
+    RetuneSettleDetector detector;
+    auto low = make_block(100);
+    auto high = make_block(1000);
+
+    // Power keeps changing after the guard time.
+    CHECK_FALSE(feed(detector, low, 1));
+    CHECK_FALSE(feed(detector, high, 1));
+    CHECK_FALSE(feed(detector, low, 1));
+    CHECK_FALSE(feed(detector, high, 1));
+
+    // Two consecutive blocks agree.
+    CHECK(feed(detector, high, 1));
+}
+
+TEST_CASE("settle detector gives up waiting after the maximum settle time") {
+    RetuneSettleDetector detector;
+    auto low = make_block(100);
+    auto high = make_block(1000);
+
+    bool settled = false;
+    size_t blocks = 0;
+    while (!settled && blocks < 100) {
+        settled = feed(detector, (blocks & 1) ? high : low, 1);
+        blocks++;
+    }
+
+    CHECK(settled);
+    CHECK(blocks * block_size >= sampling_rate / 200);
+}
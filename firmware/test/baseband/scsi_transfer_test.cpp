@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Host harness for the SD-over-USB data phases. The SD card and USB
+ * endpoint are simulated with a virtual clock: SD commands block the
+ * CPU, USB transfers run in the background until usb_bulk_wait(). */
+
+#include "sd_over_usb/scsi_transfer.h"
+#include "doctest.h"
+
+extern "C" {
+#include "sd_over_usb/diskio.h"
+}
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Rough timings of a class 10 card on the SDIO bus and USB 2.0 HS bulk, in us.
+constexpr double sd_command_us = 250.0;
+constexpr double sd_block_us = 25.0;
+constexpr double usb_transfer_us = 60.0;
+constexpr double usb_block_us = 13.0;
+
+constexpr uint32_t disk_blocks = 4096;
+constexpr uint32_t half_blocks = 32;
+
+struct Simulation {
+    std::vector<uint8_t> disk = std::vector<uint8_t>(disk_blocks * SCSI_BLOCK_SIZE);
+    std::vector<uint8_t> host{};  // Bytes the host sent or received.
+    size_t host_offset{0};
+
+    double now{0};
+    double usb_done{0};
+    bool usb_pending{false};
+    bool usb_in{false};
+    uint8_t* usb_data{nullptr};
+    uint32_t usb_length{0};
+
+    uint32_t sd_commands{0};
+    bool fail_sd{false};
+
+    void schedule(bool in, void* data, uint32_t length) {
+        REQUIRE_FALSE(usb_pending);
+        usb_pending = true;
+        usb_in = in;
+        usb_data = static_cast<uint8_t*>(data);
+        usb_length = length;
+        usb_done = now + usb_transfer_us + usb_block_us * length / SCSI_BLOCK_SIZE;
+    }
+
+    void wait() {
+        REQUIRE(usb_pending);
+        now = std::max(now, usb_done);
+
+        // The DMA touches the buffer until the transfer is done, so
+        // copy at completion to catch early buffer reuse.
+        if (usb_in) {
+            host.insert(host.end(), usb_data, usb_data + usb_length);
+        } else {
+            memcpy(usb_data, &host[host_offset], usb_length);
+            host_offset += usb_length;
+        }
+        usb_pending = false;
+    }
+
+    bool sd_access(uint32_t lba, uint32_t n) {
+        REQUIRE(lba + n <= disk_blocks);
+        now += sd_command_us + sd_block_us * n;
+        sd_commands++;
+        return fail_sd;
+    }
+
+    double megabytes_per_second(size_t bytes) const {
+        return bytes / now;
+    }
+};
+
+Simulation* sim = nullptr;
+
+void fill_pattern(std::vector<uint8_t>& data, uint32_t seed) {
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<uint8_t>((i * 31 + seed + (i >> 9)) & 0xff);
+}
+
+}  // namespace
+
+extern "C" {
+void usb_send_bulk_async(void* const data, const uint32_t length) {
+    sim->schedule(true, data, length);
+}
+
+void usb_receive_bulk_async(void* const data, const uint32_t length) {
+    sim->schedule(false, data, length);
+}
+
+void usb_bulk_wait(void) {
+    sim->wait();
+}
+
+bool_t read_block(uint32_t startblk, uint8_t* buf, uint32_t n) {
+    auto failed = sim->sd_access(startblk, n);
+    memcpy(buf, &sim->disk[startblk * SCSI_BLOCK_SIZE], n * SCSI_BLOCK_SIZE);
+    return failed;
+}
+
+bool_t write_block(uint32_t startblk, uint8_t* buf, uint32_t n) {
+    auto failed = sim->sd_access(startblk, n);
+    memcpy(&sim->disk[startblk * SCSI_BLOCK_SIZE], buf, n * SCSI_BLOCK_SIZE);
+    return failed;
+}
+}
+
+TEST_SUITE_BEGIN("SCSI transfers");
+
+TEST_CASE("READ(10) should return the requested blocks.") {
+    Simulation s;
+    sim = &s;
+    fill_pattern(s.disk, 7);
+    std::vector<uint8_t> buffer(half_blocks * 2 * SCSI_BLOCK_SIZE);
+
+    for (uint32_t count : {1u, 31u, 32u, 33u, 64u, 100u, 128u}) {
+        s.host.clear();
+        REQUIRE(scsi_transfer_read(17, count, buffer.data(), half_blocks));
+        REQUIRE_EQ(s.host.size(), count * SCSI_BLOCK_SIZE);
+        CHECK(memcmp(s.host.data(), &s.disk[17 * SCSI_BLOCK_SIZE], s.host.size()) == 0);
+    }
+}
+
+TEST_CASE("WRITE(10) should store the received blocks.") {
+    Simulation s;
+    sim = &s;
+    std::vector<uint8_t> buffer(half_blocks * 2 * SCSI_BLOCK_SIZE);
+
+    for (uint32_t count : {1u, 32u, 33u, 100u}) {
+        s.host.resize(count * SCSI_BLOCK_SIZE);
+        fill_pattern(s.host, count);
+        s.host_offset = 0;
+
+        REQUIRE(scsi_transfer_write(1000, count, buffer.data(), half_blocks));
+        CHECK_EQ(s.host_offset, s.host.size());
+        CHECK(memcmp(s.host.data(), &s.disk[1000 * SCSI_BLOCK_SIZE], s.host.size()) == 0);
+    }
+}
+
+TEST_CASE("Transfers should use one SD command per half buffer.") {
+    Simulation s;
+    sim = &s;
+    std::vector<uint8_t> buffer(half_blocks * 2 * SCSI_BLOCK_SIZE);
+
+    scsi_transfer_read(0, 128, buffer.data(), half_blocks);
+    CHECK_EQ(s.sd_commands, 4);
+}
+
+TEST_CASE("SD errors should fail the command but complete the data phase.") {
+    Simulation s;
+    sim = &s;
+    s.fail_sd = true;
+    std::vector<uint8_t> buffer(half_blocks * 2 * SCSI_BLOCK_SIZE);
+
+    CHECK_FALSE(scsi_transfer_read(0, 40, buffer.data(), half_blocks));
+    CHECK_EQ(s.host.size(), 40 * SCSI_BLOCK_SIZE);
+}
+
+TEST_CASE("Double buffering should be faster than block at a time.") {
+    constexpr uint32_t count = 1024;  // 512 KiB, a typical host read.
+    std::vector<uint8_t> buffer(half_blocks * 2 * SCSI_BLOCK_SIZE);
+
+    Simulation single;
+    sim = &single;
+    // One block per command and transfer, like the original implementation.
+    for (uint32_t i = 0; i < count; i++) {
+        scsi_transfer_read(i, 1, buffer.data(), 1);
+    }
+
+    Simulation pipelined;
+    sim = &pipelined;
+    scsi_transfer_read(0, count, buffer.data(), half_blocks);
+
+    const auto bytes = count * SCSI_BLOCK_SIZE;
+    CHECK(pipelined.megabytes_per_second(bytes) > 5 * single.megabytes_per_second(bytes));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "subtone_detector.hpp"
+#include "doctest.h"
+#include "noise.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace subtone;
+
+namespace {
+
+constexpr float fs = SubToneDetector::sample_rate;
+constexpr float two_pi = 6.28318530718f;
+
+struct Run {
+    std::vector<CodedSquelchMessage> reports{};
+    std::vector<size_t> at{};
+};
+
+/* Feeds seconds of signal, recording every reported change. */
+template <typename Signal>
+void feed(SubToneDetector& detector, Run& run, size_t& n, const float seconds, Signal signal) {
+    const size_t end = n + seconds * fs;
+    for (; n < end; n++) {
+        if (detector.execute(signal(n))) {
+            run.reports.push_back(detector.report());
+            run.at.push_back(n);
+        }
+    }
+}
+
+/* NRZ waveform of a repeating DCS word, LSB first. */
+float dcs_signal(const uint32_t word, const size_t n, const float amplitude) {
+    const size_t bit = size_t(n * dcs_bit_rate / fs) % 23;
+    return ((word >> bit) & 1) ? amplitude : -amplitude;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("DCS code words");
+
+TEST_CASE("Encoding should match the known word for 023.") {
+    CHECK_EQ(dcs_encode(023), 0x763813);
+}
+
+TEST_CASE("Every rotation of a code word should be a code word.") {
+    for (const auto code : dcs_codes) {
+        uint32_t w = dcs_encode(code);
+        for (size_t n = 0; n < 23; n++) {
+            CHECK_EQ(dcs_syndrome(w), 0);
+            w = ((w >> 1) | (w << 22)) & dcs_word_mask;
+        }
+    }
+}
+
+TEST_CASE("Any rotation should name the same code.") {
+    uint32_t w = dcs_encode(0244);
+    for (size_t n = 0; n < 23; n++) {
+        CHECK_EQ(DCSDetector::match(w), 0244);
+        w = ((w >> 1) | (w << 22)) & dcs_word_mask;
+    }
+    CHECK_EQ(DCSDetector::match(dcs_encode(0244) ^ 0x10), -1);
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("SubToneDetector");
+
+TEST_CASE("Noise alone should report nothing.") {
+    SubToneDetector detector;
+    Run run;
+    Noise noise;
+    size_t n = 0;
+    feed(detector, run, n, 10.0f, [&](size_t) { return noise(0.3f); });
+    CHECK(run.reports.empty());
+}
+
+TEST_CASE("A CTCSS tone should be reported once, then its loss.") {
+    SubToneDetector detector;
+    Run run;
+    Noise noise;
+    size_t n = 0;
+    feed(detector, run, n, 3.0f, [&](size_t i) { return 0.1f * std::sin(two_pi * 100.0f * i / fs) + noise(0.05f) + 0.2f; });
+    feed(detector, run, n, 3.0f, [&](size_t) { return noise(0.05f); });
+
+    REQUIRE_EQ(run.reports.size(), 2);
+    CHECK(run.reports[0].type == CodedSquelchMessage::Type::CTCSS);
+    CHECK_EQ(run.reports[0].value, 10000);
+    CHECK_LT(run.at[0], 1.5f * fs);
+    CHECK(run.reports[1].type == CodedSquelchMessage::Type::None);
+    CHECK_LT(run.at[1], (3.0f + 1.5f) * fs);
+}
+
+TEST_CASE("Adjacent CTCSS tones should be told apart.") {
+    for (const float tone : {67.0f, 69.3f, 159.8f, 162.2f, 250.3f, 254.1f}) {
+        SubToneDetector detector;
+        Run run;
+        Noise noise;
+        size_t n = 0;
+        // Slightly off frequency, as from a cheap encoder.
+        const float f = tone * 1.002f;
+        feed(detector, run, n, 2.0f, [&](size_t i) { return 0.1f * std::sin(two_pi * f * i / fs) + noise(0.05f); });
+
+        REQUIRE_EQ(run.reports.size(), 1);
+        CHECK_EQ(run.reports[0].value, uint32_t(tone * 100 + 0.5f));
+    }
+}
+
+TEST_CASE("A DCS code should be reported regardless of the starting bit.") {
+    for (const size_t offset : {0u, 37u, 150u}) {
+        SubToneDetector detector;
+        Run run;
+        Noise noise;
+        size_t n = 0;
+        const auto word = dcs_encode(0023);
+        feed(detector, run, n, 2.0f, [&](size_t i) { return dcs_signal(word, i + offset, 0.1f) + noise(0.03f) - 0.1f; });
+
+        REQUIRE_EQ(run.reports.size(), 1);
+        CHECK(run.reports[0].type == CodedSquelchMessage::Type::DCS);
+        CHECK_EQ(run.reports[0].value, 0023);
+    }
+}
+
+TEST_CASE("An inverted DCS code should be reported as its equivalent.") {
+    SubToneDetector detector;
+    Run run;
+    size_t n = 0;
+    const auto word = dcs_encode(0023);
+    feed(detector, run, n, 2.0f, [&](size_t i) { return -dcs_signal(word, i, 0.1f); });
+
+    REQUIRE_EQ(run.reports.size(), 1);
+    CHECK_EQ(run.reports[0].value, 0047);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "tv_line_sync.hpp"
+#include "doctest.h"
+
+#include <vector>
+
+namespace {
+
+constexpr int8_t sync_level = 120;
+constexpr int8_t black_level = 90;
+constexpr int8_t white_level = 12;
+constexpr size_t line_length = 128;
+constexpr size_t field_length = 312;
+
+/* A field of negative modulated video at 2 MHz: broad pulses on the first
+ * lines, then lines with a white bar over the middle third of the picture. */
+void append_field(std::vector<complex8_t>& signal, uint32_t& noise) {
+    for (size_t line = 0; line < field_length; line++) {
+        for (size_t i = 0; i < line_length; i++) {
+            int8_t level = black_level;
+            if (line < 3) {
+                // Two broad pulses per line.
+                if ((i % (line_length / 2)) < 54)
+                    level = sync_level;
+            } else if (i < 9) {
+                level = sync_level;
+            } else if ((i >= 21 + 35) && (i < 21 + 69)) {
+                level = white_level;
+            }
+            noise = noise * 1664525 + 1013904223;
+            const int8_t jitter = static_cast<int8_t>((noise >> 24) % 7) - 3;
+            signal.push_back({static_cast<int8_t>(level + jitter), jitter});
+        }
+    }
+}
+
+struct Received {
+    size_t rows{0};
+    size_t last_row{0};
+    bool in_order{true};
+    TvLineSync::Line line{};
+};
+
+Received run(TvLineSync& sync, const std::vector<complex8_t>& signal) {
+    Received received;
+    for (size_t offset = 0; offset + 2048 <= signal.size(); offset += 2048) {
+        const buffer_c8_t buffer{const_cast<complex8_t*>(&signal[offset]), 2048, TvLineSync::sampling_rate};
+        sync.feed(buffer, [&](const size_t row) {
+            if ((received.rows > 0) && (row != 0) && (row != received.last_row + 1))
+                received.in_order = false;
+            received.rows++;
+            received.last_row = row;
+            if (row == TvLineSync::rows / 2)
+                sync.render(received.line);
+        });
+    }
+    return received;
+}
+
+}  // namespace
+
+TEST_CASE("TvLineSync locks to lines and fields from an arbitrary start") {
+    std::vector<complex8_t> signal(53, complex8_t{black_level, 0});
+    uint32_t noise = 1;
+    for (size_t field = 0; field < 8; field++)
+        append_field(signal, noise);
+
+    TvLineSync sync;
+    const auto received = run(sync, signal);
+
+    CHECK(sync.line_locked());
+    CHECK(sync.field_locked());
+    CHECK(received.rows > TvLineSync::rows * 4);
+
+    // Settled fields deliver their rows top to bottom.
+    std::vector<complex8_t> more;
+    append_field(more, noise);
+    append_field(more, noise);
+    const auto settled = run(sync, more);
+    CHECK(settled.in_order);
+    CHECK(settled.rows >= TvLineSync::rows);
+}
+
+TEST_CASE("TvLineSync renders the picture line locked") {
+    std::vector<complex8_t> signal(91, complex8_t{black_level, 0});
+    uint32_t noise = 7;
+    for (size_t field = 0; field < 10; field++)
+        append_field(signal, noise);
+
+    TvLineSync sync;
+    const auto received = run(sync, signal);
+    REQUIRE(sync.line_locked());
+
+    // The bar covers the middle third of the 240 pixels.
+    const auto& line = received.line;
+    for (size_t x = 0; x < TvLineSync::width; x++) {
+        if ((x < 75) || (x >= 165)) {
+            CHECK(line[x] < 40);
+        } else if ((x >= 86) && (x < 154)) {
+            CHECK(line[x] > 200);
+        }
+    }
+}